@@ -9,10 +9,14 @@
 // Arguments:
 // - cchRowWidth - the length of the default text attribute
 // - attr - the default text attribute
+// - table - the attribute table of the buffer this row belongs to
 // Return Value:
 // - constructed object
-ATTR_ROW::ATTR_ROW(const uint16_t width, const TextAttribute attr) :
-    _data(width, attr) {}
+ATTR_ROW::ATTR_ROW(const uint16_t width, const TextAttribute attr, TextAttributeTable& table) :
+    _data(width, table.Intern(attr)),
+    _table{ &table }
+{
+}
 
 // Routine Description:
 // - Sets all properties of the ATTR_ROW to default values
@@ -20,7 +24,7 @@ ATTR_ROW::ATTR_ROW(const uint16_t width, const TextAttribute attr) :
 // - attr - The default text attributes to use on text in this row.
 void ATTR_ROW::Reset(const TextAttribute attr)
 {
-    _data.replace(0, _data.size(), attr);
+    _data.replace(0, _data.size(), _table->Intern(attr));
 }
 
 // Routine Description:
@@ -46,6 +50,20 @@ void ATTR_ROW::Resize(const uint16_t newWidth)
 // Note:
 // - will throw on error
 TextAttribute ATTR_ROW::GetAttrByColumn(const uint16_t column) const
+{
+    return _table->Get(_data.at(column));
+}
+
+// Routine Description:
+// - returns the attribute table ID of the attribute at the specified column.
+//   Two columns have the same attribute exactly if they have the same ID.
+// Arguments:
+// - column - the column to get the attribute ID for
+// Return Value:
+// - the attribute ID at column
+// Note:
+// - will throw on error
+TextAttributeId ATTR_ROW::GetAttrIdByColumn(const uint16_t column) const
 {
     return _data.at(column);
 }
@@ -59,9 +77,10 @@ std::vector<uint16_t> ATTR_ROW::GetHyperlinks() const
     std::vector<uint16_t> ids;
     for (const auto& run : _data.runs())
     {
-        if (run.value.IsHyperlink())
+        const auto& attr = _table->Get(run.value);
+        if (attr.IsHyperlink())
         {
-            ids.emplace_back(run.value.GetHyperlinkId());
+            ids.emplace_back(attr.GetHyperlinkId());
         }
     }
     return ids;
@@ -76,7 +95,7 @@ std::vector<uint16_t> ATTR_ROW::GetHyperlinks() const
 // - <none>
 bool ATTR_ROW::SetAttrToEnd(const uint16_t beginIndex, const TextAttribute attr)
 {
-    _data.replace(gsl::narrow<uint16_t>(beginIndex), _data.size(), attr);
+    _data.replace(gsl::narrow<uint16_t>(beginIndex), _data.size(), _table->Intern(attr));
     return true;
 }
 
@@ -90,7 +109,12 @@ bool ATTR_ROW::SetAttrToEnd(const uint16_t beginIndex, const TextAttribute attr)
 // - <none>
 void ATTR_ROW::ReplaceAttrs(const TextAttribute& toBeReplacedAttr, const TextAttribute& replaceWith)
 {
-    _data.replace_values(toBeReplacedAttr, replaceWith);
+    // Intern the replacement first: if that compacts the table, the IDs change underneath us.
+    const auto replaceWithId = _table->Intern(replaceWith);
+    if (const auto toBeReplacedId = _table->Find(toBeReplacedAttr))
+    {
+        _data.replace_values(*toBeReplacedId, replaceWithId);
+    }
 }
 
 // Routine Description:
@@ -105,30 +129,65 @@ void ATTR_ROW::ReplaceAttrs(const TextAttribute& toBeReplacedAttr, const TextAtt
 // - <none>
 void ATTR_ROW::Replace(const uint16_t beginIndex, const uint16_t endIndex, const TextAttribute& newAttr)
 {
-    _data.replace(beginIndex, endIndex, newAttr);
+    _data.replace(beginIndex, endIndex, _table->Intern(newAttr));
+}
+
+// Routine Description:
+// - Flags every attribute ID referenced by this row in the given set.
+//   Used by the owning buffer to find out which IDs are still alive when compacting the table.
+// Arguments:
+// - used - one flag per ID in the attribute table.
+void ATTR_ROW::MarkUsedIds(std::vector<bool>& used) const
+{
+    for (const auto& run : _data.runs())
+    {
+        used.at(run.value) = true;
+    }
+}
+
+// Routine Description:
+// - Rewrites the IDs stored in this row after the attribute table was compacted.
+// Arguments:
+// - remap - map from old to new attribute IDs, as returned by TextAttributeTable::Compact.
+void ATTR_ROW::RemapIds(const std::vector<TextAttributeId>& remap)
+{
+    // The remap is injective for all used IDs, so no two adjacent runs can end up being merged.
+    rle_vector::container runs;
+    runs.reserve(_data.runs().size());
+    for (const auto& run : _data.runs())
+    {
+        runs.emplace_back(remap.at(run.value), run.length);
+    }
+    _data = rle_vector{ std::move(runs) };
 }
 
 ATTR_ROW::const_iterator ATTR_ROW::begin() const noexcept
 {
-    return _data.begin();
+    return { _data.begin(), _table };
 }
 
 ATTR_ROW::const_iterator ATTR_ROW::end() const noexcept
 {
-    return _data.end();
+    return { _data.end(), _table };
 }
 
 ATTR_ROW::const_iterator ATTR_ROW::cbegin() const noexcept
 {
-    return _data.cbegin();
+    return { _data.cbegin(), _table };
 }
 
 ATTR_ROW::const_iterator ATTR_ROW::cend() const noexcept
 {
-    return _data.cend();
+    return { _data.cend(), _table };
 }
 
 bool operator==(const ATTR_ROW& a, const ATTR_ROW& b) noexcept
 {
-    return a._data == b._data;
+    // IDs are only comparable within the same table.
+    if (a._table == b._table)
+    {
+        return a._data == b._data;
+    }
+
+    return a._data.size() == b._data.size() && std::equal(a.cbegin(), a.cend(), b.cbegin());
 }
@@ -22,15 +22,90 @@ Revision History:
 
 #include "til/rle.h"
 #include "TextAttribute.hpp"
+#include "TextAttributeTable.hpp"
 
 class ATTR_ROW final
 {
-    using rle_vector = til::small_rle<TextAttribute, uint16_t, 1>;
+    using rle_vector = til::small_rle<TextAttributeId, uint16_t, 1>;
 
 public:
-    using const_iterator = rle_vector::const_iterator;
-
-    ATTR_ROW(uint16_t width, TextAttribute attr);
+    // Iterates over the cells of the row, resolving each cell's attribute ID through the table.
+    class const_iterator
+    {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = TextAttribute;
+        using pointer = const TextAttribute*;
+        using reference = const TextAttribute&;
+        using difference_type = rle_vector::const_iterator::difference_type;
+
+        const_iterator(rle_vector::const_iterator it, const TextAttributeTable* table) noexcept :
+            _it{ std::move(it) },
+            _table{ table }
+        {
+        }
+
+        [[nodiscard]] reference operator*() const noexcept { return _table->Get(*_it); }
+        [[nodiscard]] pointer operator->() const noexcept { return &operator*(); }
+        [[nodiscard]] reference operator[](const difference_type offset) const noexcept { return *operator+(offset); }
+
+        [[nodiscard]] TextAttributeId Id() const noexcept { return *_it; }
+
+        const_iterator& operator++() noexcept
+        {
+            ++_it;
+            return *this;
+        }
+
+        const_iterator operator++(int) noexcept
+        {
+            auto tmp = *this;
+            ++_it;
+            return tmp;
+        }
+
+        const_iterator& operator--() noexcept
+        {
+            --_it;
+            return *this;
+        }
+
+        const_iterator operator--(int) noexcept
+        {
+            auto tmp = *this;
+            --_it;
+            return tmp;
+        }
+
+        const_iterator& operator+=(const difference_type offset) noexcept
+        {
+            _it += offset;
+            return *this;
+        }
+
+        const_iterator& operator-=(const difference_type offset) noexcept
+        {
+            _it -= offset;
+            return *this;
+        }
+
+        [[nodiscard]] const_iterator operator+(const difference_type offset) const noexcept { return { _it + offset, _table }; }
+        [[nodiscard]] const_iterator operator-(const difference_type offset) const noexcept { return { _it - offset, _table }; }
+        [[nodiscard]] difference_type operator-(const const_iterator& right) const noexcept { return _it - right._it; }
+
+        [[nodiscard]] bool operator==(const const_iterator& right) const noexcept { return _it == right._it; }
+        [[nodiscard]] bool operator!=(const const_iterator& right) const noexcept { return _it != right._it; }
+        [[nodiscard]] bool operator<(const const_iterator& right) const noexcept { return _it < right._it; }
+        [[nodiscard]] bool operator>(const const_iterator& right) const noexcept { return _it > right._it; }
+        [[nodiscard]] bool operator<=(const const_iterator& right) const noexcept { return _it <= right._it; }
+        [[nodiscard]] bool operator>=(const const_iterator& right) const noexcept { return _it >= right._it; }
+
+    private:
+        rle_vector::const_iterator _it;
+        const TextAttributeTable* _table;
+    };
+
+    ATTR_ROW(uint16_t width, TextAttribute attr, TextAttributeTable& table);
 
     ~ATTR_ROW() = default;
 
@@ -41,13 +116,61 @@ public:
     ATTR_ROW& operator=(ATTR_ROW&&) noexcept = default;
 
     TextAttribute GetAttrByColumn(uint16_t column) const;
+    TextAttributeId GetAttrIdByColumn(uint16_t column) const;
     std::vector<uint16_t> GetHyperlinks() const;
 
+    // Routine Description:
+    // - Calls func(beginIndex, endIndex, attr) for each run of cells with the same attributes
+    //   that intersects with [beginIndex, endIndex). The runs are clamped to that range.
+    // - This allows callers to look at every attribute in a range once per run, instead of once per cell.
+    // Arguments:
+    // - beginIndex - the first column of the range
+    // - endIndex - the column after the last column of the range
+    // - backwards - if true, the runs are visited from right to left
+    // - func - the function to call. Iteration stops if it returns false.
+    // Return Value:
+    // - false if func stopped the iteration, true otherwise.
+    template<typename TFunc>
+    bool ForEachRun(const uint16_t beginIndex, const uint16_t endIndex, const bool backwards, TFunc&& func) const
+    {
+        const auto& runs = _data.runs();
+        if (!backwards)
+        {
+            uint16_t runBegin = 0;
+            for (auto it = runs.begin(); it != runs.end() && runBegin < endIndex; ++it)
+            {
+                const auto runEnd = gsl::narrow_cast<uint16_t>(runBegin + it->length);
+                if (runEnd > beginIndex && !func(std::max(runBegin, beginIndex), std::min(runEnd, endIndex), _table->Get(it->value)))
+                {
+                    return false;
+                }
+                runBegin = runEnd;
+            }
+        }
+        else
+        {
+            auto runEnd = _data.size();
+            for (auto it = runs.rbegin(); it != runs.rend() && runEnd > beginIndex; ++it)
+            {
+                const auto runBegin = gsl::narrow_cast<uint16_t>(runEnd - it->length);
+                if (runBegin < endIndex && !func(std::max(runBegin, beginIndex), std::min(runEnd, endIndex), _table->Get(it->value)))
+                {
+                    return false;
+                }
+                runEnd = runBegin;
+            }
+        }
+        return true;
+    }
+
     bool SetAttrToEnd(uint16_t beginIndex, TextAttribute attr);
     void ReplaceAttrs(const TextAttribute& toBeReplacedAttr, const TextAttribute& replaceWith);
     void Resize(uint16_t newWidth);
     void Replace(uint16_t beginIndex, uint16_t endIndex, const TextAttribute& newAttr);
 
+    void MarkUsedIds(std::vector<bool>& used) const;
+    void RemapIds(const std::vector<TextAttributeId>& remap);
+
     const_iterator begin() const noexcept;
     const_iterator end() const noexcept;
 
@@ -61,6 +184,7 @@ private:
     void Reset(const TextAttribute attr);
 
     rle_vector _data;
+    TextAttributeTable* _table; // non ownership pointer
 
 #ifdef UNIT_TESTING
     friend class CommonState;
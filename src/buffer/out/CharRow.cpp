@@ -7,6 +7,44 @@
 #include "unicode.hpp"
 #include "Row.hpp"
 
+namespace
+{
+    // Returns the index of the lowest set bit. bits must not be 0.
+    size_t _LowestBit(const uint64_t bits) noexcept
+    {
+        unsigned long index = 0;
+#if defined(_M_X64) || defined(_M_ARM64)
+        _BitScanForward64(&index, bits);
+#else
+        if (!_BitScanForward(&index, gsl::narrow_cast<unsigned long>(bits)))
+        {
+            _BitScanForward(&index, gsl::narrow_cast<unsigned long>(bits >> 32));
+            index += 32;
+        }
+#endif
+        return index;
+    }
+
+    // Returns the index of the highest set bit. bits must not be 0.
+    size_t _HighestBit(const uint64_t bits) noexcept
+    {
+        unsigned long index = 0;
+#if defined(_M_X64) || defined(_M_ARM64)
+        _BitScanReverse64(&index, bits);
+#else
+        if (_BitScanReverse(&index, gsl::narrow_cast<unsigned long>(bits >> 32)))
+        {
+            index += 32;
+        }
+        else
+        {
+            _BitScanReverse(&index, gsl::narrow_cast<unsigned long>(bits));
+        }
+#endif
+        return index;
+    }
+}
+
 // Routine Description:
 // - constructor
 // Arguments:
@@ -43,6 +81,7 @@ size_t CharRow::size() const noexcept
 // - <none>
 void CharRow::Reset() noexcept
 {
+    _InvalidateWordClasses();
     for (auto& cell : _data)
     {
         cell.Reset();
@@ -61,6 +100,7 @@ void CharRow::Reset() noexcept
     {
         const value_type insertVals;
         _data.resize(newSize, insertVals);
+        _InvalidateWordClasses();
     }
     CATCH_RETURN();
 
@@ -121,9 +161,29 @@ size_t CharRow::MeasureRight() const
 
 void CharRow::ClearCell(const size_t column)
 {
+    _InvalidateWordClasses();
     _data.at(column).Reset();
 }
 
+// Routine Description:
+// - overwrites a span of cells with glyphs that are each exactly one narrow,
+//   single code unit cell. this skips the per-cell glyph reference and
+//   dbcs handling that writing through GlyphAt would otherwise require.
+// Arguments:
+// - column - 0-indexed column of the first cell to write
+// - text - the glyphs to write, one per cell
+// Note:
+// - will throw if the text doesn't fit in the row
+void CharRow::WriteNarrowRun(const size_t column, const std::wstring_view text)
+{
+    THROW_HR_IF(E_INVALIDARG, column > _data.size() || text.size() > _data.size() - column);
+    _InvalidateWordClasses();
+
+    std::transform(text.cbegin(), text.cend(), _data.begin() + column, [](const wchar_t wch) noexcept {
+        return value_type{ wch, DbcsAttribute{} };
+    });
+}
+
 // Routine Description:
 // - Tells you whether or not this row contains any valid text.
 // Arguments:
@@ -161,6 +221,8 @@ const DbcsAttribute& CharRow::DbcsAttrAt(const size_t column) const
 // Return Value:
 // - the attribute
 // Note: will throw exception if column is out of bounds
+// - The attribute doesn't take part in the delimiter class of the cell, so
+//   this keeps the cached delimiter classes.
 DbcsAttribute& CharRow::DbcsAttrAt(const size_t column)
 {
     return _data.at(column).DbcsAttr();
@@ -175,6 +237,7 @@ DbcsAttribute& CharRow::DbcsAttrAt(const size_t column)
 // Note: will throw exception if column is out of bounds
 void CharRow::ClearGlyph(const size_t column)
 {
+    _InvalidateWordClasses();
     _data.at(column).EraseChars();
 }
 
@@ -198,6 +261,7 @@ const CharRow::reference CharRow::GlyphAt(const size_t column) const
 // Return Value:
 // - text data at column
 // - Note: will throw exception if column is out of bounds
+// - Assigning to the reference discards the cached delimiter classes, reading from it doesn't.
 CharRow::reference CharRow::GlyphAt(const size_t column)
 {
     THROW_HR_IF(E_INVALIDARG, column >= _data.size());
@@ -231,11 +295,100 @@ std::wstring CharRow::GetText() const
 // - wordDelimiters: the delimiters defined as a part of the DelimiterClass::DelimiterChar
 // Return Value:
 // - the delimiter class for the given char
-const DelimiterClass CharRow::DelimiterClassAt(const size_t column, const std::wstring_view wordDelimiters) const
+const DelimiterClass CharRow::DelimiterClassAt(const size_t column, const WordDelimiters& wordDelimiters) const
 {
     THROW_HR_IF(E_INVALIDARG, column >= _data.size());
 
-    const auto glyph = *GlyphAt(column).begin();
+    _UpdateWordClasses(wordDelimiters);
+    const auto bit = uint64_t{ 1 } << (column % 64);
+    if (til::at(_wordClasses, column / 64) & bit)
+    {
+        return DelimiterClass::RegularChar;
+    }
+    else if (til::at(_wordClasses, _wordClasses.size() / 2 + column / 64) & bit)
+    {
+        return DelimiterClass::DelimiterChar;
+    }
+    else
+    {
+        return DelimiterClass::ControlChar;
+    }
+}
+
+// Method Description:
+// - finds the first column at or after the given one whose delimiter class
+//   is (or, if match is false, isn't) the given class
+// Arguments:
+// - column: the column to start searching at
+// - delimiterClass: the delimiter class to look for
+// - match: whether to look for a cell of that class or for one of any other class
+// - wordDelimiters: the delimiters defined as a part of the DelimiterClass::DelimiterChar
+// Return Value:
+// - the found column, or nullopt if there's none until the end of the row
+std::optional<size_t> CharRow::FindNextDelimiterClass(const size_t column, const DelimiterClass delimiterClass, const bool match, const WordDelimiters& wordDelimiters) const
+{
+    THROW_HR_IF(E_INVALIDARG, column >= _data.size());
+
+    _UpdateWordClasses(wordDelimiters);
+    const auto words = _wordClasses.size() / 2;
+    for (auto word = column / 64; word < words; ++word)
+    {
+        auto bits = _WordClassBits(word, delimiterClass, match);
+        if (word == column / 64)
+        {
+            bits &= ~uint64_t{ 0 } << (column % 64);
+        }
+
+        if (bits)
+        {
+            // The last word is padded with ControlChar bits past the end of the row.
+            const auto found = word * 64 + _LowestBit(bits);
+            return found < _data.size() ? std::optional{ found } : std::nullopt;
+        }
+    }
+    return std::nullopt;
+}
+
+// Method Description:
+// - finds the last column at or before the given one whose delimiter class
+//   is (or, if match is false, isn't) the given class
+// Arguments:
+// - column: the column to start searching at
+// - delimiterClass: the delimiter class to look for
+// - match: whether to look for a cell of that class or for one of any other class
+// - wordDelimiters: the delimiters defined as a part of the DelimiterClass::DelimiterChar
+// Return Value:
+// - the found column, or nullopt if there's none until the start of the row
+std::optional<size_t> CharRow::FindPreviousDelimiterClass(const size_t column, const DelimiterClass delimiterClass, const bool match, const WordDelimiters& wordDelimiters) const
+{
+    THROW_HR_IF(E_INVALIDARG, column >= _data.size());
+
+    _UpdateWordClasses(wordDelimiters);
+    for (auto word = column / 64 + 1; word-- > 0;)
+    {
+        auto bits = _WordClassBits(word, delimiterClass, match);
+        if (word == column / 64)
+        {
+            bits &= ~uint64_t{ 0 } >> (63 - column % 64);
+        }
+
+        if (bits)
+        {
+            return word * 64 + _HighestBit(bits);
+        }
+    }
+    return std::nullopt;
+}
+
+// Routine Description:
+// - classifies a single glyph for word navigation
+// Arguments:
+// - glyph: the first code unit of the glyph
+// - wordDelimiters: the delimiters defined as a part of the DelimiterClass::DelimiterChar
+// Return Value:
+// - the delimiter class for the given glyph
+DelimiterClass CharRow::_ClassifyGlyph(const glyph_type glyph, const std::wstring_view wordDelimiters) noexcept
+{
     if (glyph <= UNICODE_SPACE)
     {
         return DelimiterClass::ControlChar;
@@ -250,6 +403,79 @@ const DelimiterClass CharRow::DelimiterClassAt(const size_t column, const std::w
     }
 }
 
+// Routine Description:
+// - discards the cached delimiter classes. Must be called by anything that writes to the row.
+void CharRow::_InvalidateWordClasses() noexcept
+{
+    _wordClassesId = 0;
+}
+
+// Routine Description:
+// - (re)builds the cached delimiter classes of all cells, unless they're
+//   already up to date for the given delimiters
+// Arguments:
+// - wordDelimiters: the delimiters defined as a part of the DelimiterClass::DelimiterChar
+void CharRow::_UpdateWordClasses(const WordDelimiters& wordDelimiters) const
+{
+    if (_wordClassesId == wordDelimiters.id)
+    {
+        return;
+    }
+
+    // Don't leave a half built index marked as valid if anything below throws.
+    _wordClassesId = 0;
+
+    const auto words = (_data.size() + 63) / 64;
+    _wordClasses.assign(words * 2, 0);
+    for (size_t column = 0; column < _data.size(); ++column)
+    {
+        const auto bit = uint64_t{ 1 } << (column % 64);
+        switch (_ClassifyGlyph(*GlyphAt(column).begin(), wordDelimiters.chars))
+        {
+        case DelimiterClass::RegularChar:
+            til::at(_wordClasses, column / 64) |= bit;
+            break;
+        case DelimiterClass::DelimiterChar:
+            til::at(_wordClasses, words + column / 64) |= bit;
+            break;
+        default:
+            break;
+        }
+    }
+
+    _wordClassesId = wordDelimiters.id;
+}
+
+// Routine Description:
+// - gets 64 cells worth of the cached delimiter classes
+// Arguments:
+// - word: the index of the group of 64 cells
+// - delimiterClass: the delimiter class to get the cells of
+// - match: if false, the bits are inverted to get the cells of any other class
+// Return Value:
+// - a bitmap with a bit set for every cell of (or not of) the given class
+uint64_t CharRow::_WordClassBits(const size_t word, const DelimiterClass delimiterClass, const bool match) const noexcept
+{
+    const auto words = _wordClasses.size() / 2;
+    const auto regular = til::at(_wordClasses, word);
+    const auto delimiter = til::at(_wordClasses, words + word);
+
+    uint64_t bits;
+    switch (delimiterClass)
+    {
+    case DelimiterClass::RegularChar:
+        bits = regular;
+        break;
+    case DelimiterClass::DelimiterChar:
+        bits = delimiter;
+        break;
+    default:
+        bits = ~(regular | delimiter);
+        break;
+    }
+    return match ? bits : ~bits;
+}
+
 UnicodeStorage& CharRow::GetUnicodeStorage() noexcept
 {
     return _pParent->GetUnicodeStorage();
@@ -34,6 +34,15 @@ enum class DelimiterClass
     RegularChar
 };
 
+// A set of word delimiters, along with an id that no other set of delimiters has
+// (0 is never used). Rows tag their cached delimiter classes with that id, so that
+// checking whether the cache fits the delimiters doesn't compare any strings.
+struct WordDelimiters
+{
+    std::wstring_view chars;
+    uint32_t id;
+};
+
 // the characters of one row of screen buffer
 // we keep the following values so that we don't write
 // more pixels to the screen than we have to:
@@ -65,13 +74,17 @@ public:
     DbcsAttribute& DbcsAttrAt(const size_t column);
     void ClearGlyph(const size_t column);
 
-    const DelimiterClass DelimiterClassAt(const size_t column, const std::wstring_view wordDelimiters) const;
+    const DelimiterClass DelimiterClassAt(const size_t column, const WordDelimiters& wordDelimiters) const;
+    std::optional<size_t> FindNextDelimiterClass(const size_t column, const DelimiterClass delimiterClass, const bool match, const WordDelimiters& wordDelimiters) const;
+    std::optional<size_t> FindPreviousDelimiterClass(const size_t column, const DelimiterClass delimiterClass, const bool match, const WordDelimiters& wordDelimiters) const;
 
     // working with glyphs
     const reference GlyphAt(const size_t column) const;
     reference GlyphAt(const size_t column);
 
     // iterators
+    // The mutable iterators hand out the cells as they are, to fill rows in bulk. Unlike
+    // the other writers, writing through them keeps the cached delimiter classes.
     iterator begin() noexcept;
     const_iterator cbegin() const noexcept;
     const_iterator begin() const noexcept { return cbegin(); }
@@ -92,14 +105,29 @@ public:
 private:
     void Reset() noexcept;
     void ClearCell(const size_t column);
+    void WriteNarrowRun(const size_t column, const std::wstring_view text);
     std::wstring GetText() const;
 
+    static DelimiterClass _ClassifyGlyph(const glyph_type glyph, const std::wstring_view wordDelimiters) noexcept;
+    void _InvalidateWordClasses() noexcept;
+    void _UpdateWordClasses(const WordDelimiters& wordDelimiters) const;
+    uint64_t _WordClassBits(const size_t word, const DelimiterClass delimiterClass, const bool match) const noexcept;
+
 protected:
     // storage for glyph data and dbcs attributes
     boost::container::small_vector<value_type, 120> _data;
 
     // ROW that this CharRow belongs to
     ROW* _pParent;
+
+    // Lazily built index of the delimiter class of every cell, so that word
+    // navigation can scan 64 cells at a time instead of looking at each glyph.
+    // It holds a bitmap of the RegularChar cells followed by one of the
+    // DelimiterChar cells; cells in neither are ControlChar. It's tagged with the
+    // id of the delimiters it was built for, or 0 if it needs to be rebuilt. Any
+    // write to the glyphs discards it. Rows of up to 128 cells keep it inline.
+    mutable boost::container::small_vector<uint64_t, 4> _wordClasses;
+    mutable uint32_t _wordClassesId = 0;
 };
 
 template<typename InputIt1, typename InputIt2>
@@ -12,6 +12,7 @@
 void CharRowCellReference::operator=(const std::wstring_view chars)
 {
     THROW_HR_IF(E_INVALIDARG, chars.empty());
+    _parent._InvalidateWordClasses();
     if (chars.size() == 1)
     {
         _cellData().Char() = chars.front();
@@ -325,6 +325,68 @@ const OutputCellView* OutputCellIterator::operator->() const noexcept
     return &_currentView;
 }
 
+// Routine Description:
+// - Finds the run of text at the current position that can be copied straight
+//   into a row without any further per-cell processing: printable ASCII only,
+//   so that every code unit is exactly one narrow, single-width cell.
+// - Only text backed modes (Loose and LooseTextOnly) can produce a run.
+// Arguments:
+// - maxCells - the maximum number of cells the caller is able to accept.
+// Return Value:
+// - A view of the text making up the run. Empty if the current position
+//   doesn't start such a run.
+std::wstring_view OutputCellIterator::PeekNarrowRun(const size_t maxCells) const noexcept
+{
+    if (_mode != Mode::Loose && _mode != Mode::LooseTextOnly)
+    {
+        return {};
+    }
+
+    // If we're in the middle of a wide glyph, the trailing half has to go
+    // through the regular path first.
+    if (_currentView.DbcsAttr().IsTrailing())
+    {
+        return {};
+    }
+
+    const auto text = std::get_if<std::wstring_view>(&_run);
+    if (!text || _pos >= text->size())
+    {
+        return {};
+    }
+
+    const auto available = std::min(text->size() - _pos, maxCells);
+    const auto begin = text->data() + _pos;
+    const auto end = std::find_if(begin, begin + available, [](const wchar_t wch) noexcept {
+        return wch < UNICODE_SPACE || wch > L'~';
+    });
+
+    return { begin, gsl::narrow_cast<size_t>(end - begin) };
+}
+
+// Routine Description:
+// - Advances the iterator over a run previously returned by PeekNarrowRun.
+//   This is the bulk equivalent of calling operator++ count times.
+// Arguments:
+// - count - the number of cells (and code units) to skip. Must not exceed
+//   the length of the last run returned by PeekNarrowRun.
+void OutputCellIterator::AdvanceNarrowRun(const size_t count)
+{
+    if (count == 0)
+    {
+        return;
+    }
+
+    _distance += count;
+    _pos += count;
+
+    if (operator bool())
+    {
+        const auto remaining = std::get<std::wstring_view>(_run).substr(_pos);
+        _currentView = _mode == Mode::Loose ? s_GenerateView(remaining, _attr) : s_GenerateView(remaining);
+    }
+}
+
 // Routine Description:
 // - Checks the current view. If it is a leading half, it updates the current
 //   view to the trailing half of the same glyph.
@@ -52,6 +52,9 @@ public:
     ptrdiff_t GetInputDistance(OutputCellIterator other) const noexcept;
     friend ptrdiff_t operator-(OutputCellIterator one, OutputCellIterator two) = delete;
 
+    std::wstring_view PeekNarrowRun(const size_t maxCells) const noexcept;
+    void AdvanceNarrowRun(const size_t count);
+
     OutputCellIterator& operator++();
     OutputCellIterator operator++(int);
 
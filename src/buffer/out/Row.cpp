@@ -20,7 +20,7 @@ ROW::ROW(const SHORT rowId, const unsigned short rowWidth, const TextAttribute f
     _id{ rowId },
     _rowWidth{ rowWidth },
     _charRow{ rowWidth, this },
-    _attrRow{ rowWidth, fillAttribute },
+    _attrRow{ rowWidth, fillAttribute, pParent->GetAttributeTable() },
     _lineRendition{ LineRendition::SingleWidth },
     _wrapForced{ false },
     _doubleBytePadded{ false },
@@ -118,6 +118,41 @@ OutputCellIterator ROW::WriteCells(OutputCellIterator it, const size_t index, co
 
     while (it && currentIndex <= finalColumnInRow)
     {
+        // Fast path: when the iterator is sitting on a run of plain narrow text, copy the
+        // whole run into the char row at once and account for its color as a single span
+        // instead of walking it cell by cell. This is the common case for streamed output.
+        if (const auto run = it.PeekNarrowRun(finalColumnInRow - currentIndex + 1); !run.empty())
+        {
+            const auto runLength = gsl::narrow_cast<uint16_t>(run.size());
+
+            if (it->TextAttrBehavior() != TextAttributeBehavior::Current)
+            {
+                if (currentColor == it->TextAttr())
+                {
+                    colorUses += runLength;
+                }
+                else
+                {
+                    _attrRow.Replace(colorStarts, currentIndex, currentColor);
+                    currentColor = it->TextAttr();
+                    colorUses = runLength;
+                    colorStarts = currentIndex;
+                }
+            }
+
+            _charRow.WriteNarrowRun(currentIndex, run);
+            currentIndex += runLength;
+
+            // Same wrap rules as below: only when we've just filled the last column.
+            if (wrap.has_value() && currentIndex > finalColumnInRow)
+            {
+                SetWrapForced(*wrap);
+            }
+
+            it.AdvanceNarrowRun(run.size());
+            continue;
+        }
+
         // Fill the color if the behavior isn't set to keeping the current color.
         if (it->TextAttrBehavior() != TextAttributeBehavior::Current)
         {
@@ -196,3 +231,122 @@ OutputCellIterator ROW::WriteCells(OutputCellIterator it, const size_t index, co
 
     return it;
 }
+
+// Routine Description:
+// - Reads a span of cells out of this row in the CHAR_INFO format of the console API.
+// - This produces the same result as converting each cell one at a time, but the
+//   legacy attribute is only computed once per run of equal attributes.
+// Arguments:
+// - column - 0-indexed column of the first cell to read
+// - cells - receives one CHAR_INFO per column
+// Note:
+// - will throw if the span doesn't fit in the row
+void ROW::ReadCharInfos(const size_t column, const gsl::span<CHAR_INFO> cells) const
+{
+    THROW_HR_IF(E_INVALIDARG, column > _charRow.size() || cells.size() > _charRow.size() - column);
+
+    for (size_t i = 0; i < cells.size(); ++i)
+    {
+        const auto& cell = til::at(_charRow._data, column + i);
+        auto& charInfo = til::at(cells, i);
+        charInfo.Char.UnicodeChar = cell.DbcsAttr().IsGlyphStored() ? Utf16ToUcs2(_charRow.GlyphAt(column + i)) : cell.Char();
+        charInfo.Attributes = cell.DbcsAttr().GeneratePublicApiAttributeFormat();
+    }
+
+    const auto end = column + cells.size();
+    size_t runBegin = 0;
+    for (const auto& run : _attrRow._data.runs())
+    {
+        const size_t runEnd = runBegin + run.length;
+        if (runEnd > column)
+        {
+            const auto legacyAttributes = _attrRow._table->Get(run.value).GetLegacyAttributes();
+            for (auto i = std::max(runBegin, column); i < std::min(runEnd, end); ++i)
+            {
+                til::at(cells, i - column).Attributes |= legacyAttributes;
+            }
+        }
+        if (runEnd >= end)
+        {
+            break;
+        }
+        runBegin = runEnd;
+    }
+}
+
+// Routine Description:
+// - Writes a span of cells in the CHAR_INFO format of the console API into this row.
+// - This produces the same result as writing an OutputCellIterator over the cells
+//   with WriteCells, but the text is copied in one pass and each run of equal
+//   attributes is converted and stored only once.
+// Arguments:
+// - column - 0-indexed column of the first cell to write
+// - cells - the cells to write, one per column
+// - wrap - change the wrap flag if the write fills the last column of the row
+// Return Value:
+// - false if the cells need padding around a double byte character at either
+//   edge of the row, which only WriteCells handles. Nothing was written then.
+// Note:
+// - will throw if the span doesn't fit in the row
+bool ROW::WriteCharInfos(const size_t column, const gsl::span<const CHAR_INFO> cells, const std::optional<bool> wrap)
+{
+    THROW_HR_IF(E_INVALIDARG, column > _charRow.size() || cells.size() > _charRow.size() - column);
+
+    if (cells.empty())
+    {
+        return true;
+    }
+
+    const auto end = column + cells.size();
+    const auto isLeading = [](const CHAR_INFO& charInfo) noexcept {
+        return WI_IsFlagSet(charInfo.Attributes, COMMON_LVB_LEADING_BYTE);
+    };
+    const auto isTrailing = [](const CHAR_INFO& charInfo) noexcept {
+        return WI_IsFlagClear(charInfo.Attributes, COMMON_LVB_LEADING_BYTE) && WI_IsFlagSet(charInfo.Attributes, COMMON_LVB_TRAILING_BYTE);
+    };
+    if ((column == 0 && isTrailing(cells.front())) || (end == _charRow.size() && isLeading(cells.back())))
+    {
+        return false;
+    }
+
+    _charRow._InvalidateWordClasses();
+    for (size_t i = 0; i < cells.size(); ++i)
+    {
+        const auto& charInfo = til::at(cells, i);
+        DbcsAttribute dbcsAttr;
+        if (isLeading(charInfo))
+        {
+            dbcsAttr.SetLeading();
+        }
+        else if (isTrailing(charInfo))
+        {
+            dbcsAttr.SetTrailing();
+        }
+        til::at(_charRow._data, column + i) = { charInfo.Char.UnicodeChar, dbcsAttr };
+    }
+
+    // The lead and trail flags aren't part of the color, so they don't break up a run.
+    const auto colorOf = [](const CHAR_INFO& charInfo) noexcept {
+        return gsl::narrow_cast<WORD>(charInfo.Attributes & ~COMMON_LVB_SBCSDBCS);
+    };
+    auto runBegin = column;
+    auto runColor = colorOf(cells.front());
+    for (size_t i = 1; i < cells.size(); ++i)
+    {
+        const auto color = colorOf(til::at(cells, i));
+        if (color != runColor)
+        {
+            _attrRow.Replace(gsl::narrow_cast<uint16_t>(runBegin), gsl::narrow_cast<uint16_t>(column + i), TextAttribute{ runColor });
+            runBegin = column + i;
+            runColor = color;
+        }
+    }
+    _attrRow.Replace(gsl::narrow_cast<uint16_t>(runBegin), gsl::narrow_cast<uint16_t>(end), TextAttribute{ runColor });
+
+    if (wrap.has_value() && end == _charRow.size())
+    {
+        SetWrapForced(*wrap);
+    }
+
+    return true;
+}
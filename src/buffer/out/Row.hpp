@@ -65,6 +65,9 @@ public:
 
     OutputCellIterator WriteCells(OutputCellIterator it, const size_t index, const std::optional<bool> wrap = std::nullopt, std::optional<size_t> limitRight = std::nullopt);
 
+    void ReadCharInfos(const size_t column, const gsl::span<CHAR_INFO> cells) const;
+    bool WriteCharInfos(const size_t column, const gsl::span<const CHAR_INFO> cells, const std::optional<bool> wrap = std::nullopt);
+
 #ifdef UNIT_TESTING
     friend constexpr bool operator==(const ROW& a, const ROW& b) noexcept;
     friend class RowTests;
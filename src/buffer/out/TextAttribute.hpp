@@ -180,6 +180,8 @@ private:
     TextColor _background; // sizeof: 4, alignof: 1
     ExtendedAttributes _extendedAttrs; // sizeof: 1, alignof: 1
 
+    friend struct std::hash<TextAttribute>;
+
 #ifdef UNIT_TESTING
     friend class TextBufferTests;
     friend class TextAttributeTests;
@@ -209,6 +211,26 @@ constexpr bool operator!=(const TextAttribute& a, const TextAttribute& b) noexce
     return !(a == b);
 }
 
+namespace std
+{
+    template<>
+    struct hash<TextAttribute>
+    {
+        size_t operator()(const TextAttribute& attr) const noexcept
+        {
+            // Pack the fields into two words (without the padding byte) and mix them.
+            const uint64_t colors = static_cast<uint64_t>(hash<TextColor>{}(attr._foreground)) << 32 |
+                                    static_cast<uint64_t>(hash<TextColor>{}(attr._background));
+            const uint64_t meta = static_cast<uint64_t>(attr._wAttrLegacy) << 24 |
+                                  static_cast<uint64_t>(attr._hyperlinkId) << 8 |
+                                  static_cast<uint64_t>(attr._extendedAttrs);
+            auto h = colors ^ (meta * 0x9E3779B97F4A7C15ull);
+            h ^= h >> 29;
+            return static_cast<size_t>(h);
+        }
+    };
+}
+
 #ifdef UNIT_TESTING
 
 #define LOG_ATTR(attr) (Log::Comment(NoThrowString().Format( \
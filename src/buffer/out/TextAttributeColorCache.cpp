@@ -0,0 +1,82 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+#include "TextAttributeColorCache.hpp"
+
+// Routine Description:
+// - Hands out a new, process-wide unique color table generation.
+//   Owners of a color table should take a new generation whenever they modify the table.
+//   Since generations are never reused, copying a table along with its generation is safe.
+// Return Value:
+// - a generation number that hasn't been handed out before
+size_t TextAttributeColorCache::NextColorTableGeneration() noexcept
+{
+    static std::atomic<size_t> generation{ 0 };
+    return ++generation;
+}
+
+// Routine Description:
+// - Returns the same result as attr.CalculateRgbColors() with the given arguments,
+//   computing it only if this attribute wasn't resolved with the same inputs before.
+// Arguments:
+// - attr - the attribute to resolve
+// - colorTable - the current color table rgb values.
+// - colorTableGeneration - identifies the contents of colorTable. Must change whenever colorTable does.
+// - defaultFgColor - the default foreground color rgb value.
+// - defaultBgColor - the default background color rgb value.
+// - reverseScreenMode - true if the screen mode is reversed.
+// - blinkingIsFaint - true if blinking should be interpreted as faint.
+// Return Value:
+// - the foreground and background colors that should be displayed.
+TextAttributeColorCache::ColorPair TextAttributeColorCache::Resolve(const TextAttribute& attr,
+                                                                    const std::array<COLORREF, 256>& colorTable,
+                                                                    const size_t colorTableGeneration,
+                                                                    const COLORREF defaultFgColor,
+                                                                    const COLORREF defaultBgColor,
+                                                                    const bool reverseScreenMode,
+                                                                    const bool blinkingIsFaint) noexcept
+{
+    const Inputs inputs{ colorTableGeneration, defaultFgColor, defaultBgColor, reverseScreenMode, blinkingIsFaint };
+    if (!_inputs || !(*_inputs == inputs))
+    {
+        _colors.clear();
+        _inputs = inputs;
+    }
+
+    try
+    {
+        if (const auto it = _colors.find(attr); it != _colors.end())
+        {
+            return it->second;
+        }
+
+        if (_colors.size() >= MaxEntries)
+        {
+            _colors.clear();
+        }
+
+        const auto colors = attr.CalculateRgbColors(colorTable, defaultFgColor, defaultBgColor, reverseScreenMode, blinkingIsFaint);
+        _colors.emplace(attr, colors);
+        return colors;
+    }
+    catch (...)
+    {
+        LOG_CAUGHT_EXCEPTION();
+    }
+
+    return attr.CalculateRgbColors(colorTable, defaultFgColor, defaultBgColor, reverseScreenMode, blinkingIsFaint);
+}
+
+// Routine Description:
+// - Drops all cached colors.
+void TextAttributeColorCache::Invalidate() noexcept
+{
+    _colors.clear();
+    _inputs.reset();
+}
+
+size_t TextAttributeColorCache::size() const noexcept
+{
+    return _colors.size();
+}
@@ -0,0 +1,65 @@
+/*++
+Copyright (c) Microsoft Corporation
+Licensed under the MIT license.
+
+Module Name:
+- TextAttributeColorCache.hpp
+
+Abstract:
+- Memoizes TextAttribute::CalculateRgbColors, so that every distinct attribute
+  only gets resolved once per color table generation, instead of once per
+  painted run.
+- The cache remembers the inputs it was filled with and drops everything as
+  soon as any of them changes (color table generation, default colors,
+  reverse screen mode or blink state).
+--*/
+
+#pragma once
+
+#include "TextAttribute.hpp"
+
+class TextAttributeColorCache final
+{
+public:
+    using ColorPair = std::pair<COLORREF, COLORREF>;
+
+    // Beyond this many distinct attributes (think true color gradients),
+    // the cache is reset rather than allowed to grow without bound.
+    static constexpr size_t MaxEntries = 4096;
+
+    static size_t NextColorTableGeneration() noexcept;
+
+    ColorPair Resolve(const TextAttribute& attr,
+                      const std::array<COLORREF, 256>& colorTable,
+                      const size_t colorTableGeneration,
+                      const COLORREF defaultFgColor,
+                      const COLORREF defaultBgColor,
+                      const bool reverseScreenMode = false,
+                      const bool blinkingIsFaint = false) noexcept;
+
+    void Invalidate() noexcept;
+
+    size_t size() const noexcept;
+
+private:
+    struct Inputs
+    {
+        size_t colorTableGeneration;
+        COLORREF defaultFgColor;
+        COLORREF defaultBgColor;
+        bool reverseScreenMode;
+        bool blinkingIsFaint;
+
+        constexpr bool operator==(const Inputs& other) const noexcept
+        {
+            return colorTableGeneration == other.colorTableGeneration &&
+                   defaultFgColor == other.defaultFgColor &&
+                   defaultBgColor == other.defaultBgColor &&
+                   reverseScreenMode == other.reverseScreenMode &&
+                   blinkingIsFaint == other.blinkingIsFaint;
+        }
+    };
+
+    std::unordered_map<TextAttribute, ColorPair> _colors;
+    std::optional<Inputs> _inputs;
+};
@@ -0,0 +1,119 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+#include "TextAttributeTable.hpp"
+
+// Routine Description:
+// - constructor. The default attribute is always interned as ID 0,
+//   so that there's always a valid fallback ID.
+TextAttributeTable::TextAttributeTable()
+{
+    _attributes.emplace_back();
+    _ids.emplace(_attributes.back(), TextAttributeId{ 0 });
+}
+
+// Routine Description:
+// - Returns the ID for the given attribute, adding it to the table if it isn't in there yet.
+// - If the table is full, the compact callback gets a chance to free up unreferenced IDs first.
+// Arguments:
+// - attr - the attribute to intern
+// Return Value:
+// - the ID representing attr in this table
+TextAttributeId TextAttributeTable::Intern(const TextAttribute& attr)
+{
+    if (const auto it = _ids.find(attr); it != _ids.end())
+    {
+        return it->second;
+    }
+
+    if (_attributes.size() >= MaxSize && _compact)
+    {
+        _compact(*this);
+    }
+
+    if (_attributes.size() >= MaxSize)
+    {
+        // Every single ID is still referenced by the buffer. This takes more than 64k distinct
+        // attributes on screen at the same time. Rather than failing the write, degrade to the default.
+        LOG_HR_MSG(E_OUTOFMEMORY, "TextAttributeTable is full, falling back to the default attribute");
+        return 0;
+    }
+
+    const auto id = gsl::narrow_cast<TextAttributeId>(_attributes.size());
+    _attributes.emplace_back(attr);
+    _ids.emplace(attr, id);
+    return id;
+}
+
+// Routine Description:
+// - Looks up the ID of an attribute without adding it to the table.
+// Arguments:
+// - attr - the attribute to look for
+// Return Value:
+// - the ID of attr, or nullopt if it isn't in the table
+std::optional<TextAttributeId> TextAttributeTable::Find(const TextAttribute& attr) const noexcept
+{
+    try
+    {
+        if (const auto it = _ids.find(attr); it != _ids.end())
+        {
+            return it->second;
+        }
+    }
+    CATCH_LOG();
+
+    return std::nullopt;
+}
+
+// Routine Description:
+// - Resolves an ID back into its attribute.
+// Arguments:
+// - id - an ID previously returned by Intern()
+// Return Value:
+// - the attribute the ID represents. The reference stays valid until the next Compact().
+const TextAttribute& TextAttributeTable::Get(const TextAttributeId id) const noexcept
+{
+    return til::at(_attributes, id);
+}
+
+size_t TextAttributeTable::size() const noexcept
+{
+    return _attributes.size();
+}
+
+// Routine Description:
+// - Sets the function to call when the table runs out of IDs.
+void TextAttributeTable::SetCompactCallback(CompactCallback callback) noexcept
+{
+    _compact = std::move(callback);
+}
+
+// Routine Description:
+// - Drops all attributes that aren't marked as used and renumbers the remaining ones.
+//   The relative order of the remaining IDs is preserved and ID 0 is always kept.
+// Arguments:
+// - used - a flag for every ID in the table, true if the ID is still referenced
+// Return Value:
+// - a map from old IDs (the index) to new IDs. Unused IDs map to 0.
+std::vector<TextAttributeId> TextAttributeTable::Compact(const std::vector<bool>& used)
+{
+    std::vector<TextAttributeId> remap(_attributes.size(), TextAttributeId{ 0 });
+    std::deque<TextAttribute> attributes;
+    std::unordered_map<TextAttribute, TextAttributeId> ids;
+
+    for (size_t i = 0; i < _attributes.size(); ++i)
+    {
+        if (i == 0 || (i < used.size() && used[i]))
+        {
+            const auto id = gsl::narrow_cast<TextAttributeId>(attributes.size());
+            attributes.emplace_back(_attributes[i]);
+            ids.emplace(_attributes[i], id);
+            remap[i] = id;
+        }
+    }
+
+    _attributes = std::move(attributes);
+    _ids = std::move(ids);
+    return remap;
+}
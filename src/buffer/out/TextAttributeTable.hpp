@@ -0,0 +1,56 @@
+/*++
+Copyright (c) Microsoft Corporation
+Licensed under the MIT license.
+
+Module Name:
+- TextAttributeTable.hpp
+
+Abstract:
+- Per-buffer intern table for text attributes. Rows don't store full
+  TextAttribute values, but compact 16-bit IDs pointing into this table.
+- Equal attributes always map to the same ID, so comparing two IDs is
+  equivalent to comparing the attributes they represent.
+
+Revision History:
+- Split out of ATTR_ROW, which used to store TextAttribute values directly.
+--*/
+
+#pragma once
+
+#include "TextAttribute.hpp"
+
+using TextAttributeId = uint16_t;
+
+class TextAttributeTable final
+{
+public:
+    // Invoked when the table runs out of IDs. The owner is expected to call
+    // Compact() with the set of IDs that are still referenced and remap them.
+    using CompactCallback = std::function<void(TextAttributeTable&)>;
+
+    static constexpr size_t MaxSize = static_cast<size_t>(std::numeric_limits<TextAttributeId>::max()) + 1;
+
+    TextAttributeTable();
+
+    TextAttributeTable(const TextAttributeTable&) = delete;
+    TextAttributeTable& operator=(const TextAttributeTable&) = delete;
+
+    TextAttributeId Intern(const TextAttribute& attr);
+    std::optional<TextAttributeId> Find(const TextAttribute& attr) const noexcept;
+    const TextAttribute& Get(const TextAttributeId id) const noexcept;
+
+    size_t size() const noexcept;
+
+    void SetCompactCallback(CompactCallback callback) noexcept;
+    std::vector<TextAttributeId> Compact(const std::vector<bool>& used);
+
+private:
+    // A deque, so that references handed out by Get() stay valid while new attributes are interned.
+    std::deque<TextAttribute> _attributes;
+    std::unordered_map<TextAttribute, TextAttributeId> _ids;
+    CompactCallback _compact;
+
+#ifdef UNIT_TESTING
+    friend class TextAttributeTableTests;
+#endif
+};
@@ -105,6 +105,8 @@ private:
     BYTE _blue;
     ColorType _meta;
 
+    friend struct std::hash<TextColor>;
+
 #ifdef UNIT_TESTING
     friend class TextBufferTests;
     template<typename TextColor>
@@ -125,6 +127,23 @@ bool constexpr operator!=(const TextColor& a, const TextColor& b) noexcept
     return !(a == b);
 }
 
+namespace std
+{
+    template<>
+    struct hash<TextColor>
+    {
+        // Packs all four bytes of the color (including its type) into one value.
+        // Two colors compare equal exactly if their hashes do.
+        constexpr size_t operator()(const TextColor& color) const noexcept
+        {
+            return static_cast<size_t>(color._meta) << 24 |
+                   static_cast<size_t>(color._red) << 16 |
+                   static_cast<size_t>(color._green) << 8 |
+                   static_cast<size_t>(color._blue);
+        }
+    };
+}
+
 #ifdef UNIT_TESTING
 
 namespace WEX
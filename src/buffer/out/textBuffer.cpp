@@ -32,15 +32,21 @@ TextBuffer::TextBuffer(const COORD screenBufferSize,
                        const UINT cursorSize,
                        Microsoft::Console::Render::IRenderTarget& renderTarget) :
     _firstRow{ 0 },
+    _circledRowCount{ 0 },
     _currentAttributes{ defaultAttributes },
     _cursor{ cursorSize, *this },
+    _attributeTable{},
     _storage{},
     _unicodeStorage{},
     _renderTarget{ renderTarget },
     _size{},
     _currentHyperlinkId{ 1 },
-    _currentPatternId{ 0 }
+    _currentPatternId{ 0 },
+    _wordDelimiters{},
+    _wordDelimitersId{ 0 }
 {
+    _attributeTable.SetCompactCallback([this](TextAttributeTable&) { _CompactAttributeTable(); });
+
     // initialize ROWs
     _storage.reserve(static_cast<size_t>(screenBufferSize.Y));
     for (size_t i = 0; i < static_cast<size_t>(screenBufferSize.Y); ++i)
@@ -391,6 +397,40 @@ OutputCellIterator TextBuffer::WriteLine(const OutputCellIterator givenIt,
     return newIt;
 }
 
+// Routine Description:
+// - Reads a line of cells out of the buffer in the CHAR_INFO format of the console API.
+// Arguments:
+// - origin - Coordinate of the first cell to read
+// - cells - receives one CHAR_INFO per column. Must fit within the row.
+void TextBuffer::ReadCharInfos(const COORD origin, const gsl::span<CHAR_INFO> cells) const
+{
+    THROW_HR_IF(E_INVALIDARG, !GetSize().IsInBounds(origin));
+    GetRowByOffset(origin.Y).ReadCharInfos(origin.X, cells);
+}
+
+// Routine Description:
+// - Writes a line of cells in the CHAR_INFO format of the console API to the buffer.
+// - This is equivalent to Write() with an OutputCellIterator over the same cells
+//   that fit within the row, but skips the per-cell conversions of the iterator.
+// Arguments:
+// - target - Coordinate of the first cell to write
+// - cells - the cells to write, one per column. Must fit within the row.
+// - wrap - change the wrap flag if we fill the last column of the row
+void TextBuffer::WriteCharInfos(const COORD target, const gsl::span<const CHAR_INFO> cells, const std::optional<bool> wrap)
+{
+    THROW_HR_IF(E_INVALIDARG, !GetSize().IsInBounds(target));
+
+    if (GetRowByOffset(target.Y).WriteCharInfos(target.X, cells, wrap))
+    {
+        _NotifyPaint(Viewport::FromDimensions(target, { gsl::narrow<SHORT>(cells.size()), 1 }));
+    }
+    else
+    {
+        // Double byte characters at the edges of the row need padding, which the regular path takes care of.
+        Write(OutputCellIterator{ cells }, target, wrap);
+    }
+}
+
 //Routine Description:
 // - Inserts one codepoint into the buffer at the current cursor position and advances the cursor as appropriate.
 //Arguments:
@@ -574,6 +614,7 @@ bool TextBuffer::IncrementCircularBuffer(const bool inVtMode)
         // Now proceed to increment.
         // Incrementing it will cause the next line down to become the new "top" of the window (the new "0" in logical coordinates)
         _firstRow++;
+        _circledRowCount++;
 
         // If we pass up the height of the buffer, loop back to 0.
         if (_firstRow >= GetSize().Height())
@@ -665,6 +706,16 @@ const SHORT TextBuffer::GetFirstRowIndex() const noexcept
     return _firstRow;
 }
 
+// Routine Description:
+// - Retrieves the number of rows that have been cycled out of the top of the
+//   buffer by IncrementCircularBuffer, since the buffer was created.
+// - Row N at one point in time is row N - (increase of this count) later on,
+//   which lets callers that release their lock keep track of a row.
+size_t TextBuffer::GetCircledRowCount() const noexcept
+{
+    return _circledRowCount;
+}
+
 const Viewport TextBuffer::GetSize() const noexcept
 {
     return _size;
@@ -924,6 +975,8 @@ void TextBuffer::Reset()
             _storage.pop_back();
         }
         // add rows if we're growing
+        // (intern the fill attribute up front, so the table can't be compacted while _storage is being modified)
+        _attributeTable.Intern(attributes);
         while (_storage.size() < static_cast<size_t>(newSize.Y))
         {
             _storage.emplace_back(static_cast<short>(_storage.size()), newSize.X, attributes, this);
@@ -952,6 +1005,35 @@ UnicodeStorage& TextBuffer::GetUnicodeStorage() noexcept
     return _unicodeStorage;
 }
 
+const TextAttributeTable& TextBuffer::GetAttributeTable() const noexcept
+{
+    return _attributeTable;
+}
+
+TextAttributeTable& TextBuffer::GetAttributeTable() noexcept
+{
+    return _attributeTable;
+}
+
+// Routine Description:
+// - Called by the attribute table when it has run out of IDs.
+//   Drops all attributes that aren't referenced by any row anymore and renumbers the rest.
+void TextBuffer::_CompactAttributeTable()
+{
+    std::vector<bool> used(_attributeTable.size());
+    for (const auto& row : _storage)
+    {
+        row.GetAttrRow().MarkUsedIds(used);
+    }
+
+    const auto remap = _attributeTable.Compact(used);
+
+    for (auto& row : _storage)
+    {
+        row.GetAttrRow().RemapIds(remap);
+    }
+}
+
 // Routine Description:
 // - Method to help refresh all the Row IDs after manipulating the row
 //   by shuffling pointers around.
@@ -1036,17 +1118,78 @@ Microsoft::Console::Render::IRenderTarget& TextBuffer::GetRenderTarget() noexcep
     return _renderTarget;
 }
 
+// Routine Description:
+// - Pairs the given word delimiters with an id, under which the rows cache the
+//   delimiter classes of their cells. The id stays the same for as long as the
+//   delimiters do, so the rows' caches are reused until other delimiters are asked for.
+// Arguments:
+// - wordDelimiters - what characters are we considering for the separation of words
+// Return Value:
+// - the delimiters along with their id
+WordDelimiters TextBuffer::_GetWordDelimiters(const std::wstring_view wordDelimiters) const
+{
+    // The ids are unique across all buffers, in case rows ever move between them.
+    static std::atomic<uint32_t> nextId{ 0 };
+    if (_wordDelimitersId == 0 || _wordDelimiters != wordDelimiters)
+    {
+        _wordDelimiters = wordDelimiters;
+        _wordDelimitersId = ++nextId;
+    }
+    return { _wordDelimiters, _wordDelimitersId };
+}
+
 // Method Description:
-// - get delimiter class for buffer cell position
-// - used for double click selection and uia word navigation
+// - Finds the first cell at or after pos whose delimiter class is (or, if match is false, isn't) the given class.
+//   Each row keeps an index of the delimiter classes of its cells, so this looks at 64 cells at a time.
 // Arguments:
-// - pos: the buffer cell under observation
-// - wordDelimiters: the delimiters defined as a part of the DelimiterClass::DelimiterChar
+// - pos - the buffer cell to start searching at. Updated to the found cell.
+// - delimiterClass - the delimiter class to look for
+// - match - whether to look for a cell of that class or for one of any other class
+// - wordDelimiters - what characters are we considering for the separation of words
 // Return Value:
-// - the delimiter class for the given char
-const DelimiterClass TextBuffer::_GetDelimiterClassAt(const COORD pos, const std::wstring_view wordDelimiters) const
+// - true, if a cell was found. False, if there's none until the end of the buffer. pos is unchanged then.
+bool TextBuffer::_FindNextDelimiterClass(COORD& pos, const DelimiterClass delimiterClass, const bool match, const std::wstring_view wordDelimiters) const
 {
-    return GetRowByOffset(pos.Y).GetCharRow().DelimiterClassAt(pos.X, wordDelimiters);
+    const auto delimiters = _GetWordDelimiters(wordDelimiters);
+    const auto bufferSize = GetSize();
+    auto column = gsl::narrow_cast<size_t>(pos.X);
+    for (auto row = pos.Y; row <= bufferSize.BottomInclusive(); ++row)
+    {
+        if (const auto found = GetRowByOffset(row).GetCharRow().FindNextDelimiterClass(column, delimiterClass, match, delimiters))
+        {
+            pos = { gsl::narrow_cast<SHORT>(*found), row };
+            return true;
+        }
+        column = gsl::narrow_cast<size_t>(bufferSize.Left());
+    }
+    return false;
+}
+
+// Method Description:
+// - Finds the last cell at or before pos whose delimiter class is (or, if match is false, isn't) the given class.
+//   Each row keeps an index of the delimiter classes of its cells, so this looks at 64 cells at a time.
+// Arguments:
+// - pos - the buffer cell to start searching at. Updated to the found cell.
+// - delimiterClass - the delimiter class to look for
+// - match - whether to look for a cell of that class or for one of any other class
+// - wordDelimiters - what characters are we considering for the separation of words
+// Return Value:
+// - true, if a cell was found. False, if there's none until the start of the buffer. pos is unchanged then.
+bool TextBuffer::_FindPreviousDelimiterClass(COORD& pos, const DelimiterClass delimiterClass, const bool match, const std::wstring_view wordDelimiters) const
+{
+    const auto delimiters = _GetWordDelimiters(wordDelimiters);
+    const auto bufferSize = GetSize();
+    auto column = gsl::narrow_cast<size_t>(pos.X);
+    for (auto row = pos.Y; row >= bufferSize.Top(); --row)
+    {
+        if (const auto found = GetRowByOffset(row).GetCharRow().FindPreviousDelimiterClass(column, delimiterClass, match, delimiters))
+        {
+            pos = { gsl::narrow_cast<SHORT>(*found), row };
+            return true;
+        }
+        column = gsl::narrow_cast<size_t>(bufferSize.RightInclusive());
+    }
+    return false;
 }
 
 // Method Description:
@@ -1108,37 +1251,25 @@ const COORD TextBuffer::_GetWordStartForAccessibility(const COORD target, const
 {
     COORD result = target;
     const auto bufferSize = GetSize();
-    bool stayAtOrigin = false;
 
     // ignore left boundary. Continue until readable text found
-    while (_GetDelimiterClassAt(result, wordDelimiters) != DelimiterClass::RegularChar)
+    if (!_FindPreviousDelimiterClass(result, DelimiterClass::RegularChar, true, wordDelimiters))
     {
-        if (!bufferSize.DecrementInBounds(result))
-        {
-            // first char in buffer is a DelimiterChar or ControlChar
-            // we can't move any further back
-            stayAtOrigin = true;
-            break;
-        }
+        // there's nothing but DelimiterChars and ControlChars up to the first char in buffer
+        // we can't move any further back
+        return bufferSize.Origin();
     }
 
     // make sure we expand to the left boundary or the beginning of the word
-    while (_GetDelimiterClassAt(result, wordDelimiters) == DelimiterClass::RegularChar)
+    if (!_FindPreviousDelimiterClass(result, DelimiterClass::RegularChar, false, wordDelimiters))
     {
-        if (!bufferSize.DecrementInBounds(result))
-        {
-            // first char in buffer is a RegularChar
-            // we can't move any further back
-            break;
-        }
+        // first char in buffer is a RegularChar
+        // we can't move any further back
+        return bufferSize.Origin();
     }
 
     // move off of delimiter and onto word start
-    if (!stayAtOrigin && _GetDelimiterClassAt(result, wordDelimiters) != DelimiterClass::RegularChar)
-    {
-        bufferSize.IncrementInBounds(result);
-    }
-
+    bufferSize.IncrementInBounds(result);
     return result;
 }
 
@@ -1154,18 +1285,19 @@ const COORD TextBuffer::_GetWordStartForSelection(const COORD target, const std:
     COORD result = target;
     const auto bufferSize = GetSize();
 
-    const auto initialDelimiter = _GetDelimiterClassAt(result, wordDelimiters);
+    const auto delimiters = _GetWordDelimiters(wordDelimiters);
+    const auto& charRow = GetRowByOffset(target.Y).GetCharRow();
+    const auto initialDelimiter = charRow.DelimiterClassAt(target.X, delimiters);
 
     // expand left until we hit the left boundary or a different delimiter class
-    while (result.X > bufferSize.Left() && (_GetDelimiterClassAt(result, wordDelimiters) == initialDelimiter))
+    if (const auto previous = charRow.FindPreviousDelimiterClass(target.X, initialDelimiter, false, delimiters))
     {
-        bufferSize.DecrementInBounds(result);
+        // move off of delimiter
+        result.X = gsl::narrow_cast<SHORT>(*previous + 1);
     }
-
-    if (_GetDelimiterClassAt(result, wordDelimiters) != initialDelimiter)
+    else
     {
-        // move off of delimiter
-        bufferSize.IncrementInBounds(result);
+        result.X = bufferSize.Left();
     }
 
     return result;
@@ -1230,12 +1362,10 @@ const COORD TextBuffer::_GetWordEndForAccessibility(const COORD target, const st
     }
 
     // ignore right boundary. Continue through readable text found
-    while (_GetDelimiterClassAt(result, wordDelimiters) == DelimiterClass::RegularChar)
+    if (!_FindNextDelimiterClass(result, DelimiterClass::RegularChar, false, wordDelimiters))
     {
-        if (!bufferSize.IncrementInBounds(result, true))
-        {
-            break;
-        }
+        // the readable text runs up to the end of the buffer
+        return bufferSize.EndExclusive();
     }
 
     // we are already on/past the last RegularChar
@@ -1245,15 +1375,12 @@ const COORD TextBuffer::_GetWordEndForAccessibility(const COORD target, const st
     }
 
     // make sure we expand to the beginning of the NEXT word
-    while (_GetDelimiterClassAt(result, wordDelimiters) != DelimiterClass::RegularChar)
+    if (!_FindNextDelimiterClass(result, DelimiterClass::RegularChar, true, wordDelimiters))
     {
-        if (!bufferSize.IncrementInBounds(result, true))
-        {
-            // we are at the EndInclusive COORD
-            // this signifies that we must include the last char in the buffer
-            // but the position of the COORD points to nothing
-            break;
-        }
+        // we are at the EndInclusive COORD
+        // this signifies that we must include the last char in the buffer
+        // but the position of the COORD points to nothing
+        return bufferSize.EndExclusive();
     }
 
     return result;
@@ -1277,18 +1404,19 @@ const COORD TextBuffer::_GetWordEndForSelection(const COORD target, const std::w
     }
 
     COORD result = target;
-    const auto initialDelimiter = _GetDelimiterClassAt(result, wordDelimiters);
+    const auto delimiters = _GetWordDelimiters(wordDelimiters);
+    const auto& charRow = GetRowByOffset(target.Y).GetCharRow();
+    const auto initialDelimiter = charRow.DelimiterClassAt(target.X, delimiters);
 
     // expand right until we hit the right boundary or a different delimiter class
-    while (result.X < bufferSize.RightInclusive() && (_GetDelimiterClassAt(result, wordDelimiters) == initialDelimiter))
+    if (const auto next = charRow.FindNextDelimiterClass(target.X, initialDelimiter, false, delimiters))
     {
-        bufferSize.IncrementInBounds(result);
+        // move off of delimiter
+        result.X = gsl::narrow_cast<SHORT>(*next - 1);
     }
-
-    if (_GetDelimiterClassAt(result, wordDelimiters) != initialDelimiter)
+    else
     {
-        // move off of delimiter
-        bufferSize.DecrementInBounds(result);
+        result.X = bufferSize.RightInclusive();
     }
 
     return result;
@@ -2095,6 +2223,494 @@ std::string TextBuffer::GenRTF(const TextAndColor& rows, const int fontHeightPoi
     }
 }
 
+// Routine Description:
+// - Retrieves the text data from the selected region, along with its HTML and RTF representations if requested.
+// - This produces the same results as GetText followed by GenHTML and GenRTF, but in a single pass over
+//   the selected cells: colors are looked up once per run of cells with the same attributes instead of
+//   once per cell, and all formats are appended to buffers that are sized for the selection upfront.
+// Arguments:
+// - includeCRLF - inject CRLF pairs to the end of each line
+// - trimTrailingWhitespace - remove the trailing whitespace at the end of each line
+// - selectionRects - the rectangular regions from which the data will be extracted from the buffer
+// - formatting - the formats to generate in addition to the text, and how to style them
+// - formatWrappedRows - if set we will apply formatting (CRLF inclusion and whitespace trimming) on wrapped rows
+// Return Value:
+// - The text of the selected region, and its HTML and RTF representations if requested.
+TextBuffer::SelectionData TextBuffer::GetSelectionData(const bool includeCRLF,
+                                                       const bool trimTrailingWhitespace,
+                                                       const std::vector<SMALL_RECT>& selectionRects,
+                                                       const SelectionFormatting& formatting,
+                                                       const bool formatWrappedRows) const
+{
+    SelectionData data;
+    const bool copyTextColor = formatting.html || formatting.rtf;
+    FAIL_FAST_IF(copyTextColor && !formatting.GetAttributeColors);
+
+    // The text takes one character per cell, plus the CR/LFs. The HTML and RTF
+    // markup is usually small in comparison, as it's only emitted when colors change.
+    size_t cellCount = 0;
+    for (const auto& rect : selectionRects)
+    {
+        cellCount += gsl::narrow_cast<size_t>(std::max(0, rect.Right - rect.Left + 1)) + 2;
+    }
+    data.text.reserve(cellCount);
+
+    // The CF_HTML clipboard header precedes the HTML, but contains byte offsets into it.
+    // Once filled with values it's exactly 157 bytes long, so we reserve space for it
+    // and fill it in once we know the offsets.
+    static constexpr size_t ClipboardHeaderSize = 157;
+    static constexpr std::string_view HtmlHeader = "<!DOCTYPE><HTML><HEAD></HEAD><BODY>";
+    static constexpr std::string_view HtmlFooter = "</BODY></HTML>";
+    const auto fontFaceName = copyTextColor ? ConvertToA(CP_UTF8, formatting.fontFaceName) : std::string{};
+
+    if (formatting.html)
+    {
+        data.html.reserve(ClipboardHeaderSize + cellCount + 512);
+        data.html.append(ClipboardHeaderSize, ' ');
+        data.html.append(HtmlHeader);
+        data.html.append("<!--StartFragment -->");
+
+        // apply global style in div element
+        // note: MS Word doesn't support padding (in this way at least)
+        fmt::format_to(std::back_inserter(data.html),
+                       FMT_COMPILE("<DIV STYLE=\"display:inline-block;white-space:pre;background-color:#{:02X}{:02X}{:02X};font-family:'{}',monospace;font-size:{}pt;padding:4px;\">"),
+                       GetRValue(formatting.backgroundColor),
+                       GetGValue(formatting.backgroundColor),
+                       GetBValue(formatting.backgroundColor),
+                       fontFaceName,
+                       formatting.fontHeightPoints);
+    }
+
+    // The RTF color table precedes the content, but we only learn about the colors
+    // while writing the content. It's built separately and inserted at the end.
+    // colorIndices maps colors to their index in the color table.
+    std::string colorTable;
+    std::unordered_map<COLORREF, int> colorIndices;
+    const auto rtfColorIndex = [&](const COLORREF color) {
+        const auto [it, inserted] = colorIndices.emplace(color, gsl::narrow_cast<int>(colorIndices.size() + 1)); // leave 0 for the default color and start from 1.
+        if (inserted)
+        {
+            fmt::format_to(std::back_inserter(colorTable), FMT_COMPILE("\\red{}\\green{}\\blue{};"), GetRValue(color), GetGValue(color), GetBValue(color));
+        }
+        return it->second;
+    };
+
+    if (formatting.rtf)
+    {
+        data.rtf.reserve(cellCount + 512);
+        colorTable.append("{\\colortbl ;");
+        rtfColorIndex(formatting.backgroundColor);
+
+        // \fs specifies font size in half-points i.e. \fs20 results in a font size
+        // of 10 pts. That's why, font size is multiplied by 2 here.
+        fmt::format_to(std::back_inserter(data.rtf), FMT_COMPILE("\\viewkind4\\uc4\\pard\\slmult1\\f0\\fs{}\\highlight1 "), 2 * formatting.fontHeightPoints);
+    }
+
+    // A run of text in a row that has the same colors.
+    struct ColorRun
+    {
+        size_t begin;
+        COLORREF fg;
+        COLORREF bg;
+    };
+
+    // These are reused for every row, to avoid allocating per row.
+    std::wstring rowText;
+    std::vector<ColorRun> rowRuns;
+    std::string utf8;
+
+    // The colors of the most recent HTML span and RTF highlight. These carry over between rows.
+    std::optional<std::pair<COLORREF, COLORREF>> htmlColors;
+    std::optional<std::pair<COLORREF, COLORREF>> rtfColors;
+
+    for (size_t i = 0; i < selectionRects.size(); ++i)
+    {
+        const auto& rect = til::at(selectionRects, i);
+        const auto& row = GetRowByOffset(rect.Top);
+        const auto& charRow = row.GetCharRow();
+        const auto left = gsl::narrow_cast<size_t>(std::max<SHORT>(rect.Left, 0));
+        const auto right = std::min(gsl::narrow_cast<size_t>(std::max<SHORT>(rect.Right, -1) + 1), row.size());
+
+        rowText.clear();
+        rowRuns.clear();
+
+        // copy char data into the string buffer, skipping trailing bytes,
+        // and remember where the colors change
+        std::optional<TextAttributeId> runId;
+        auto attrIt = row.GetAttrRow().begin() + gsl::narrow_cast<ptrdiff_t>(left);
+        for (auto col = left; col < right; ++col, ++attrIt)
+        {
+            if (charRow.DbcsAttrAt(col).IsTrailing())
+            {
+                continue;
+            }
+
+            if (copyTextColor && runId != attrIt.Id())
+            {
+                runId = attrIt.Id();
+                const auto [fg, bg] = formatting.GetAttributeColors(*attrIt);
+                if (rowRuns.empty() || rowRuns.back().fg != fg || rowRuns.back().bg != bg)
+                {
+                    rowRuns.push_back({ rowText.size(), fg, bg });
+                }
+            }
+
+            const std::wstring_view glyph = charRow.GlyphAt(col);
+            rowText.append(glyph);
+        }
+
+        // We apply formatting to rows if the row was NOT wrapped or formatting of wrapped rows is allowed
+        const bool shouldFormatRow = formatWrappedRows || !row.WasWrapForced();
+
+        if (trimTrailingWhitespace && shouldFormatRow)
+        {
+            // remove the spaces at the end (aka trim the trailing whitespace)
+            const auto last = rowText.find_last_not_of(UNICODE_SPACE);
+            rowText.resize(last == std::wstring::npos ? 0 : last + 1);
+        }
+
+        data.text.append(rowText);
+
+        // apply CR/LF to the end of the final string, unless we're the last line.
+        if (includeCRLF && i < selectionRects.size() - 1 && shouldFormatRow)
+        {
+            data.text.push_back(UNICODE_CARRIAGERETURN);
+            data.text.push_back(UNICODE_LINEFEED);
+        }
+
+        if (!copyTextColor)
+        {
+            continue;
+        }
+
+        // Rows are separated by <BR> and \line respectively.
+        if (i != 0)
+        {
+            if (formatting.html)
+            {
+                data.html.append("<BR>");
+            }
+            if (formatting.rtf)
+            {
+                data.rtf.append("\\line ");
+            }
+        }
+
+        // do not include \r nor \n as they don't have color attributes
+        // and are neither HTML nor RTF friendly.
+        const auto formattedLength = std::min(rowText.find_first_of(L"\r\n"), rowText.size());
+
+        for (size_t run = 0; run < rowRuns.size(); ++run)
+        {
+            const auto& [begin, fg, bg] = til::at(rowRuns, run);
+            const auto end = std::min(run + 1 < rowRuns.size() ? til::at(rowRuns, run + 1).begin : rowText.size(), formattedLength);
+            if (begin >= end)
+            {
+                break;
+            }
+
+            const std::pair colors{ fg, bg };
+            THROW_IF_FAILED(til::u16u8(std::wstring_view{ rowText }.substr(begin, end - begin), utf8));
+
+            if (formatting.html)
+            {
+                if (htmlColors != colors)
+                {
+                    if (htmlColors)
+                    {
+                        data.html.append("</SPAN>");
+                    }
+
+                    fmt::format_to(std::back_inserter(data.html),
+                                   FMT_COMPILE("<SPAN STYLE=\"color:#{:02X}{:02X}{:02X};background-color:#{:02X}{:02X}{:02X};\">"),
+                                   GetRValue(fg),
+                                   GetGValue(fg),
+                                   GetBValue(fg),
+                                   GetRValue(bg),
+                                   GetGValue(bg),
+                                   GetBValue(bg));
+                    htmlColors = colors;
+                }
+
+                for (const auto c : utf8)
+                {
+                    switch (c)
+                    {
+                    case '<':
+                        data.html.append("&lt;");
+                        break;
+                    case '>':
+                        data.html.append("&gt;");
+                        break;
+                    case '&':
+                        data.html.append("&amp;");
+                        break;
+                    default:
+                        data.html.push_back(c);
+                    }
+                }
+            }
+
+            if (formatting.rtf)
+            {
+                if (rtfColors != colors)
+                {
+                    const auto bgIndex = rtfColorIndex(bg);
+                    const auto fgIndex = rtfColorIndex(fg);
+                    fmt::format_to(std::back_inserter(data.rtf), FMT_COMPILE("\\highlight{}\\cf{} "), bgIndex, fgIndex);
+                    rtfColors = colors;
+                }
+
+                for (const auto c : utf8)
+                {
+                    switch (c)
+                    {
+                    case '\\':
+                    case '{':
+                    case '}':
+                        data.rtf.push_back('\\');
+                        [[fallthrough]];
+                    default:
+                        data.rtf.push_back(c);
+                    }
+                }
+            }
+        }
+    }
+
+    if (formatting.html)
+    {
+        if (htmlColors)
+        {
+            // last opened span wasn't closed in loop above, so close it now
+            data.html.append("</SPAN>");
+        }
+
+        data.html.append("</DIV>");
+        data.html.append("<!--EndFragment -->");
+        data.html.append(HtmlFooter);
+
+        // these values are byte offsets from start of clipboard
+        const auto htmlStartPos = ClipboardHeaderSize;
+        const auto htmlEndPos = data.html.size();
+        const auto fragStartPos = ClipboardHeaderSize + HtmlHeader.size();
+        const auto fragEndPos = htmlEndPos - HtmlFooter.size();
+
+        // header required by HTML 0.9 format
+        const auto clipHeader = fmt::format(FMT_COMPILE("Version:0.9\r\n"
+                                                        "StartHTML:{:010}\r\n"
+                                                        "EndHTML:{:010}\r\n"
+                                                        "StartFragment:{:010}\r\n"
+                                                        "EndFragment:{:010}\r\n"
+                                                        "StartSelection:{:010}\r\n"
+                                                        "EndSelection:{:010}\r\n"),
+                                            htmlStartPos,
+                                            htmlEndPos,
+                                            fragStartPos,
+                                            fragEndPos,
+                                            fragStartPos,
+                                            fragEndPos);
+        THROW_HR_IF(E_UNEXPECTED, clipHeader.size() != ClipboardHeaderSize);
+        std::copy(clipHeader.begin(), clipHeader.end(), data.html.begin());
+    }
+
+    if (formatting.rtf)
+    {
+        // end colortbl
+        colorTable.append("}");
+
+        // Standard RTF header, the font table and the color table precede the text content.
+        // See GenRTF for an explanation of the header.
+        const auto prefix = fmt::format(FMT_COMPILE("{{\\rtf1\\ansi\\ansicpg1252\\deff0\\nouicompat{{\\fonttbl{{\\f0\\fmodern\\fcharset0 {};}}}}{}"), fontFaceName, colorTable);
+        data.rtf.insert(0, prefix);
+
+        // end rtf
+        data.rtf.append("}");
+    }
+
+    return data;
+}
+
+// Routine Description:
+// - Appends the text of the given rows to a string as UTF-8, one logical line at a time.
+//   Rows that were wrapped by the buffer are joined with the row that follows them.
+//   All other rows have their trailing whitespace removed and end with a CRLF.
+// - With ExportFormat::VirtualTerminal, an SGR sequence is written whenever the attributes
+//   of the text change, so that its colors and styles are restored when it's replayed.
+// - Only the given rows are read, which allows callers to export the buffer in chunks
+//   and release their lock on it in between.
+// Arguments:
+// - out - the string to append the text to
+// - firstRow - the first row to export
+// - lastRow - the row after the last row to export
+// - format - whether to include the attributes of the text
+// - lastAttributes - the attributes in effect at the end of the previous chunk.
+//   Receives the attributes in effect at the end of this chunk.
+void TextBuffer::ExportRows(std::string& out,
+                            const SHORT firstRow,
+                            const SHORT lastRow,
+                            const ExportFormat format,
+                            TextAttribute& lastAttributes) const
+{
+    const bool includeAttributes = format == ExportFormat::VirtualTerminal;
+
+    // Text is collected until the attributes change (or the chunk ends)
+    // and converted to UTF-8 all at once.
+    std::wstring text;
+    std::string utf8;
+    const auto flushText = [&]() {
+        THROW_IF_FAILED(til::u16u8(text, utf8));
+        out.append(utf8);
+        text.clear();
+    };
+
+    for (auto y = firstRow; y < lastRow; ++y)
+    {
+        const auto& row = GetRowByOffset(y);
+        const auto& charRow = row.GetCharRow();
+        const auto& attrRow = row.GetAttrRow();
+        const bool wrapped = row.WasWrapForced();
+
+        // The padding of a wide glyph that didn't fit at the end of the row isn't part of the text.
+        auto end = row.size();
+        if (wrapped && row.WasDoubleBytePadded() && end > 0)
+        {
+            --end;
+        }
+
+        // Trim the trailing whitespace. When exporting the attributes, whitespace with a
+        // colored background is kept, since it's part of things like highlighted status bars.
+        while (!wrapped && end > 0)
+        {
+            const std::wstring_view glyph = charRow.GlyphAt(end - 1);
+            if (glyph != L" " ||
+                (includeAttributes && !attrRow.GetAttrByColumn(gsl::narrow_cast<uint16_t>(end - 1)).BackgroundIsDefault()))
+            {
+                break;
+            }
+            --end;
+        }
+
+        std::optional<TextAttributeId> runId;
+        auto attrIt = attrRow.begin();
+        for (size_t col = 0; col < end; ++col, ++attrIt)
+        {
+            if (charRow.DbcsAttrAt(col).IsTrailing())
+            {
+                continue;
+            }
+
+            if (includeAttributes && runId != attrIt.Id())
+            {
+                runId = attrIt.Id();
+
+                // Hyperlinks aren't exported, so they mustn't cause redundant sequences.
+                auto attributes = *attrIt;
+                attributes.SetHyperlinkId(0);
+                if (attributes != lastAttributes)
+                {
+                    flushText();
+                    _AppendGraphicsRendition(out, attributes);
+                    lastAttributes = attributes;
+                }
+            }
+
+            const std::wstring_view glyph = charRow.GlyphAt(col);
+            text.append(glyph);
+        }
+
+        if (!wrapped)
+        {
+            text.push_back(UNICODE_CARRIAGERETURN);
+            text.push_back(UNICODE_LINEFEED);
+        }
+    }
+
+    flushText();
+}
+
+// Routine Description:
+// - Appends an SGR sequence that resets the text attributes and then applies the given ones.
+// Arguments:
+// - out - the string to append the sequence to
+// - attributes - the attributes to apply
+void TextBuffer::_AppendGraphicsRendition(std::string& out, const TextAttribute& attributes)
+{
+    // Colors are stored with Windows color table indices, which
+    // have red and blue swapped compared to the xterm ones.
+    const auto toXtermIndex = [](const BYTE index) {
+        return index < 16 ? (index & FOREGROUND_INTENSITY) |
+                                (WI_IsFlagSet(index, FOREGROUND_RED) ? 1 : 0) |
+                                (WI_IsFlagSet(index, FOREGROUND_GREEN) ? 2 : 0) |
+                                (WI_IsFlagSet(index, FOREGROUND_BLUE) ? 4 : 0) :
+                            index;
+    };
+
+    const auto appendColor = [&](const TextColor color, const bool isForeground) {
+        if (color.IsIndex16())
+        {
+            // The dark colors are in [30,37] and the bright ones in [90,97]. The
+            // background equivalents are 10 higher.
+            const auto index = toXtermIndex(color.GetIndex());
+            fmt::format_to(std::back_inserter(out), FMT_COMPILE(";{}"), (isForeground ? 30 : 40) + (index >= 8 ? 60 : 0) + (index & 7));
+        }
+        else if (color.IsIndex256())
+        {
+            fmt::format_to(std::back_inserter(out), FMT_COMPILE(";{}8;5;{}"), isForeground ? '3' : '4', toXtermIndex(color.GetIndex()));
+        }
+        else if (color.IsRgb())
+        {
+            const auto rgb = color.GetRGB();
+            fmt::format_to(std::back_inserter(out), FMT_COMPILE(";{}8;2;{};{};{}"), isForeground ? '3' : '4', GetRValue(rgb), GetGValue(rgb), GetBValue(rgb));
+        }
+    };
+
+    out.append("\x1b[0");
+    if (attributes.IsBold())
+    {
+        out.append(";1");
+    }
+    if (attributes.IsFaint())
+    {
+        out.append(";2");
+    }
+    if (attributes.IsItalic())
+    {
+        out.append(";3");
+    }
+    if (attributes.IsUnderlined())
+    {
+        out.append(";4");
+    }
+    if (attributes.IsBlinking())
+    {
+        out.append(";5");
+    }
+    if (attributes.IsReverseVideo())
+    {
+        out.append(";7");
+    }
+    if (attributes.IsInvisible())
+    {
+        out.append(";8");
+    }
+    if (attributes.IsCrossedOut())
+    {
+        out.append(";9");
+    }
+    if (attributes.IsDoublyUnderlined())
+    {
+        out.append(";21");
+    }
+    if (attributes.IsOverlined())
+    {
+        out.append(";53");
+    }
+    appendColor(attributes.GetForeground(), true);
+    appendColor(attributes.GetBackground(), false);
+    out.push_back('m');
+}
+
 // Function Description:
 // - Reflow the contents from the old buffer into the new buffer. The new buffer
 //   can have different dimensions than the old buffer. If it does, then this
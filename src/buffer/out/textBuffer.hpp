@@ -97,6 +97,9 @@ public:
                                  const std::optional<bool> setWrap = std::nullopt,
                                  const std::optional<size_t> limitRight = std::nullopt);
 
+    void ReadCharInfos(const COORD origin, const gsl::span<CHAR_INFO> cells) const;
+    void WriteCharInfos(const COORD target, const gsl::span<const CHAR_INFO> cells, const std::optional<bool> wrap = true);
+
     bool InsertCharacter(const wchar_t wch, const DbcsAttribute dbcsAttribute, const TextAttribute attr);
     bool InsertCharacter(const std::wstring_view chars, const DbcsAttribute dbcsAttribute, const TextAttribute attr);
     bool IncrementCursor();
@@ -111,6 +114,7 @@ public:
     const Cursor& GetCursor() const noexcept;
 
     const SHORT GetFirstRowIndex() const noexcept;
+    size_t GetCircledRowCount() const noexcept;
 
     const Microsoft::Console::Types::Viewport GetSize() const noexcept;
 
@@ -139,6 +143,9 @@ public:
     const UnicodeStorage& GetUnicodeStorage() const noexcept;
     UnicodeStorage& GetUnicodeStorage() noexcept;
 
+    const TextAttributeTable& GetAttributeTable() const noexcept;
+    TextAttributeTable& GetAttributeTable() noexcept;
+
     Microsoft::Console::Render::IRenderTarget& GetRenderTarget() noexcept;
 
     const COORD GetWordStart(const COORD target, const std::wstring_view wordDelimiters, bool accessibilityMode = false) const;
@@ -184,6 +191,43 @@ public:
                               const std::wstring_view fontFaceName,
                               const COLORREF backgroundColor);
 
+    // The formats GetSelectionData should produce in addition to plain text.
+    // GetAttributeColors is required if either html or rtf is set.
+    struct SelectionFormatting
+    {
+        std::function<std::pair<COLORREF, COLORREF>(const TextAttribute&)> GetAttributeColors;
+        int fontHeightPoints{ 0 };
+        std::wstring_view fontFaceName;
+        COLORREF backgroundColor{ 0 };
+        bool html{ false };
+        bool rtf{ false };
+    };
+
+    struct SelectionData
+    {
+        std::wstring text;
+        std::string html;
+        std::string rtf;
+    };
+
+    SelectionData GetSelectionData(const bool includeCRLF,
+                                   const bool trimTrailingWhitespace,
+                                   const std::vector<SMALL_RECT>& selectionRects,
+                                   const SelectionFormatting& formatting,
+                                   const bool formatWrappedRows = false) const;
+
+    enum class ExportFormat
+    {
+        PlainText,
+        VirtualTerminal
+    };
+
+    void ExportRows(std::string& out,
+                    const SHORT firstRow,
+                    const SHORT lastRow,
+                    const ExportFormat format,
+                    TextAttribute& lastAttributes) const;
+
     struct PositionInformation
     {
         short mutableViewportTop{ 0 };
@@ -203,10 +247,16 @@ public:
 private:
     void _UpdateSize();
     Microsoft::Console::Types::Viewport _size;
+
+    // interned attributes referenced by the rows. must outlive _storage.
+    TextAttributeTable _attributeTable;
+    void _CompactAttributeTable();
+
     std::vector<ROW> _storage;
     Cursor _cursor;
 
     SHORT _firstRow; // indexes top row (not necessarily 0)
+    size_t _circledRowCount; // number of rows that have been cycled out of the top of the buffer
 
     TextAttribute _currentAttributes;
 
@@ -230,6 +280,8 @@ private:
 
     void _NotifyPaint(const Microsoft::Console::Types::Viewport& viewport) const;
 
+    static void _AppendGraphicsRendition(std::string& out, const TextAttribute& attributes);
+
     // Assist with maintaining proper buffer state for Double Byte character sequences
     bool _PrepareForDoubleByteSequence(const DbcsAttribute dbcsAttribute);
     bool _AssertValidDoubleByteSequence(const DbcsAttribute dbcsAttribute);
@@ -239,7 +291,9 @@ private:
 
     void _ExpandTextRow(SMALL_RECT& selectionRow) const;
 
-    const DelimiterClass _GetDelimiterClassAt(const COORD pos, const std::wstring_view wordDelimiters) const;
+    WordDelimiters _GetWordDelimiters(const std::wstring_view wordDelimiters) const;
+    bool _FindNextDelimiterClass(COORD& pos, const DelimiterClass delimiterClass, const bool match, const std::wstring_view wordDelimiters) const;
+    bool _FindPreviousDelimiterClass(COORD& pos, const DelimiterClass delimiterClass, const bool match, const std::wstring_view wordDelimiters) const;
     const COORD _GetWordStartForAccessibility(const COORD target, const std::wstring_view wordDelimiters) const;
     const COORD _GetWordStartForSelection(const COORD target, const std::wstring_view wordDelimiters) const;
     const COORD _GetWordEndForAccessibility(const COORD target, const std::wstring_view wordDelimiters, const COORD lastCharPos) const;
@@ -250,6 +304,10 @@ private:
     std::unordered_map<size_t, std::wstring> _idsAndPatterns;
     size_t _currentPatternId;
 
+    // The delimiters of the last word navigation and their id, see _GetWordDelimiters.
+    mutable std::wstring _wordDelimiters;
+    mutable uint32_t _wordDelimitersId;
+
 #ifdef UNIT_TESTING
     friend class TextBufferTests;
     friend class UiaTextRangeTests;
@@ -0,0 +1,278 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+#include "WexTestClass.h"
+#include "../../inc/consoletaeftemplates.hpp"
+
+#include "../textBuffer.hpp"
+#include "../../renderer/inc/DummyRenderTarget.hpp"
+
+using namespace WEX::Common;
+using namespace WEX::Logging;
+using namespace WEX::TestExecution;
+
+class RowTests
+{
+    TEST_CLASS(RowTests);
+
+    TEST_METHOD_SETUP(MethodSetup)
+    {
+        _buffer = std::make_unique<TextBuffer>(COORD{ 120, 30 }, TextAttribute{ 0x7 }, 0, _renderTarget);
+        return true;
+    }
+
+    TEST_METHOD_CLEANUP(MethodCleanup)
+    {
+        _buffer.reset();
+        return true;
+    }
+
+    TEST_METHOD(WriteNarrowRunSingleAttribute)
+    {
+        auto& row = _buffer->GetRowByOffset(0);
+        const TextAttribute attr{ FOREGROUND_GREEN | BACKGROUND_BLUE };
+        const std::wstring_view text{ L"Hello, World!" };
+
+        const auto it = row.WriteCells(OutputCellIterator{ text, attr }, 5);
+        VERIFY_IS_FALSE(it);
+
+        const auto& charRow = row.GetCharRow();
+        for (size_t i = 0; i < text.size(); ++i)
+        {
+            VERIFY_ARE_EQUAL(std::wstring_view(&text.at(i), 1), std::wstring_view(charRow.GlyphAt(5 + i)));
+            VERIFY_IS_TRUE(charRow.DbcsAttrAt(5 + i).IsSingle());
+            VERIFY_IS_FALSE(charRow.DbcsAttrAt(5 + i).IsGlyphStored());
+        }
+
+        const auto& attrRow = row.GetAttrRow();
+        VERIFY_ARE_EQUAL(TextAttribute{ 0x7 }, attrRow.GetAttrByColumn(4));
+        VERIFY_ARE_EQUAL(attr, attrRow.GetAttrByColumn(5));
+        VERIFY_ARE_EQUAL(attr, attrRow.GetAttrByColumn(gsl::narrow<uint16_t>(5 + text.size() - 1)));
+        VERIFY_ARE_EQUAL(TextAttribute{ 0x7 }, attrRow.GetAttrByColumn(gsl::narrow<uint16_t>(5 + text.size())));
+    }
+
+    TEST_METHOD(WriteNarrowRunAroundWideGlyph)
+    {
+        auto& row = _buffer->GetRowByOffset(0);
+        const TextAttribute attr{ FOREGROUND_RED };
+
+        // The wide glyph in the middle breaks the narrow run and has to take the regular path.
+        const auto it = row.WriteCells(OutputCellIterator{ L"ab\x30a2" L"cd", attr }, 0);
+        VERIFY_IS_FALSE(it);
+
+        const auto& charRow = row.GetCharRow();
+        VERIFY_ARE_EQUAL(std::wstring_view{ L"a" }, std::wstring_view(charRow.GlyphAt(0)));
+        VERIFY_ARE_EQUAL(std::wstring_view{ L"b" }, std::wstring_view(charRow.GlyphAt(1)));
+        VERIFY_IS_TRUE(charRow.DbcsAttrAt(2).IsLeading());
+        VERIFY_IS_TRUE(charRow.DbcsAttrAt(3).IsTrailing());
+        VERIFY_ARE_EQUAL(std::wstring_view{ L"c" }, std::wstring_view(charRow.GlyphAt(4)));
+        VERIFY_ARE_EQUAL(std::wstring_view{ L"d" }, std::wstring_view(charRow.GlyphAt(5)));
+        VERIFY_IS_TRUE(charRow.DbcsAttrAt(5).IsSingle());
+
+        for (uint16_t i = 0; i < 6; ++i)
+        {
+            VERIFY_ARE_EQUAL(attr, row.GetAttrRow().GetAttrByColumn(i));
+        }
+        VERIFY_ARE_EQUAL(TextAttribute{ 0x7 }, row.GetAttrRow().GetAttrByColumn(6));
+    }
+
+    TEST_METHOD(WriteNarrowRunTextOnlyKeepsAttributes)
+    {
+        auto& row = _buffer->GetRowByOffset(0);
+        const TextAttribute attr{ FOREGROUND_BLUE };
+        row.GetAttrRow().Replace(2, 4, attr);
+
+        const auto it = row.WriteCells(OutputCellIterator{ std::wstring_view{ L"abcdef" } }, 0);
+        VERIFY_IS_FALSE(it);
+
+        VERIFY_ARE_EQUAL(std::wstring{ L"abcdef" }, row.GetText().substr(0, 6));
+        VERIFY_ARE_EQUAL(TextAttribute{ 0x7 }, row.GetAttrRow().GetAttrByColumn(1));
+        VERIFY_ARE_EQUAL(attr, row.GetAttrRow().GetAttrByColumn(2));
+        VERIFY_ARE_EQUAL(attr, row.GetAttrRow().GetAttrByColumn(3));
+        VERIFY_ARE_EQUAL(TextAttribute{ 0x7 }, row.GetAttrRow().GetAttrByColumn(4));
+    }
+
+    TEST_METHOD(WriteNarrowRunStopsAtRowEnd)
+    {
+        auto& row = _buffer->GetRowByOffset(0);
+        const std::wstring text(200, L'x');
+
+        auto it = row.WriteCells(OutputCellIterator{ text, TextAttribute{ 0x7 } }, 100, true);
+        VERIFY_IS_TRUE(it);
+        VERIFY_IS_TRUE(row.WasWrapForced());
+
+        // The iterator must have advanced by exactly the number of cells written.
+        const OutputCellIterator start{ text, TextAttribute{ 0x7 } };
+        VERIFY_ARE_EQUAL(20, it.GetCellDistance(start));
+        VERIFY_ARE_EQUAL(20, it.GetInputDistance(start));
+
+        // ... and be usable to continue writing on the next row.
+        it = _buffer->GetRowByOffset(1).WriteCells(it, 0, true);
+        VERIFY_IS_TRUE(it);
+        VERIFY_ARE_EQUAL(140, it.GetCellDistance(start));
+    }
+
+    TEST_METHOD(WriteNarrowCellsBenchmark)
+    {
+        BEGIN_TEST_METHOD_PROPERTIES()
+            TEST_METHOD_PROPERTY(L"IsPerfTest", L"true")
+        END_TEST_METHOD_PROPERTIES()
+
+        // Print 10M narrow characters in a single attribute, a full row at a
+        // time, which is what a long build log looks like by the time it gets here.
+        constexpr size_t totalChars = 10'000'000;
+        const auto width = _buffer->GetSize().Width();
+        const auto height = _buffer->GetSize().Height();
+        const TextAttribute attr{ FOREGROUND_GREEN | FOREGROUND_INTENSITY };
+
+        std::wstring line;
+        line.reserve(width);
+        for (auto i = 0; i < width; ++i)
+        {
+            line.push_back(static_cast<wchar_t>(L'!' + (i % 94)));
+        }
+
+        size_t written = 0;
+        size_t rowIndex = 0;
+        const auto start = std::chrono::steady_clock::now();
+
+        while (written < totalChars)
+        {
+            const auto count = std::min<size_t>(line.size(), totalChars - written);
+            const std::wstring_view text{ line.data(), count };
+            _buffer->GetRowByOffset(rowIndex).WriteCells(OutputCellIterator{ text, attr }, 0, true);
+            written += count;
+            rowIndex = (rowIndex + 1) % height;
+        }
+
+        const auto delta = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+        Log::Comment(String().Format(L"Wrote %zu characters in %lld ms (%.2f Mchars/s)",
+                                     written,
+                                     delta,
+                                     delta ? static_cast<double>(written) / 1000.0 / delta : 0.0));
+
+        VERIFY_ARE_EQUAL(line, _buffer->GetRowByOffset(0).GetText());
+        VERIFY_ARE_EQUAL(attr, _buffer->GetRowByOffset(0).GetAttrRow().GetAttrByColumn(0));
+    }
+
+    TEST_METHOD(WriteCharInfosMatchesWriteCells)
+    {
+        // A few runs of colors with the lead/trail flags sprinkled in, which mustn't split a run.
+        std::vector<CHAR_INFO> cells;
+        for (wchar_t ch = L'a'; ch <= L'z'; ++ch)
+        {
+            CHAR_INFO charInfo{};
+            charInfo.Char.UnicodeChar = ch;
+            charInfo.Attributes = ch < L'k' ? FOREGROUND_RED : ch < L't' ? BACKGROUND_GREEN | COMMON_LVB_UNDERSCORE : FOREGROUND_BLUE;
+            cells.push_back(charInfo);
+        }
+        cells.at(3).Char.UnicodeChar = L'\x30a2';
+        cells.at(3).Attributes |= COMMON_LVB_LEADING_BYTE;
+        cells.at(4).Char.UnicodeChar = L'\x30a2';
+        cells.at(4).Attributes |= COMMON_LVB_TRAILING_BYTE;
+
+        auto& expected = _buffer->GetRowByOffset(0);
+        auto& actual = _buffer->GetRowByOffset(1);
+        expected.WriteCells(OutputCellIterator{ gsl::span<const CHAR_INFO>{ cells } }, 7);
+        VERIFY_IS_TRUE(actual.WriteCharInfos(7, cells));
+
+        for (size_t i = 0; i < expected.size(); ++i)
+        {
+            const auto column = gsl::narrow<uint16_t>(i);
+            VERIFY_ARE_EQUAL(std::wstring_view(expected.GetCharRow().GlyphAt(i)), std::wstring_view(actual.GetCharRow().GlyphAt(i)));
+            VERIFY_ARE_EQUAL(expected.GetCharRow().DbcsAttrAt(i).GeneratePublicApiAttributeFormat(), actual.GetCharRow().DbcsAttrAt(i).GeneratePublicApiAttributeFormat());
+            VERIFY_ARE_EQUAL(expected.GetAttrRow().GetAttrByColumn(column), actual.GetAttrRow().GetAttrByColumn(column));
+        }
+
+        // Reading the cells back has to produce exactly what was written.
+        std::vector<CHAR_INFO> read(cells.size());
+        actual.ReadCharInfos(7, read);
+        for (size_t i = 0; i < cells.size(); ++i)
+        {
+            VERIFY_ARE_EQUAL(cells.at(i).Char.UnicodeChar, read.at(i).Char.UnicodeChar);
+            VERIFY_ARE_EQUAL(cells.at(i).Attributes, read.at(i).Attributes);
+        }
+    }
+
+    TEST_METHOD(WriteCharInfosLeavesPaddingToWriteCells)
+    {
+        auto& row = _buffer->GetRowByOffset(0);
+        const auto width = row.size();
+
+        CHAR_INFO trailing{};
+        trailing.Char.UnicodeChar = L'\x30a2';
+        trailing.Attributes = FOREGROUND_RED | COMMON_LVB_TRAILING_BYTE;
+        CHAR_INFO leading{};
+        leading.Char.UnicodeChar = L'\x30a2';
+        leading.Attributes = FOREGROUND_RED | COMMON_LVB_LEADING_BYTE;
+
+        // A trailing half in the first column or a leading half in the last column would need padding.
+        VERIFY_IS_FALSE(row.WriteCharInfos(0, { &trailing, 1 }));
+        VERIFY_IS_FALSE(row.WriteCharInfos(width - 1, { &leading, 1 }));
+        VERIFY_ARE_EQUAL(TextAttribute{ 0x7 }, row.GetAttrRow().GetAttrByColumn(0));
+        VERIFY_ARE_EQUAL(TextAttribute{ 0x7 }, row.GetAttrRow().GetAttrByColumn(gsl::narrow<uint16_t>(width - 1)));
+
+        // Anywhere else they're written as they are.
+        VERIFY_IS_TRUE(row.WriteCharInfos(1, { &trailing, 1 }));
+        VERIFY_IS_TRUE(row.WriteCharInfos(width - 2, { &leading, 1 }));
+        VERIFY_IS_TRUE(row.GetCharRow().DbcsAttrAt(1).IsTrailing());
+        VERIFY_IS_TRUE(row.GetCharRow().DbcsAttrAt(width - 2).IsLeading());
+
+        // Filling the last column sets the wrap flag if asked to, just like WriteCells.
+        CHAR_INFO single{};
+        single.Char.UnicodeChar = L'x';
+        single.Attributes = FOREGROUND_GREEN;
+        VERIFY_IS_TRUE(row.WriteCharInfos(width - 1, { &single, 1 }, true));
+        VERIFY_IS_TRUE(row.WasWrapForced());
+    }
+
+    TEST_METHOD(CharInfoRectRoundTripBenchmark)
+    {
+        BEGIN_TEST_METHOD_PROPERTIES()
+            TEST_METHOD_PROPERTY(L"IsPerfTest", L"true")
+        END_TEST_METHOD_PROPERTIES()
+
+        // Read and write back a 200x60 rectangle of CHAR_INFOs 10k times, which is
+        // what a full screen legacy console app does with ReadConsoleOutput and
+        // WriteConsoleOutput every frame.
+        constexpr SHORT width = 200;
+        constexpr SHORT height = 60;
+        constexpr size_t iterations = 10'000;
+        TextBuffer buffer{ COORD{ width, height }, TextAttribute{ 0x7 }, 0, _renderTarget };
+
+        std::vector<CHAR_INFO> frame(width * height);
+        for (size_t i = 0; i < frame.size(); ++i)
+        {
+            frame.at(i).Char.UnicodeChar = static_cast<wchar_t>(L'!' + (i % 94));
+            frame.at(i).Attributes = static_cast<WORD>((i / 16) % 4 == 0 ? BACKGROUND_BLUE | FOREGROUND_INTENSITY : BACKGROUND_BLUE | 0x7);
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+
+        for (size_t iteration = 0; iteration < iterations; ++iteration)
+        {
+            for (SHORT y = 0; y < height; ++y)
+            {
+                const auto line = gsl::span<CHAR_INFO>{ frame }.subspan(y * width, width);
+                buffer.WriteCharInfos({ 0, y }, line, false);
+                buffer.ReadCharInfos({ 0, y }, line);
+            }
+        }
+
+        const auto delta = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+        Log::Comment(String().Format(L"Round-tripped %zu %dx%d rectangles in %lld ms (%.2f us per rectangle)",
+                                     iterations,
+                                     width,
+                                     height,
+                                     delta,
+                                     delta * 1000.0 / iterations));
+
+        VERIFY_ARE_EQUAL(L'!', frame.at(0).Char.UnicodeChar);
+        VERIFY_ARE_EQUAL(static_cast<WORD>(BACKGROUND_BLUE | FOREGROUND_INTENSITY), frame.at(0).Attributes);
+    }
+
+private:
+    DummyRenderTarget _renderTarget;
+    std::unique_ptr<TextBuffer> _buffer;
+};
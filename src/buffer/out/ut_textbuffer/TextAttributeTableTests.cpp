@@ -0,0 +1,93 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+#include "WexTestClass.h"
+#include "../../inc/consoletaeftemplates.hpp"
+
+#include "../TextAttributeTable.hpp"
+
+using namespace WEX::Common;
+using namespace WEX::Logging;
+using namespace WEX::TestExecution;
+
+class TextAttributeTableTests
+{
+    TEST_CLASS(TextAttributeTableTests);
+
+    TEST_METHOD(DefaultAttributeIsIdZero)
+    {
+        TextAttributeTable table;
+        VERIFY_ARE_EQUAL(1u, table.size());
+        VERIFY_ARE_EQUAL(TextAttributeId{ 0 }, table.Intern(TextAttribute{}));
+        VERIFY_ARE_EQUAL(TextAttribute{}, table.Get(0));
+    }
+
+    TEST_METHOD(EqualAttributesShareAnId)
+    {
+        TextAttributeTable table;
+
+        TextAttribute red{ FOREGROUND_RED };
+        TextAttribute rgb{ RGB(1, 2, 3), RGB(4, 5, 6) };
+        TextAttribute link{ FOREGROUND_RED };
+        link.SetHyperlinkId(42);
+
+        const auto redId = table.Intern(red);
+        const auto rgbId = table.Intern(rgb);
+        const auto linkId = table.Intern(link);
+
+        VERIFY_ARE_NOT_EQUAL(redId, rgbId);
+        VERIFY_ARE_NOT_EQUAL(redId, linkId);
+        VERIFY_ARE_EQUAL(redId, table.Intern(TextAttribute{ FOREGROUND_RED }));
+        VERIFY_ARE_EQUAL(rgbId, table.Intern(TextAttribute{ RGB(1, 2, 3), RGB(4, 5, 6) }));
+
+        VERIFY_ARE_EQUAL(red, table.Get(redId));
+        VERIFY_ARE_EQUAL(rgb, table.Get(rgbId));
+        VERIFY_ARE_EQUAL(link, table.Get(linkId));
+        VERIFY_ARE_EQUAL(4u, table.size());
+    }
+
+    TEST_METHOD(FindDoesNotIntern)
+    {
+        TextAttributeTable table;
+        VERIFY_IS_FALSE(table.Find(TextAttribute{ FOREGROUND_BLUE }).has_value());
+        VERIFY_ARE_EQUAL(1u, table.size());
+
+        const auto id = table.Intern(TextAttribute{ FOREGROUND_BLUE });
+        VERIFY_ARE_EQUAL(id, table.Find(TextAttribute{ FOREGROUND_BLUE }).value());
+    }
+
+    TEST_METHOD(CompactsWhenFull)
+    {
+        TextAttributeTable table;
+
+        // Pretend only this attribute is still referenced by a row.
+        const TextAttribute keep{ RGB(255, 0, 0), RGB(0, 0, 0) };
+        const auto keepId = table.Intern(keep);
+
+        std::vector<TextAttributeId> remap;
+        table.SetCompactCallback([&](TextAttributeTable& t) {
+            std::vector<bool> used(t.size());
+            used[keepId] = true;
+            remap = t.Compact(used);
+        });
+
+        for (size_t i = table.size(); i < TextAttributeTable::MaxSize; ++i)
+        {
+            table.Intern(TextAttribute{ gsl::narrow_cast<COLORREF>(i), RGB(1, 1, 1) });
+        }
+        VERIFY_ARE_EQUAL(TextAttributeTable::MaxSize, table.size());
+        VERIFY_IS_TRUE(remap.empty());
+
+        // The next new attribute doesn't fit and forces a compaction.
+        const TextAttribute overflow{ RGB(0, 255, 0), RGB(0, 0, 255) };
+        const auto overflowId = table.Intern(overflow);
+
+        VERIFY_ARE_EQUAL(TextAttributeTable::MaxSize, remap.size());
+        VERIFY_ARE_EQUAL(3u, table.size());
+        VERIFY_ARE_EQUAL(TextAttributeId{ 1 }, remap[keepId]);
+        VERIFY_ARE_EQUAL(keep, table.Get(remap[keepId]));
+        VERIFY_ARE_EQUAL(overflow, table.Get(overflowId));
+        VERIFY_ARE_EQUAL(TextAttribute{}, table.Get(0));
+    }
+};
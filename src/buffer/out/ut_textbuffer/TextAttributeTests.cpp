@@ -6,6 +6,7 @@
 #include "../../inc/consoletaeftemplates.hpp"
 
 #include "../TextAttribute.hpp"
+#include "../TextAttributeColorCache.hpp"
 
 using namespace WEX::Common;
 using namespace WEX::Logging;
@@ -22,6 +23,8 @@ class TextAttributeTests
     TEST_METHOD(TestTextAttributeColorGetters);
     TEST_METHOD(TestReverseDefaultColors);
     TEST_METHOD(TestRoundtripDefaultColors);
+    TEST_METHOD(TestColorCacheMatchesCalculatedColors);
+    TEST_METHOD(TestColorCacheInvalidation);
 
     std::array<COLORREF, 256> _colorTable;
     COLORREF _defaultFg = RGB(1, 2, 3);
@@ -263,3 +266,69 @@ void TextAttributeTests::TestRoundtripDefaultColors()
     // Reset the legacy default colors to white on black.
     TextAttribute::SetLegacyDefaultAttributes(FOREGROUND_RED | FOREGROUND_GREEN | FOREGROUND_BLUE);
 }
+
+void TextAttributeTests::TestColorCacheMatchesCalculatedColors()
+{
+    TextAttributeColorCache cache;
+    const auto generation = TextAttributeColorCache::NextColorTableGeneration();
+
+    TextAttribute indexed{ FOREGROUND_RED | BACKGROUND_BLUE };
+    TextAttribute rgb{ RGB(1, 2, 3), RGB(4, 5, 6) };
+    TextAttribute reversed{ FOREGROUND_GREEN };
+    reversed.SetReverseVideo(true);
+    TextAttribute blinking{};
+    blinking.SetBlinking(true);
+
+    for (const auto& attr : { TextAttribute{}, indexed, rgb, reversed, blinking })
+    {
+        const auto expected = attr.CalculateRgbColors(_colorTable, _defaultFg, _defaultBg);
+        // Resolve twice: once to fill the cache and once to hit it.
+        VERIFY_ARE_EQUAL(expected, cache.Resolve(attr, _colorTable, generation, _defaultFg, _defaultBg));
+        VERIFY_ARE_EQUAL(expected, cache.Resolve(attr, _colorTable, generation, _defaultFg, _defaultBg));
+    }
+    VERIFY_ARE_EQUAL(5u, cache.size());
+
+    const auto expectedFaint = blinking.CalculateRgbColors(_colorTable, _defaultFg, _defaultBg, false, true);
+    VERIFY_ARE_EQUAL(expectedFaint, cache.Resolve(blinking, _colorTable, generation, _defaultFg, _defaultBg, false, true));
+
+    const auto expectedReverse = indexed.CalculateRgbColors(_colorTable, _defaultFg, _defaultBg, true);
+    VERIFY_ARE_EQUAL(expectedReverse, cache.Resolve(indexed, _colorTable, generation, _defaultFg, _defaultBg, true));
+}
+
+void TextAttributeTests::TestColorCacheInvalidation()
+{
+    TextAttributeColorCache cache;
+    auto colorTable = _colorTable;
+    auto generation = TextAttributeColorCache::NextColorTableGeneration();
+    const TextAttribute attr{ FOREGROUND_RED | BACKGROUND_BLUE };
+
+    Log::Comment(L"Resolving with the same inputs should reuse the cached entry.");
+    cache.Resolve(attr, colorTable, generation, _defaultFg, _defaultBg);
+    cache.Resolve(TextAttribute{}, colorTable, generation, _defaultFg, _defaultBg);
+    VERIFY_ARE_EQUAL(2u, cache.size());
+
+    Log::Comment(L"A new color table generation should drop all cached colors.");
+    colorTable[4] = RGB(255, 0, 0);
+    generation = TextAttributeColorCache::NextColorTableGeneration();
+    VERIFY_ARE_EQUAL(RGB(255, 0, 0), cache.Resolve(attr, colorTable, generation, _defaultFg, _defaultBg).first);
+    VERIFY_ARE_EQUAL(1u, cache.size());
+
+    Log::Comment(L"New default colors should drop all cached colors.");
+    cache.Resolve(TextAttribute{}, colorTable, generation, _defaultFg, _defaultBg);
+    VERIFY_ARE_EQUAL(2u, cache.size());
+    const auto colors = cache.Resolve(TextAttribute{}, colorTable, generation, _defaultBg, _defaultFg);
+    VERIFY_ARE_EQUAL(std::make_pair(_defaultBg, _defaultFg), colors);
+    VERIFY_ARE_EQUAL(1u, cache.size());
+
+    Log::Comment(L"Toggling the reverse screen mode or the blink state should drop all cached colors.");
+    cache.Resolve(attr, colorTable, generation, _defaultBg, _defaultFg);
+    VERIFY_ARE_EQUAL(2u, cache.size());
+    cache.Resolve(attr, colorTable, generation, _defaultBg, _defaultFg, true);
+    VERIFY_ARE_EQUAL(1u, cache.size());
+    cache.Resolve(attr, colorTable, generation, _defaultBg, _defaultFg, true, true);
+    VERIFY_ARE_EQUAL(1u, cache.size());
+
+    Log::Comment(L"Invalidate() should drop all cached colors.");
+    cache.Invalidate();
+    VERIFY_ARE_EQUAL(0u, cache.size());
+}
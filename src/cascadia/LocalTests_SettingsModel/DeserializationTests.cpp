@@ -51,6 +51,8 @@ namespace SettingsModelLocalTests
         TEST_METHOD(TestReorderingWithoutGuid);
         TEST_METHOD(TestLayeringNameOnlyProfiles);
         TEST_METHOD(TestExplodingNameOnlyProfiles);
+        TEST_METHOD(TestUserSettingsStayInSyncWithoutReparse);
+        TEST_METHOD(TestDefaultSettingsSnapshot);
         TEST_METHOD(TestHideAllProfiles);
         TEST_METHOD(TestInvalidColorSchemeName);
         TEST_METHOD(TestHelperFunctions);
@@ -91,6 +93,8 @@ namespace SettingsModelLocalTests
 
         TEST_METHOD(TestInheritedCommand);
 
+        TEST_METHOD(TestChangedProfiles);
+
         TEST_CLASS_SETUP(ClassSetup)
         {
             InitializeJsonReader();
@@ -1207,6 +1211,59 @@ namespace SettingsModelLocalTests
         VERIFY_ARE_EQUAL(L"Command Prompt", settings->_allProfiles.GetAt(4).Name());
     }
 
+    void DeserializationTests::TestUserSettingsStayInSyncWithoutReparse()
+    {
+        // When we add dynamic profiles and the $schema to the user's settings
+        // string, we make the same changes to the parsed settings instead of
+        // parsing the string again. Make sure both end up the same.
+
+        const std::string settings0String{ R"(
+        {
+            "defaultProfile" : "{6239a42c-1111-49a3-80bd-e8fdd045185c}",
+            "profiles": {
+                "list": [
+                    {
+                        "guid" : "{6239a42c-1111-49a3-80bd-e8fdd045185c}",
+                        "name" : "profile0"
+                    }
+                ]
+            }
+        })" };
+
+        auto settings = winrt::make_self<implementation::CascadiaSettings>(false);
+        settings->_ParseJsonString(DefaultJson, true);
+        settings->LayerJson(settings->_defaultSettings);
+
+        auto dynamicProfile = winrt::make_self<implementation::Profile>();
+        dynamicProfile->Name(L"dynamicProfile");
+        dynamicProfile->Source(L"Terminal.App.UnitTest.0");
+        settings->_allProfiles.Append(*dynamicProfile);
+
+        settings->_ParseJsonString(settings0String, false);
+        settings->LayerJson(settings->_userSettings);
+
+        VERIFY_IS_TRUE(settings->_AppendDynamicProfilesToUserSettings());
+        VERIFY_IS_TRUE(settings->_PrependSchemaDirective());
+
+        const auto reparsed = VerifyParseSucceeded(settings->_userSettingsString);
+        VERIFY_ARE_EQUAL(reparsed, settings->_userSettings);
+
+        const auto& profilesList = settings->_userSettings["profiles"]["list"];
+        VERIFY_ARE_EQUAL(2u, profilesList.size());
+        VERIFY_ARE_EQUAL(L"dynamicProfile", winrt::to_hstring(profilesList[1]["name"].asString()));
+        VERIFY_IS_TRUE(settings->_userSettings.isMember("$schema"));
+    }
+
+    void DeserializationTests::TestDefaultSettingsSnapshot()
+    {
+        // The defaults are loaded from a snapshot of defaults.json generated at
+        // build time, instead of being parsed. It must hold the exact same values.
+        const auto parsed = implementation::CascadiaSettings::_ParseUtf8JsonString(DefaultJson);
+        const auto& snapshot = implementation::CascadiaSettings::_DefaultSettingsJson();
+        VERIFY_IS_TRUE(snapshot.isObject());
+        VERIFY_ARE_EQUAL(parsed, snapshot);
+    }
+
     void DeserializationTests::TestHideAllProfiles()
     {
         const std::string settingsWithProfiles{ R"(
@@ -2918,4 +2975,61 @@ namespace SettingsModelLocalTests
             VERIFY_IS_NULL(actualKeyChord);
         }
     }
+
+    void DeserializationTests::TestChangedProfiles()
+    {
+        const auto makeSettings = [](const int fontSize, const std::string_view foreground, const bool copyOnSelect, const std::string_view keys, const std::string_view extraProfile) {
+            const auto json = fmt::format(R"({{
+                "defaultProfile": "{{6239a42c-0000-49a3-80bd-e8fdd045185c}}",
+                "copyOnSelect": {},
+                "actions": [ {{ "command": "copy", "keys": "{}" }} ],
+                "schemes": [
+                    {{ "name": "Scheme0", "foreground": "#111111", "background": "#000000" }},
+                    {{ "name": "Scheme1", "foreground": "{}", "background": "#000000" }}
+                ],
+                "profiles": [
+                    {{ "guid": "{{6239a42c-0000-49a3-80bd-e8fdd045185c}}", "name": "profile0", "colorScheme": "Scheme0", "fontSize": {} }},
+                    {{ "guid": "{{6239a42c-1111-49a3-80bd-e8fdd045185c}}", "name": "profile1", "colorScheme": "Scheme1" }},
+                    {{ "guid": "{{6239a42c-2222-49a3-80bd-e8fdd045185c}}", "name": "profile2", "colorScheme": "Scheme1", "fontSize": 14 }}
+                    {}
+                ]
+            }})",
+                                          copyOnSelect,
+                                          keys,
+                                          foreground,
+                                          fontSize,
+                                          extraProfile);
+            return *winrt::make_self<implementation::CascadiaSettings>(winrt::to_hstring(json));
+        };
+        const auto changedProfiles = [](const CascadiaSettings& settings, const CascadiaSettings& previous) {
+            std::vector<std::wstring> names;
+            for (const auto& guid : settings.ChangedProfiles(previous))
+            {
+                names.emplace_back(settings.FindProfile(guid).Name());
+            }
+            std::sort(names.begin(), names.end());
+            return names;
+        };
+
+        const auto previous = makeSettings(12, "#222222", false, "ctrl+c", "");
+
+        Log::Comment(L"Loading the same settings again doesn't change any profile");
+        VERIFY_IS_TRUE(changedProfiles(makeSettings(12, "#222222", false, "ctrl+c", ""), previous).empty());
+
+        Log::Comment(L"Changing a profile only changes that profile");
+        VERIFY_IS_TRUE((changedProfiles(makeSettings(13, "#222222", false, "ctrl+c", ""), previous) == std::vector<std::wstring>{ L"profile0" }));
+
+        Log::Comment(L"Changing a color scheme changes all profiles using it");
+        VERIFY_IS_TRUE((changedProfiles(makeSettings(12, "#333333", false, "ctrl+c", ""), previous) == std::vector<std::wstring>{ L"profile1", L"profile2" }));
+
+        Log::Comment(L"Changing a key binding doesn't change any profile");
+        VERIFY_IS_TRUE(changedProfiles(makeSettings(12, "#222222", false, "ctrl+shift+c", ""), previous).empty());
+
+        Log::Comment(L"Changing a global setting that ends up in every profile's settings changes all profiles");
+        VERIFY_IS_TRUE((changedProfiles(makeSettings(12, "#222222", true, "ctrl+c", ""), previous) == std::vector<std::wstring>{ L"profile0", L"profile1", L"profile2" }));
+
+        Log::Comment(L"New profiles are changed profiles");
+        const auto extraProfile{ R"(, { "guid": "{6239a42c-3333-49a3-80bd-e8fdd045185c}", "name": "profile3" })" };
+        VERIFY_IS_TRUE((changedProfiles(makeSettings(12, "#222222", false, "ctrl+c", extraProfile), previous) == std::vector<std::wstring>{ L"profile3" }));
+    }
 }
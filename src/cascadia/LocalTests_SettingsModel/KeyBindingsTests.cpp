@@ -55,11 +55,19 @@ namespace SettingsModelLocalTests
 
         TEST_METHOD(TestGetKeyBindingForAction);
 
+        BEGIN_TEST_METHOD(TestLayeredKeyChordLookup)
+            TEST_METHOD_PROPERTY(L"Data:layerCount", L"{1, 4, 16}")
+        END_TEST_METHOD()
+        TEST_METHOD(TestKeyChordLookupAfterParentChanges);
+
         TEST_CLASS_SETUP(ClassSetup)
         {
             InitializeJsonReader();
             return true;
         }
+
+    private:
+        static std::optional<Command> _LookupKeyChordInLayers(implementation::ActionMap& actionMap, const KeyChord& keys);
     };
 
     void KeyBindingsTests::KeyChords()
@@ -747,4 +755,182 @@ namespace SettingsModelLocalTests
             VerifyKeyChordEquality({ VirtualKeyModifiers::Control | VirtualKeyModifiers::Shift, static_cast<int32_t>('P'), 0 }, kbd);
         }
     }
+    // Resolves the given key chord the slow way, by searching each layer of
+    // the action map, starting with the most specific one.
+    std::optional<Command> KeyBindingsTests::_LookupKeyChordInLayers(implementation::ActionMap& actionMap, const KeyChord& keys)
+    {
+        if (const auto it = actionMap._KeyMap.find(keys); it != actionMap._KeyMap.end())
+        {
+            return actionMap._GetActionByID(it->second);
+        }
+        for (const auto& parent : actionMap.Parents())
+        {
+            if (const auto cmd = _LookupKeyChordInLayers(*parent, keys))
+            {
+                return cmd;
+            }
+        }
+        return std::nullopt;
+    }
+
+    void KeyBindingsTests::TestLayeredKeyChordLookup()
+    {
+        int layerCount;
+        VERIFY_SUCCEEDED(TestData::TryGetValue(L"layerCount", layerCount));
+
+        static constexpr std::array modifiers{ "", "ctrl+", "alt+", "shift+", "ctrl+alt+", "ctrl+shift+", "alt+shift+", "ctrl+alt+shift+" };
+        std::vector<std::string> keys;
+        for (auto c = 'a'; c <= 'z'; ++c)
+        {
+            keys.emplace_back(1, c);
+        }
+        for (auto i = 1; i <= 24; ++i)
+        {
+            keys.emplace_back(fmt::format("f{}", i));
+        }
+
+        // The base layer binds every combination of modifiers and keys, except for the
+        // function keys above f12, which stay unbound. Every other layer rebinds some
+        // of these, and unbinds others.
+        static constexpr size_t boundKeyCount = 26 + 12;
+        std::vector<winrt::com_ptr<implementation::ActionMap>> layers;
+        std::vector<KeyChord> chords;
+        for (auto layer = 0; layer < layerCount; ++layer)
+        {
+            std::string json{ "[" };
+            auto binding = 0;
+            for (const auto& mods : modifiers)
+            {
+                for (size_t key = 0; key < keys.size(); ++key)
+                {
+                    const auto index = binding++;
+                    const auto chord = fmt::format("{}{}", mods, til::at(keys, key));
+                    if (layer == 0)
+                    {
+                        chords.emplace_back(KeyChordSerialization::FromString(winrt::to_hstring(chord)));
+                    }
+
+                    if (key >= boundKeyCount)
+                    {
+                        continue;
+                    }
+                    if (layer == 0 || index % (layer + 2) == 0)
+                    {
+                        fmt::format_to(std::back_inserter(json), R"({{ "command": {{ "action": "sendInput", "input": "{}/{}" }}, "keys": "{}" }},)", layer, index, chord);
+                    }
+                    else if (index % (layer + 3) == 0)
+                    {
+                        fmt::format_to(std::back_inserter(json), R"({{ "command": "unbound", "keys": "{}" }},)", chord);
+                    }
+                }
+            }
+            json.back() = ']';
+
+            auto actionMap = winrt::make_self<implementation::ActionMap>();
+            if (!layers.empty())
+            {
+                actionMap->InsertParent(layers.back());
+            }
+            actionMap->LayerJson(VerifyParseSucceeded(json));
+            layers.emplace_back(std::move(actionMap));
+        }
+
+        auto& actionMap = *layers.back();
+
+        Log::Comment(L"Verify that the lookup resolves every key chord like searching the layers does");
+        for (const auto& chord : chords)
+        {
+            VERIFY_IS_TRUE(_LookupKeyChordInLayers(actionMap, chord) == actionMap._GetActionByKeyChordInternal(chord));
+        }
+
+        Log::Comment(L"Verify that the lookup is rebuilt after adding an action");
+        const auto& keyA{ chords.front() };
+        actionMap.LayerJson(VerifyParseSucceeded(R"([ { "command": "unbound", "keys": "a" } ])"));
+        VERIFY_IS_TRUE(actionMap.IsKeyChordExplicitlyUnbound(keyA));
+        actionMap.LayerJson(VerifyParseSucceeded(R"([ { "command": "copy", "keys": "a" } ])"));
+        VERIFY_IS_FALSE(actionMap.IsKeyChordExplicitlyUnbound(keyA));
+        VERIFY_ARE_EQUAL(ShortcutAction::CopyText, actionMap.GetActionByKeyChord(keyA).ActionAndArgs().Action());
+
+        // Measure the cost of resolving every key chord, the slow way and with the lookup.
+        using clock = std::chrono::steady_clock;
+        using duration = std::chrono::duration<double, std::nano>;
+        constexpr auto iterations = 100;
+
+        actionMap.BuildKeyChordLookup();
+        size_t found = 0;
+        const auto start = clock::now();
+        for (auto i = 0; i < iterations; ++i)
+        {
+            for (const auto& chord : chords)
+            {
+                found += _LookupKeyChordInLayers(actionMap, chord).has_value();
+            }
+        }
+        const auto walked = clock::now();
+        for (auto i = 0; i < iterations; ++i)
+        {
+            for (const auto& chord : chords)
+            {
+                found -= actionMap._GetActionByKeyChordInternal(chord).has_value();
+            }
+        }
+        const auto looked = clock::now();
+        VERIFY_IS_TRUE(found == 0);
+
+        const auto lookups = static_cast<double>(iterations * chords.size());
+        Log::Comment(fmt::format(L"{} layers, {} key chords: searching the layers {:.1f}ns per lookup, flattened lookup {:.1f}ns per lookup",
+                                 layerCount,
+                                 chords.size(),
+                                 duration{ walked - start }.count() / lookups,
+                                 duration{ looked - walked }.count() / lookups)
+                         .c_str());
+    }
+
+    void KeyBindingsTests::TestKeyChordLookupAfterParentChanges()
+    {
+        const auto copyChord{ KeyChordSerialization::FromString(L"ctrl+c") };
+        const auto pasteChord{ KeyChordSerialization::FromString(L"ctrl+v") };
+
+        const auto verifyAction = [](const implementation::ActionMap& actionMap, const KeyChord& chord, const std::optional<ShortcutAction> expected) {
+            const auto cmd{ actionMap.GetActionByKeyChord(chord) };
+            if (!expected)
+            {
+                VERIFY_IS_NULL(cmd);
+                return;
+            }
+            VERIFY_IS_NOT_NULL(cmd);
+            VERIFY_ARE_EQUAL(*expected, cmd.ActionAndArgs().Action());
+        };
+
+        auto parent = winrt::make_self<implementation::ActionMap>();
+        parent->LayerJson(VerifyParseSucceeded(R"([ { "command": "copy", "keys": "ctrl+c" } ])"));
+        auto child = winrt::make_self<implementation::ActionMap>();
+        child->InsertParent(parent);
+        child->BuildKeyChordLookup();
+        verifyAction(*child, copyChord, ShortcutAction::CopyText);
+        verifyAction(*child, pasteChord, std::nullopt);
+
+        Log::Comment(L"Adding an action to the parent must be visible through the child");
+        parent->LayerJson(VerifyParseSucceeded(R"([ { "command": "paste", "keys": "ctrl+v" } ])"));
+        verifyAction(*child, pasteChord, ShortcutAction::PasteText);
+
+        Log::Comment(L"Removing the parent must drop its bindings from the child");
+        child->ClearParents();
+        verifyAction(*child, copyChord, std::nullopt);
+        verifyAction(*child, pasteChord, std::nullopt);
+
+        Log::Comment(L"Inserting a different parent must expose its bindings instead");
+        auto otherParent = winrt::make_self<implementation::ActionMap>();
+        otherParent->LayerJson(VerifyParseSucceeded(R"([ { "command": "find", "keys": "ctrl+c" } ])"));
+        child->InsertParent(otherParent);
+        verifyAction(*child, copyChord, ShortcutAction::Find);
+        verifyAction(*child, pasteChord, std::nullopt);
+
+        Log::Comment(L"Changes further up the chain must be picked up as well");
+        auto grandParent = winrt::make_self<implementation::ActionMap>();
+        otherParent->InsertParent(grandParent);
+        verifyAction(*child, pasteChord, std::nullopt);
+        grandParent->LayerJson(VerifyParseSucceeded(R"([ { "command": "paste", "keys": "ctrl+v" } ])"));
+        verifyAction(*child, pasteChord, ShortcutAction::PasteText);
+    }
 }
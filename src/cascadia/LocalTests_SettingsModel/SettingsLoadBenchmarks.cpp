@@ -0,0 +1,168 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "pch.h"
+
+#include "../TerminalSettingsModel/CascadiaSettings.h"
+#include "JsonTestClass.h"
+
+using namespace Microsoft::Console;
+using namespace WEX::Logging;
+using namespace WEX::TestExecution;
+using namespace WEX::Common;
+using namespace winrt::Microsoft::Terminal::Settings::Model;
+
+namespace SettingsModelLocalTests
+{
+    // Measures how long it takes to load settings files with many profiles and
+    // color schemes, like the ones deployed with hundreds of fragment profiles.
+    // These run like every other test, but also log the time spent in each
+    // phase of the load. Run them on their own with:
+    //   te.exe SettingsModel.LocalTests.dll /name:*SettingsLoadBenchmarks*
+    class SettingsLoadBenchmarks : public JsonTestClass
+    {
+        BEGIN_TEST_CLASS(SettingsLoadBenchmarks)
+            TEST_CLASS_PROPERTY(L"RunAs", L"UAP")
+            TEST_CLASS_PROPERTY(L"UAP:AppXManifest", L"TestHostAppXManifest.xml")
+        END_TEST_CLASS()
+
+        BEGIN_TEST_METHOD(LoadGeneratedSettings)
+            TEST_METHOD_PROPERTY(L"Data:profileCount", L"{10, 100, 1000}")
+        END_TEST_METHOD()
+
+        TEST_CLASS_SETUP(ClassSetup)
+        {
+            InitializeJsonReader();
+            return true;
+        }
+
+    private:
+        static std::string _ProfileGuid(const size_t index)
+        {
+            return fmt::format("{{{:08x}-0000-49a3-80bd-e8fdd045185c}}", index);
+        }
+
+        // Generates a defaults.json with the given number of profiles, and one
+        // color scheme for every 4 profiles.
+        static std::string _GenerateDefaultSettings(const size_t profileCount)
+        {
+            const auto schemeCount = std::max<size_t>(profileCount / 4, 1);
+
+            std::string json;
+            fmt::format_to(std::back_inserter(json), R"({{ "defaultProfile": "{}", "schemes": [)", _ProfileGuid(0));
+            for (size_t i = 0; i < schemeCount; ++i)
+            {
+                fmt::format_to(std::back_inserter(json),
+                               R"({}{{ "name": "Scheme {}", "foreground": "#{:06x}", "background": "#0C0C0C" }})",
+                               i ? "," : "",
+                               i,
+                               i & 0xffffff);
+            }
+            json.append(R"(], "profiles": [)");
+            for (size_t i = 0; i < profileCount; ++i)
+            {
+                fmt::format_to(std::back_inserter(json),
+                               R"({}{{ "guid": "{}", "name": "Profile {}", "commandline": "cmd.exe /k echo {}", "colorScheme": "Scheme {}" }})",
+                               i ? "," : "",
+                               _ProfileGuid(i),
+                               i,
+                               i,
+                               i % schemeCount);
+            }
+            json.append("]}");
+            return json;
+        }
+
+        // Generates a settings.json that layers settings on each of the
+        // generated default profiles and a quarter of the color schemes, and
+        // adds half as many name-only profiles on top of that.
+        static std::string _GenerateUserSettings(const size_t profileCount)
+        {
+            const auto schemeCount = std::max<size_t>(profileCount / 4, 1);
+
+            std::string json{ R"({ "schemes": [)" };
+            for (size_t i = 0; i < schemeCount; i += 4)
+            {
+                fmt::format_to(std::back_inserter(json), R"({}{{ "name": "Scheme {}", "cursorColor": "#FFFFFF" }})", i ? "," : "", i);
+            }
+            json.append(R"(], "profiles": { "defaults": { "fontSize": 11 }, "list": [)");
+            for (size_t i = 0; i < profileCount; ++i)
+            {
+                fmt::format_to(std::back_inserter(json), R"({}{{ "guid": "{}", "tabTitle": "Tab {}" }})", i ? "," : "", _ProfileGuid(i), i);
+            }
+            for (size_t i = 0; i < profileCount / 2; ++i)
+            {
+                fmt::format_to(std::back_inserter(json), R"(,{{ "name": "Extra {}", "commandline": "pwsh.exe" }})", i);
+            }
+            json.append("]}}");
+            return json;
+        }
+    };
+
+    void SettingsLoadBenchmarks::LoadGeneratedSettings()
+    {
+        int profileCount;
+        VERIFY_SUCCEEDED(TestData::TryGetValue(L"profileCount", profileCount));
+
+        const auto count = gsl::narrow<size_t>(profileCount);
+        const auto defaultSettings = _GenerateDefaultSettings(count);
+        const auto userSettings = _GenerateUserSettings(count);
+
+        using clock = std::chrono::steady_clock;
+        using duration = std::chrono::duration<double, std::milli>;
+        constexpr auto iterations = 5;
+
+        // Report the fastest of a few iterations, to filter out noise
+        // like the first iteration paging in code and data.
+        auto bestDefaults = duration::max();
+        auto bestUser = duration::max();
+        auto bestAppend = duration::max();
+        auto bestValidate = duration::max();
+        for (auto iteration = 0; iteration < iterations; ++iteration)
+        {
+            // These are the same phases CascadiaSettings::LoadAll goes through,
+            // minus reading files and running dynamic profile generators.
+            auto settings = winrt::make_self<implementation::CascadiaSettings>(false);
+
+            const auto start = clock::now();
+            settings->_ParseJsonString(defaultSettings, true);
+            settings->LayerJson(settings->_defaultSettings);
+
+            const auto defaultsLoaded = clock::now();
+            settings->_ParseJsonString(userSettings, false);
+            settings->_ApplyDefaultsFromUserSettings();
+            settings->LayerJson(settings->_userSettings);
+
+            const auto userLoaded = clock::now();
+            VERIFY_IS_FALSE(settings->_AppendDynamicProfilesToUserSettings());
+
+            const auto appended = clock::now();
+            settings->_ValidateSettings();
+
+            const auto validated = clock::now();
+            bestDefaults = std::min<duration>(bestDefaults, defaultsLoaded - start);
+            bestUser = std::min<duration>(bestUser, userLoaded - defaultsLoaded);
+            bestAppend = std::min<duration>(bestAppend, appended - userLoaded);
+            bestValidate = std::min<duration>(bestValidate, validated - appended);
+
+            // Make sure we measured what we meant to: every user profile was
+            // layered on its default profile, and the extras were added.
+            VERIFY_ARE_EQUAL(gsl::narrow<uint32_t>(count + count / 2), settings->_allProfiles.Size());
+            const auto last{ settings->_allProfiles.GetAt(gsl::narrow<uint32_t>(count - 1)) };
+            VERIFY_ARE_EQUAL(winrt::to_hstring(fmt::format("Tab {}", count - 1)), last.TabTitle());
+            VERIFY_ARE_EQUAL(11, last.FontInfo().FontSize());
+            VERIFY_ARE_EQUAL(0u, settings->_warnings.Size());
+        }
+
+        const auto total = bestDefaults + bestUser + bestAppend + bestValidate;
+        Log::Comment(fmt::format(L"{} profiles: defaults {:.3f}ms, user settings {:.3f}ms, dynamic profiles {:.3f}ms, validation {:.3f}ms, total {:.3f}ms ({:.1f}us per profile)",
+                                 count,
+                                 bestDefaults.count(),
+                                 bestUser.count(),
+                                 bestAppend.count(),
+                                 bestValidate.count(),
+                                 total.count(),
+                                 total.count() * 1000.0 / (count + count / 2))
+                         .c_str());
+    }
+}
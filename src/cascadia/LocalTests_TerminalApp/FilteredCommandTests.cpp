@@ -26,6 +26,7 @@ namespace TerminalAppLocalTests
         TEST_METHOD(VerifyWeight);
         TEST_METHOD(VerifyCompare);
         TEST_METHOD(VerifyCompareIgnoreCase);
+        TEST_METHOD(VerifyIncrementalFiltering);
     };
 
     void FilteredCommandTests::VerifyHighlighting()
@@ -229,4 +230,42 @@ namespace TerminalAppLocalTests
 
         VERIFY_SUCCEEDED(result);
     }
+
+    void FilteredCommandTests::VerifyIncrementalFiltering()
+    {
+        auto result = RunOnUIThread([]() {
+            static constexpr std::array names{ L"Close all tabs after this", L"Split Pane", L"Close Pane", L"[ | ] Split Vertical", L"Open Settings", L"AAAAAABBBBBBCCC" };
+            static constexpr std::array filters{ L"s", L"sp", L"spl", L"splv", L"spl", L"sp", L"cl", L"clt", L"clts", L"x", L"xs", L"", L"PANE", L"pa", L"ab", L"abc", L"abcd" };
+
+            for (const auto name : names)
+            {
+                const auto paletteItem{ winrt::make<winrt::TerminalApp::implementation::CommandLinePaletteItem>(name) };
+                const auto filteredCommand = winrt::make_self<winrt::TerminalApp::implementation::FilteredCommand>(paletteItem);
+
+                for (const auto filter : filters)
+                {
+                    Log::Comment(NoThrowString().Format(L"Filtering \"%s\" with \"%s\"", name, filter));
+
+                    // The command is updated with each filter in turn, reusing the previous match,
+                    // while the expected results are computed by a fresh command for each filter.
+                    filteredCommand->UpdateFilter(filter);
+
+                    const auto expected = winrt::make_self<winrt::TerminalApp::implementation::FilteredCommand>(paletteItem);
+                    expected->_Filter = filter;
+                    const auto expectedSegments = expected->_computeHighlightedName().Segments();
+                    VERIFY_ARE_EQUAL(expected->_computeWeight(), filteredCommand->Weight());
+
+                    const auto segments = filteredCommand->HighlightedName().Segments();
+                    VERIFY_ARE_EQUAL(expectedSegments.Size(), segments.Size());
+                    for (uint32_t i = 0; i < segments.Size(); i++)
+                    {
+                        VERIFY_ARE_EQUAL(expectedSegments.GetAt(i).TextSegment(), segments.GetAt(i).TextSegment());
+                        VERIFY_ARE_EQUAL(expectedSegments.GetAt(i).IsHighlighted(), segments.GetAt(i).IsHighlighted());
+                    }
+                }
+            }
+        });
+
+        VERIFY_SUCCEEDED(result);
+    }
 }
@@ -870,6 +870,7 @@ namespace winrt::TerminalApp::implementation
     {
         const std::filesystem::path settingsPath{ std::wstring_view{ CascadiaSettings::SettingsPath() } };
         const std::filesystem::path statePath{ std::wstring_view{ ApplicationState::SharedInstance().FilePath() } };
+        const std::filesystem::path dynamicProfileCachePath{ std::wstring_view{ CascadiaSettings::DynamicProfileCachePath() } };
 
         _reader.create(
             settingsPath.parent_path().c_str(),
@@ -879,10 +880,12 @@ namespace winrt::TerminalApp::implementation
             // editors, who will write a temp file, then rename it to be the
             // actual file you wrote. So listen for that too.
             wil::FolderChangeEvents::FileName | wil::FolderChangeEvents::LastWriteTime,
-            [this, settingsBasename = settingsPath.filename(), stateBasename = statePath.filename()](wil::FolderChangeEvent, PCWSTR fileModified) {
+            [this, settingsBasename = settingsPath.filename(), stateBasename = statePath.filename(), dynamicProfileCacheBasename = dynamicProfileCachePath.filename()](wil::FolderChangeEvent, PCWSTR fileModified) {
                 const auto modifiedBasename = std::filesystem::path{ fileModified }.filename();
 
-                if (modifiedBasename == settingsBasename)
+                // The dynamic profile cache changes when a profile generator
+                // that was too slow to wait for comes up with new profiles.
+                if (modifiedBasename == settingsBasename || modifiedBasename == dynamicProfileCacheBasename)
                 {
                     _reloadSettings->Run();
                 }
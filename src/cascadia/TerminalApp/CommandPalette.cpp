@@ -1029,12 +1029,15 @@ namespace winrt::TerminalApp::implementation
         }
         else if (_currentMode == CommandPaletteMode::TabSearchMode || _currentMode == CommandPaletteMode::ActionMode || _currentMode == CommandPaletteMode::CommandlineMode)
         {
+            // Case fold the search text once, instead of once per command.
+            const auto foldedSearchText{ FilteredCommand::FoldCase(searchText) };
+
             for (const auto& action : commandsToFilter)
             {
                 // Update filter for all commands
-                // This will modify the highlighting but will also lead to re-computation of weight (and consequently sorting).
-                // Pay attention that it already updates the highlighting in the UI
-                action.UpdateFilter(searchText);
+                // This will lead to re-computation of weight (and consequently sorting).
+                // The highlighting is only recomputed for the commands visible in the UI.
+                winrt::get_self<FilteredCommand>(action)->UpdateFilter(searchText, foldedSearchText);
 
                 // if there is active search we skip commands with 0 weight
                 if (searchText.empty() || action.Weight() > 0)
@@ -26,31 +26,105 @@ namespace winrt::TerminalApp::implementation
         _Filter(L""),
         _Weight(0)
     {
-        _HighlightedName = _computeHighlightedName();
+        _indexName();
 
-        // Recompute the highlighted name if the item name changes
+        // Recompute the match if the item name changes
         _itemChangedRevoker = _Item.PropertyChanged(winrt::auto_revoke, [weakThis{ get_weak() }](auto& /*sender*/, auto& e) {
             auto filteredCommand{ weakThis.get() };
             if (filteredCommand && e.PropertyName() == L"Name")
             {
-                filteredCommand->HighlightedName(filteredCommand->_computeHighlightedName());
+                filteredCommand->_indexName();
+                filteredCommand->_invalidateHighlightedName();
                 filteredCommand->Weight(filteredCommand->_computeWeight());
             }
         });
     }
 
     void FilteredCommand::UpdateFilter(winrt::hstring const& filter)
+    {
+        UpdateFilter(filter, FoldCase(filter));
+    }
+
+    // Method Description:
+    // - Updates the filter and the weight of this item.
+    // - The CommandPalette calls this for every item on every keystroke, so this
+    //   only matches the filter against the index of the name. The highlighted
+    //   name is computed once it's requested by the UI.
+    // Arguments:
+    // - filter: the new filter
+    // - foldedFilter: the filter, already passed through FoldCase
+    void FilteredCommand::UpdateFilter(winrt::hstring const& filter, std::wstring_view foldedFilter)
     {
         // If the filter was not changed we want to prevent the re-computation of matching
         // that might result in triggering a notification event
         if (filter != _Filter)
         {
             Filter(filter);
-            HighlightedName(_computeHighlightedName());
+            _updateMatch(filter, foldedFilter);
+            _invalidateHighlightedName();
             Weight(_computeWeight());
         }
     }
 
+    winrt::TerminalApp::HighlightedText FilteredCommand::HighlightedName()
+    {
+        if (!_HighlightedName && _Item)
+        {
+            _HighlightedName = _computeHighlightedName();
+        }
+        return _HighlightedName;
+    }
+
+    // Function Description:
+    // - Converts the given text to lowercase, according to the user's locale.
+    //   Filters and item names are compared in this form.
+    // - GH#9941: search should be locale-aware
+    // Arguments:
+    // - text: the text to convert
+    // Return Value:
+    // - the converted text, which is as long as the given one
+    std::wstring FilteredCommand::FoldCase(std::wstring_view text)
+    {
+        std::wstring folded{ text };
+        if (!folded.empty())
+        {
+            const auto length = gsl::narrow<int>(folded.size());
+            std::wstring lower(folded.size(), L'\0');
+
+            // Lowercase mappings don't change the length of the text,
+            // but if they ever do, we'd rather match case sensitively
+            // than highlight the wrong characters.
+            if (LCMapStringEx(LOCALE_NAME_USER_DEFAULT, LCMAP_LOWERCASE | LCMAP_LINGUISTIC_CASING, folded.data(), length, lower.data(), length, nullptr, nullptr, 0) == length)
+            {
+                folded.swap(lower);
+            }
+        }
+        return folded;
+    }
+
+    static constexpr uint64_t _charsetBit(const wchar_t ch) noexcept
+    {
+        return uint64_t{ 1 } << (ch & 63);
+    }
+
+    // Method Description:
+    // - Builds the index of the item name that filters are matched against,
+    //   and discards the match of the current filter, if any.
+    void FilteredCommand::_indexName()
+    {
+        _foldedName = FoldCase(_Item.Name());
+        _nameCharset = 0;
+        for (const auto ch : _foldedName)
+        {
+            _nameCharset |= _charsetBit(ch);
+        }
+
+        _matchedFilter = L"";
+        _foldedFilter.clear();
+        _matchOffsets.clear();
+        _updateMatch(_Filter, FoldCase(_Filter));
+    }
+
     // Method Description:
     // - Looks up the filter characters within the item name.
     // Iterating through the filter and the item name it tries to associate the next filter character
@@ -58,94 +132,121 @@ namespace winrt::TerminalApp::implementation
     //
     // E.g., for filter="c l t s" and name="close all tabs after this", the match will be "CLose TabS after this".
     //
-    // The item name is then split into segments (groupings of matched and non matched characters).
+    // - Since the first characters of a filter are always matched the same way,
+    //   the part of the previous match that's shared with the new filter is reused.
+    //   While typing this means we only need to match the last character,
+    //   and only for the items that matched before.
+    // Arguments:
+    // - filter: the filter to match
+    // - foldedFilter: the filter, already passed through FoldCase
+    void FilteredCommand::_updateMatch(winrt::hstring const& filter, std::wstring_view foldedFilter)
+    {
+        const auto previousLength = _foldedFilter.size();
+        const auto commonLength = gsl::narrow_cast<size_t>(std::mismatch(_foldedFilter.begin(), _foldedFilter.end(), foldedFilter.begin(), foldedFilter.end()).first - _foldedFilter.begin());
+        const auto previousMatched = _matchOffsets.size() == previousLength;
+        _matchedFilter = filter;
+        _foldedFilter.assign(foldedFilter);
+
+        if (!previousMatched && commonLength == previousLength)
+        {
+            // If a filter didn't match, adding more characters to it won't change that.
+            return;
+        }
+
+        _matchOffsets.resize(std::min(_matchOffsets.size(), commonLength));
+
+        // Quickly skip names that don't contain all the remaining filter characters.
+        uint64_t filterCharset = 0;
+        for (const auto ch : foldedFilter.substr(_matchOffsets.size()))
+        {
+            filterCharset |= _charsetBit(ch);
+        }
+        if ((filterCharset & ~_nameCharset) != 0)
+        {
+            return;
+        }
+
+        auto offset = _matchOffsets.empty() ? 0 : _matchOffsets.back() + 1;
+        for (auto i = _matchOffsets.size(); i < foldedFilter.size(); ++i)
+        {
+            offset = _foldedName.find(til::at(foldedFilter, i), offset);
+            if (offset == std::wstring::npos)
+            {
+                // There are still unmatched filter characters but we finished scanning the name.
+                return;
+            }
+            _matchOffsets.emplace_back(offset++);
+        }
+    }
+
+    // Method Description:
+    // - Discards the highlighted name, and lets the UI know that it needs to request
+    //   a new one. Items that aren't visible aren't bound to, and thus aren't notified.
+    void FilteredCommand::_invalidateHighlightedName()
+    {
+        _HighlightedName = nullptr;
+        if (_PropertyChangedHandlers)
+        {
+            _PropertyChangedHandlers(*this, Windows::UI::Xaml::Data::PropertyChangedEventArgs{ L"HighlightedName" });
+        }
+    }
+
+    // Method Description:
+    // - Splits the item name into segments (groupings of matched and non matched characters),
+    //   according to the match computed by _updateMatch.
     //
-    // E.g., the segments were the example above will be "CL", "ose ", "T", "ab", "S", "after this".
+    // E.g., for filter="c l t s" and name="close all tabs after this", the segments will be
+    // "CL", "ose ", "T", "ab", "S", "after this".
     //
     // The segments matching the filter characters are marked as highlighted.
     //
     // E.g., ("CL", true) ("ose ", false), ("T", true), ("ab", false), ("S", true), ("after this", false)
     //
-    // TODO: we probably need to merge this logic with _getWeight computation?
-    //
     // Return Value:
     // - The HighlightedText object initialized with the segments computed according to the algorithm above.
     winrt::TerminalApp::HighlightedText FilteredCommand::_computeHighlightedName()
     {
+        if (_Filter != _matchedFilter)
+        {
+            _updateMatch(_Filter, FoldCase(_Filter));
+        }
+
         const auto segments = winrt::single_threaded_observable_vector<winrt::TerminalApp::HighlightedTextSegment>();
-        auto commandName = _Item.Name();
-        bool isProcessingMatchedSegment = false;
-        uint32_t nextOffsetToReport = 0;
-        uint32_t currentOffset = 0;
+        const std::wstring_view commandName{ _Item.Name() };
 
-        for (const auto searchChar : _Filter)
+        // If there are unmatched filter characters, we return the entire item name as unmatched
+        if (_matchOffsets.size() != _foldedFilter.size())
         {
-            const WCHAR searchCharAsString[] = { searchChar, L'\0' };
-            while (true)
+            segments.Append(winrt::make<HighlightedTextSegment>(winrt::hstring{ commandName }, false));
+            return winrt::make<HighlightedText>(segments);
+        }
+
+        const auto appendSegment = [&](const size_t begin, const size_t end, const bool isHighlighted) {
+            // Skip segment if it is empty (might happen when the first character of the name is matched)
+            if (end > begin)
             {
-                if (currentOffset == commandName.size())
-                {
-                    // There are still unmatched filter characters but we finished scanning the name.
-                    // In this case we return the entire item name as unmatched
-                    auto entireNameSegment{ winrt::make<HighlightedTextSegment>(commandName, false) };
-                    segments.Clear();
-                    segments.Append(entireNameSegment);
-                    return winrt::make<HighlightedText>(segments);
-                }
-
-                // GH#9941: search should be locale-aware as well
-                // We use the same comparison method as upon sorting to guarantee consistent behavior
-                const WCHAR currentCharAsString[] = { commandName[currentOffset], L'\0' };
-                auto isCurrentCharMatched = lstrcmpi(searchCharAsString, currentCharAsString) == 0;
-                if (isProcessingMatchedSegment != isCurrentCharMatched)
-                {
-                    // We reached the end of the region (matched character came after a series of unmatched or vice versa).
-                    // Conclude the segment and add it to the list.
-                    // Skip segment if it is empty (might happen when the first character of the name is matched)
-                    auto sizeToReport = currentOffset - nextOffsetToReport;
-                    if (sizeToReport > 0)
-                    {
-                        winrt::hstring segment{ commandName.data() + nextOffsetToReport, sizeToReport };
-                        auto highlightedSegment{ winrt::make<HighlightedTextSegment>(segment, isProcessingMatchedSegment) };
-                        segments.Append(highlightedSegment);
-                        nextOffsetToReport = currentOffset;
-                    }
-                    isProcessingMatchedSegment = isCurrentCharMatched;
-                }
-
-                currentOffset++;
-
-                if (isCurrentCharMatched)
-                {
-                    // We have matched this filter character, let's move to matching the next filter char
-                    break;
-                }
+                segments.Append(winrt::make<HighlightedTextSegment>(winrt::hstring{ commandName.substr(begin, end - begin) }, isHighlighted));
             }
-        }
+        };
 
-        // Either the filter or the item name were fully processed.
-        // If we were in the middle of the matched segment - add it.
-        if (isProcessingMatchedSegment)
+        size_t nextOffsetToReport = 0;
+        for (size_t i = 0; i < _matchOffsets.size();)
         {
-            auto sizeToReport = currentOffset - nextOffsetToReport;
-            if (sizeToReport > 0)
+            // Consecutive matched characters form a single highlighted segment.
+            const auto begin = til::at(_matchOffsets, i);
+            auto end = begin + 1;
+            for (++i; i < _matchOffsets.size() && til::at(_matchOffsets, i) == end; ++i)
             {
-                winrt::hstring segment{ commandName.data() + nextOffsetToReport, sizeToReport };
-                auto highlightedSegment{ winrt::make<HighlightedTextSegment>(segment, true) };
-                segments.Append(highlightedSegment);
-                nextOffsetToReport = currentOffset;
+                ++end;
             }
+
+            appendSegment(nextOffsetToReport, begin, false);
+            appendSegment(begin, end, true);
+            nextOffsetToReport = end;
         }
 
         // Now create a segment for all remaining characters.
-        // We will have remaining characters as long as the filter is shorter than the item name.
-        auto sizeToReport = commandName.size() - nextOffsetToReport;
-        if (sizeToReport > 0)
-        {
-            winrt::hstring segment{ commandName.data() + nextOffsetToReport, sizeToReport };
-            auto highlightedSegment{ winrt::make<HighlightedTextSegment>(segment, false) };
-            segments.Append(highlightedSegment);
-        }
+        appendSegment(nextOffsetToReport, commandName.size(), false);
 
         return winrt::make<HighlightedText>(segments);
     }
@@ -191,27 +292,36 @@ namespace winrt::TerminalApp::implementation
     // - the relative weight of this match
     int FilteredCommand::_computeWeight()
     {
-        int result = 0;
-        bool isNextSegmentWordBeginning = true;
+        if (_Filter != _matchedFilter)
+        {
+            _updateMatch(_Filter, FoldCase(_Filter));
+        }
 
-        for (const auto& segment : _HighlightedName.Segments())
+        // If there are unmatched filter characters, the item shouldn't be shown
+        if (_matchOffsets.size() != _foldedFilter.size())
         {
-            const auto& segmentText = segment.TextSegment();
-            const auto segmentSize = segmentText.size();
+            return 0;
+        }
 
-            if (segment.IsHighlighted())
+        int result = 0;
+        for (size_t i = 0; i < _matchOffsets.size();)
+        {
+            // Consecutive matched characters form a single highlighted segment.
+            const auto begin = til::at(_matchOffsets, i);
+            size_t segmentSize = 1;
+            for (++i; i < _matchOffsets.size() && til::at(_matchOffsets, i) == begin + segmentSize; ++i)
             {
-                // Give extra point for each consecutive match
-                result += (segmentSize <= 1) ? segmentSize : 1 + 2 * (segmentSize - 1);
-
-                // Give extra point if this segment is at the beginning of a word
-                if (isNextSegmentWordBeginning)
-                {
-                    result++;
-                }
+                ++segmentSize;
             }
 
-            isNextSegmentWordBeginning = segmentSize > 0 && segmentText[segmentSize - 1] == L' ';
+            // Give extra point for each consecutive match
+            result += gsl::narrow_cast<int>(1 + 2 * (segmentSize - 1));
+
+            // Give extra point if this segment is at the beginning of a word
+            if (begin == 0 || til::at(_foldedName, begin - 1) == L' ')
+            {
+                result++;
+            }
         }
 
         return result;
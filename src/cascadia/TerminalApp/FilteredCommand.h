@@ -21,16 +21,38 @@ namespace winrt::TerminalApp::implementation
         FilteredCommand(winrt::TerminalApp::PaletteItem const& item);
 
         void UpdateFilter(winrt::hstring const& filter);
+        void UpdateFilter(winrt::hstring const& filter, std::wstring_view foldedFilter);
+
+        winrt::TerminalApp::HighlightedText HighlightedName();
 
         static int Compare(winrt::TerminalApp::FilteredCommand const& first, winrt::TerminalApp::FilteredCommand const& second);
+        static std::wstring FoldCase(std::wstring_view text);
 
         WINRT_CALLBACK(PropertyChanged, Windows::UI::Xaml::Data::PropertyChangedEventHandler);
         WINRT_OBSERVABLE_PROPERTY(winrt::TerminalApp::PaletteItem, Item, _PropertyChangedHandlers, nullptr);
         WINRT_OBSERVABLE_PROPERTY(winrt::hstring, Filter, _PropertyChangedHandlers);
-        WINRT_OBSERVABLE_PROPERTY(winrt::TerminalApp::HighlightedText, HighlightedName, _PropertyChangedHandlers);
         WINRT_OBSERVABLE_PROPERTY(int, Weight, _PropertyChangedHandlers);
 
     private:
+        // The highlighted name is only computed once it's requested, which only
+        // happens for the items that are actually visible in the palette.
+        winrt::TerminalApp::HighlightedText _HighlightedName{ nullptr };
+
+        // The case folded item name, and a bitmask of the characters in it
+        // (see _charsetBit), used to match filters without allocating.
+        std::wstring _foldedName;
+        uint64_t _nameCharset{ 0 };
+
+        // The filter that _matchOffsets were computed for, its case folded form, and
+        // the offsets of the characters in the name that its characters matched.
+        // The filter matched if there's an offset for every filter character.
+        winrt::hstring _matchedFilter;
+        std::wstring _foldedFilter;
+        std::vector<size_t> _matchOffsets;
+
+        void _indexName();
+        void _updateMatch(winrt::hstring const& filter, std::wstring_view foldedFilter);
+        void _invalidateHighlightedName();
         winrt::TerminalApp::HighlightedText _computeHighlightedName();
         int _computeWeight();
         Windows::UI::Xaml::Data::INotifyPropertyChanged::PropertyChanged_revoker _itemChangedRevoker;
@@ -98,6 +98,7 @@ namespace winrt::TerminalApp::implementation
 
     void TerminalPage::SetSettings(CascadiaSettings settings, bool needRefreshUI)
     {
+        const auto previousSettings{ _settings };
         _settings = settings;
 
         // Make sure to _UpdateCommandsForPalette before
@@ -110,7 +111,7 @@ namespace winrt::TerminalApp::implementation
 
         if (needRefreshUI)
         {
-            _RefreshUIForSettingsReload();
+            _RefreshUIForSettingsReload(previousSettings);
         }
 
         // Upon settings update we reload the system settings for scrolling as well.
@@ -1886,17 +1887,42 @@ namespace winrt::TerminalApp::implementation
     //   This includes update the settings of all the tabs according
     //   to their profiles, update the title and icon of each tab, and
     //   finally create the tab flyout
-    void TerminalPage::_RefreshUIForSettingsReload()
+    // - Only controls using a profile whose settings differ from the previous
+    //   settings are updated. Re-applying settings to a control is expensive,
+    //   as it may recreate its render resources.
+    // Arguments:
+    // - previousSettings: the settings we had before, if any
+    void TerminalPage::_RefreshUIForSettingsReload(const CascadiaSettings& previousSettings)
     {
         // Re-wire the keybindings to their handlers, as we'll have created a
         // new AppKeyBindings object.
         _HookupKeyBindings(_settings.ActionMap());
 
+        // If we can't tell which profiles changed, update all of them.
+        std::optional<std::unordered_set<winrt::guid>> changedProfiles;
+        if (previousSettings)
+        {
+            try
+            {
+                std::unordered_set<winrt::guid> changed;
+                for (const auto& profileGuid : _settings.ChangedProfiles(previousSettings))
+                {
+                    changed.emplace(profileGuid);
+                }
+                changedProfiles = std::move(changed);
+            }
+            CATCH_LOG();
+        }
+
         // Refresh UI elements
         auto profiles = _settings.ActiveProfiles();
         for (const auto& profile : profiles)
         {
             const auto profileGuid = profile.Guid();
+            if (changedProfiles && changedProfiles->count(profileGuid) == 0)
+            {
+                continue;
+            }
 
             try
             {
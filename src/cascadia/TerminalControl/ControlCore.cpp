@@ -941,35 +941,19 @@ namespace winrt::Microsoft::Terminal::Control::implementation
             return false;
         }
 
-        // extract text from buffer
-        // RetrieveSelectedTextFromBuffer will lock while it's reading
-        const auto bufferData = _terminal->RetrieveSelectedTextFromBuffer(singleLine);
-
-        // convert text: vector<string> --> string
-        std::wstring textData;
-        for (const auto& text : bufferData.text)
-        {
-            textData += text;
-        }
-
-        // convert text to HTML format
+        // extract the text, and convert it to HTML and RTF format, in a single pass over the buffer
         // GH#5347 - Don't provide a title for the generated HTML, as many
         // web applications will paste the title first, followed by the HTML
         // content, which is unexpected.
-        const auto htmlData = formats == nullptr || WI_IsFlagSet(formats.Value(), CopyFormat::HTML) ?
-                                  TextBuffer::GenHTML(bufferData,
-                                                      _actualFont.GetUnscaledSize().Y,
-                                                      _actualFont.GetFaceName(),
-                                                      til::color{ _settings.DefaultBackground() }) :
-                                  "";
-
-        // convert to RTF format
-        const auto rtfData = formats == nullptr || WI_IsFlagSet(formats.Value(), CopyFormat::RTF) ?
-                                 TextBuffer::GenRTF(bufferData,
-                                                    _actualFont.GetUnscaledSize().Y,
-                                                    _actualFont.GetFaceName(),
-                                                    til::color{ _settings.DefaultBackground() }) :
-                                 "";
+        TextBuffer::SelectionFormatting formatting;
+        formatting.fontHeightPoints = _actualFont.GetUnscaledSize().Y;
+        formatting.fontFaceName = _actualFont.GetFaceName();
+        formatting.backgroundColor = til::color{ _settings.DefaultBackground() };
+        formatting.html = formats == nullptr || WI_IsFlagSet(formats.Value(), CopyFormat::HTML);
+        formatting.rtf = formats == nullptr || WI_IsFlagSet(formats.Value(), CopyFormat::RTF);
+
+        // RetrieveSelectionDataFromBuffer will lock while it's reading
+        const auto bufferData = _terminal->RetrieveSelectionDataFromBuffer(singleLine, formatting);
 
         if (!_settings.CopyOnSelect())
         {
@@ -979,9 +963,9 @@ namespace winrt::Microsoft::Terminal::Control::implementation
 
         // send data up for clipboard
         _CopyToClipboardHandlers(*this,
-                                 winrt::make<CopyToClipboardEventArgs>(winrt::hstring{ textData },
-                                                                       winrt::to_hstring(htmlData),
-                                                                       winrt::to_hstring(rtfData),
+                                 winrt::make<CopyToClipboardEventArgs>(winrt::hstring{ bufferData.text },
+                                                                       winrt::to_hstring(bufferData.html),
+                                                                       winrt::to_hstring(bufferData.rtf),
                                                                        formats));
         return true;
     }
@@ -1228,6 +1212,85 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         return result;
     }
 
+    // Method Description:
+    // - Writes the entire contents of the buffer to a file, one logical line at
+    //   a time, optionally with VT sequences for the colors and styles of the text.
+    // - The buffer is read in chunks of rows on a background thread. The terminal
+    //   is only locked while a chunk is being read, so the connection can keep
+    //   writing output while the file is written. Only the rows that contained
+    //   text when the export started are exported. If they scroll out of the
+    //   buffer before they're reached, they're skipped.
+    // - Resizing the terminal replaces its buffer and clearing the scrollback moves
+    //   its rows. Both fail the export with E_CHANGED_STATE.
+    // Arguments:
+    // - path: the file to write to. It's overwritten if it exists.
+    // - includeAttributes: if true, the colors and styles of the text are
+    //   written as SGR sequences.
+    // Return Value:
+    // - An operation that reports the fraction of the rows exported so far as its
+    //   progress, and results in the number of rows that had to be skipped.
+    Windows::Foundation::IAsyncOperationWithProgress<uint64_t, double> ControlCore::ExportBufferAsync(const winrt::hstring path,
+                                                                                                        const bool includeAttributes)
+    {
+        auto weakThis{ get_weak() };
+        auto progress{ co_await winrt::get_progress_token() };
+        auto cancellation{ co_await winrt::get_cancellation_token() };
+
+        co_await winrt::resume_background();
+
+        wil::unique_hfile file{ CreateFileW(path.c_str(), GENERIC_WRITE, FILE_SHARE_READ, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr) };
+        THROW_LAST_ERROR_IF(!file);
+
+        // Each chunk is at most a couple hundred rows worth of text,
+        // which keeps the time the terminal is locked short.
+        static constexpr size_t rowsPerChunk = 256;
+        const auto format = includeAttributes ? TextBuffer::ExportFormat::VirtualTerminal : TextBuffer::ExportFormat::PlainText;
+
+        Terminal::BufferExport state;
+        if (auto core{ weakThis.get() })
+        {
+            auto lock = core->_terminal->LockForReading();
+            state = core->_terminal->BeginBufferExport(format);
+        }
+        else
+        {
+            co_return 0;
+        }
+
+        std::string chunk;
+        while (!state.IsDone())
+        {
+            if (cancellation())
+            {
+                co_return state.skippedRows;
+            }
+
+            chunk.clear();
+            if (auto core{ weakThis.get() })
+            {
+                auto lock = core->_terminal->LockForReading();
+                core->_terminal->ExportBufferRows(state, chunk, rowsPerChunk);
+            }
+            else
+            {
+                // The control was closed, so the remaining rows are gone as well.
+                co_return state.skippedRows + (state.endRow - state.nextRow);
+            }
+
+            const auto chunkSize = gsl::narrow<DWORD>(chunk.size());
+            DWORD bytesWritten = 0;
+            THROW_IF_WIN32_BOOL_FALSE(WriteFile(file.get(), chunk.data(), chunkSize, &bytesWritten, nullptr));
+            if (bytesWritten != chunkSize)
+            {
+                THROW_WIN32_MSG(ERROR_WRITE_FAULT, "failed to write whole chunk");
+            }
+
+            progress(state.Progress());
+        }
+
+        co_return state.skippedRows;
+    }
+
     ::Microsoft::Console::Types::IUiaData* ControlCore::GetUiaData() const
     {
         return _terminal.get();
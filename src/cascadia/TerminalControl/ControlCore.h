@@ -125,6 +125,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         bool HasSelection() const;
         bool CopyOnSelect() const;
         Windows::Foundation::Collections::IVector<winrt::hstring> SelectedText(bool trimTrailingWhitespace) const;
+        Windows::Foundation::IAsyncOperationWithProgress<uint64_t, double> ExportBufferAsync(const winrt::hstring path, const bool includeAttributes);
         void SetSelectionAnchor(til::point const& position);
         void SetEndSelectionPoint(til::point const& position);
 
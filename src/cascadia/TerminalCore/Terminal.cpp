@@ -10,6 +10,8 @@
 #include "../../types/inc/utils.hpp"
 #include "../../types/inc/colorTable.hpp"
 
+#include <til/metrics.h>
+
 #include <winrt/Microsoft.Terminal.Core.h>
 
 using namespace winrt::Microsoft::Terminal::Core;
@@ -21,6 +23,8 @@ using namespace Microsoft::Console::VirtualTerminal;
 
 using PointTree = interval_tree::IntervalTree<til::point, size_t>;
 
+static til::metrics::histogram s_writeLockWait{ "terminal.write_lock_wait_ns" };
+
 static std::wstring _KeyEventsToText(std::deque<std::unique_ptr<IInputEvent>>& inEventsToWrite)
 {
     std::wstring wstr = L"";
@@ -38,9 +42,11 @@ static std::wstring _KeyEventsToText(std::deque<std::unique_ptr<IInputEvent>>& i
 
 #pragma warning(suppress : 26455) // default constructor is throwing, too much effort to rearrange at this time.
 Terminal::Terminal() :
+    _bufferGeneration{ 0 },
     _mutableViewport{ Viewport::Empty() },
     _title{},
     _colorTable{},
+    _colorTableGeneration{ 0 },
     _defaultFg{ RGB(255, 255, 255) },
     _defaultBg{ ARGB(0, 0, 0, 0) },
     _screenReversed{ false },
@@ -82,6 +88,7 @@ void Terminal::Create(COORD viewportSize, SHORT scrollbackLines, IRenderTarget&
     const TextAttribute attr{};
     const UINT cursorSize = 12;
     _buffer = std::make_unique<TextBuffer>(bufferSize, attr, cursorSize, renderTarget);
+    ++_bufferGeneration;
 }
 
 // Method Description:
@@ -178,6 +185,7 @@ void Terminal::UpdateAppearance(const ICoreAppearance& appearance)
     {
         _colorTable.at(i) = til::color{ appearance.GetColorTableEntry(i) };
     }
+    _colorTableGeneration = TextAttributeColorCache::NextColorTableGeneration();
 
     CursorType cursorShape = CursorType::VerticalBar;
     switch (appearance.CursorShape())
@@ -397,6 +405,7 @@ void Terminal::UpdateAppearance(const ICoreAppearance& appearance)
     _mutableViewport = Viewport::FromDimensions({ 0, proposedTop }, viewportSize);
 
     _buffer.swap(newTextBuffer);
+    ++_bufferGeneration;
 
     // GH#3494: Maintain scrollbar position during resize
     // Make sure that we don't scroll past the mutableViewport at the bottom of the buffer
@@ -857,6 +866,7 @@ WORD Terminal::_TakeVirtualKeyFromLastKeyEvent(const WORD scanCode) noexcept
 //      will release this lock when it's destructed.
 [[nodiscard]] std::unique_lock<til::ticket_lock> Terminal::LockForWriting()
 {
+    til::metrics::scoped_timer timer{ s_writeLockWait };
     return std::unique_lock{ _readWriteLock };
 }
 
@@ -870,6 +880,77 @@ short Terminal::GetBufferHeight() const noexcept
     return _mutableViewport.BottomExclusive();
 }
 
+// Method Description:
+// - Starts exporting the rows of the buffer that currently contain text. The rows
+//   are then read in chunks with ExportBufferRows, so that the terminal doesn't
+//   need to stay locked for the whole export.
+// - The terminal must be locked while this is called.
+// Arguments:
+// - format: whether to export plain text or text with VT sequences for its attributes
+// Return Value:
+// - the state of the export, to be passed to ExportBufferRows
+Terminal::BufferExport Terminal::BeginBufferExport(const TextBuffer::ExportFormat format) const
+{
+    const auto circledRows = _buffer->GetCircledRowCount();
+    const auto lastRow = std::max(_buffer->GetLastNonSpaceCharacter().Y, _buffer->GetCursor().GetPosition().Y);
+
+    BufferExport state;
+    state.format = format;
+    state.bufferGeneration = _bufferGeneration;
+    state.firstRow = circledRows;
+    state.nextRow = circledRows;
+    state.endRow = circledRows + lastRow + 1;
+    return state;
+}
+
+// Method Description:
+// - Appends the next chunk of rows of an export started with BeginBufferExport.
+//   Rows that scrolled out of the buffer since the previous chunk can't be
+//   exported anymore. They're counted in the skippedRows of the export instead.
+// - After the last row the attributes are reset, so that replaying the
+//   output doesn't leave them set.
+// - The terminal must be locked while this is called.
+// Arguments:
+// - state: the export to continue
+// - out: the string to append the rows to
+// - maxRows: the maximum number of rows to append
+// Return Value:
+// - <none>
+// - Throws E_CHANGED_STATE if the buffer was replaced since the export started,
+//   for instance by a resize, or if its scrollback was cleared, because the
+//   rows it tracks are gone.
+void Terminal::ExportBufferRows(BufferExport& state, std::string& out, const size_t maxRows) const
+{
+    THROW_HR_IF_MSG(E_CHANGED_STATE, state.bufferGeneration != _bufferGeneration, "buffer was replaced or cleared during export");
+
+    const auto circledRows = _buffer->GetCircledRowCount();
+    if (state.nextRow < circledRows)
+    {
+        const auto firstRemainingRow = std::min(circledRows, state.endRow);
+        state.skippedRows += firstRemainingRow - state.nextRow;
+        state.nextRow = firstRemainingRow;
+    }
+
+    // The buffer is the same one the export started with, so the rows that are
+    // left are all within it and their offsets fit into a SHORT.
+    const auto chunkEnd = std::min(state.nextRow + maxRows, state.endRow);
+    if (state.nextRow < chunkEnd)
+    {
+        _buffer->ExportRows(out,
+                            gsl::narrow<SHORT>(state.nextRow - circledRows),
+                            gsl::narrow<SHORT>(chunkEnd - circledRows),
+                            state.format,
+                            state.lastAttributes);
+        state.nextRow = chunkEnd;
+    }
+
+    if (state.IsDone() && state.lastAttributes != TextAttribute{})
+    {
+        out.append("\x1b[m");
+        state.lastAttributes = {};
+    }
+}
+
 // ViewStartIndex is also the length of the scrollback
 int Terminal::ViewStartIndex() const noexcept
 {
@@ -1170,6 +1251,7 @@ try
     Utils::InitializeCampbellColorTable(tableView);
     // Then make sure all the values have an alpha of 255
     Utils::SetColorTableAlpha(tableView, 0xff);
+    _colorTableGeneration = TextAttributeColorCache::NextColorTableGeneration();
 }
 CATCH_LOG()
 
@@ -7,6 +7,7 @@
 
 #include "../../inc/DefaultSettings.h"
 #include "../../buffer/out/textBuffer.hpp"
+#include "../../buffer/out/TextAttributeColorCache.hpp"
 #include "../../types/inc/sgrStack.hpp"
 #include "../../renderer/inc/BlinkingState.hpp"
 #include "../../terminal/parser/StateMachine.hpp"
@@ -84,6 +85,25 @@ public:
 
     short GetBufferHeight() const noexcept;
 
+    // The progress of exporting the buffer in chunks. Rows are tracked with their
+    // index plus the number of rows that circled out of the buffer at that point,
+    // which doesn't change when the buffer circles.
+    struct BufferExport
+    {
+        TextBuffer::ExportFormat format{ TextBuffer::ExportFormat::PlainText };
+        size_t bufferGeneration{ 0 };
+        size_t firstRow{ 0 };
+        size_t nextRow{ 0 };
+        size_t endRow{ 0 };
+        size_t skippedRows{ 0 }; // rows that scrolled out of the buffer before they were reached
+        TextAttribute lastAttributes;
+
+        bool IsDone() const noexcept { return nextRow == endRow; }
+        double Progress() const noexcept { return static_cast<double>(nextRow - firstRow) / (endRow - firstRow); }
+    };
+    BufferExport BeginBufferExport(const TextBuffer::ExportFormat format) const;
+    void ExportBufferRows(BufferExport& state, std::string& out, const size_t maxRows) const;
+
     int ViewStartIndex() const noexcept;
     int ViewEndIndex() const noexcept;
 
@@ -239,6 +259,7 @@ public:
     void SetBlockSelection(const bool isEnabled) noexcept;
 
     const TextBuffer::TextAndColor RetrieveSelectedTextFromBuffer(bool trimTrailingWhitespace);
+    TextBuffer::SelectionData RetrieveSelectionDataFromBuffer(bool singleLine, TextBuffer::SelectionFormatting formatting);
 #pragma endregion
 
 private:
@@ -271,11 +292,13 @@ private:
 
     // This is still stored as a COLORREF because it interacts with some code in ConTypes
     std::array<COLORREF, XTERM_COLOR_TABLE_SIZE> _colorTable;
+    size_t _colorTableGeneration; // changes whenever _colorTable does
     til::color _defaultFg;
     til::color _defaultBg;
     CursorType _defaultCursorShape;
     bool _screenReversed;
     mutable Microsoft::Console::Render::BlinkingState _blinkingState;
+    mutable TextAttributeColorCache _colorCache;
 
     bool _snapOnInput;
     bool _altGrAliasing;
@@ -313,6 +336,7 @@ private:
     // TODO: These members are not shared by an alt-buffer. They should be
     //      encapsulated, such that a Terminal can have both a main and alt buffer.
     std::unique_ptr<TextBuffer> _buffer;
+    size_t _bufferGeneration; // changes whenever _buffer is replaced or its rows are moved in place
     Microsoft::Console::Types::Viewport _mutableViewport;
     SHORT _scrollbackLines;
 
@@ -321,6 +321,10 @@ try
         _mutableViewport.ConvertFromOrigin(&scrollFromPos);
         _buffer->ScrollRows(scrollFromPos.Y, _mutableViewport.Height(), -scrollFromPos.Y);
 
+        // The rows moved without circling the buffer, so anything tracking them
+        // by their position (like an export) needs to know that they're gone.
+        ++_bufferGeneration;
+
         // Since we only did a rotation, the text that was in the scrollback is now _below_ where we are going to move the viewport
         // and we have to make sure we erase that text
         const auto eraseStart = _mutableViewport.Height();
@@ -382,6 +386,7 @@ bool Terminal::SetColorTableEntry(const size_t tableIndex, const COLORREF color)
 try
 {
     _colorTable.at(tableIndex) = color;
+    _colorTableGeneration = TextAttributeColorCache::NextColorTableGeneration();
 
     // Repaint everything - the colors might have changed
     _buffer->GetRenderTarget().TriggerRedrawAll();
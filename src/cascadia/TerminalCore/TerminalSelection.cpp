@@ -267,6 +267,33 @@ const TextBuffer::TextAndColor Terminal::RetrieveSelectedTextFromBuffer(bool sin
     return _buffer->GetText(includeCRLF, trimTrailingWhitespace, selectionRects, GetAttributeColors, formatWrappedRows);
 }
 
+// Method Description:
+// - get the text from highlighted portion of text buffer, along with its HTML and RTF
+//   representations if requested, in a single pass over the buffer
+// Arguments:
+// - singleLine: collapse all of the text to one line
+// - formatting: the formats to generate in addition to the text. The colors are
+//   looked up with GetAttributeColors.
+// Return Value:
+// - the selected text, and its HTML and RTF representations if requested
+TextBuffer::SelectionData Terminal::RetrieveSelectionDataFromBuffer(bool singleLine, TextBuffer::SelectionFormatting formatting)
+{
+    auto lock = LockForReading();
+
+    const auto selectionRects = _GetSelectionRects();
+
+    if (formatting.html || formatting.rtf)
+    {
+        formatting.GetAttributeColors = std::bind(&Terminal::GetAttributeColors, this, std::placeholders::_1);
+    }
+
+    // See RetrieveSelectedTextFromBuffer for how block selections are formatted.
+    const auto includeCRLF = !singleLine || _blockSelection;
+    const auto trimTrailingWhitespace = !singleLine && (!_blockSelection || _trimBlockSelection);
+    const auto formatWrappedRows = _blockSelection;
+    return _buffer->GetSelectionData(includeCRLF, trimTrailingWhitespace, selectionRects, formatting, formatWrappedRows);
+}
+
 // Method Description:
 // - convert viewport position to the corresponding location on the buffer
 // Arguments:
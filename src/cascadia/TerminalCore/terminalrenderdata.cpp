@@ -45,8 +45,10 @@ const TextAttribute Terminal::GetDefaultBrushColors() noexcept
 std::pair<COLORREF, COLORREF> Terminal::GetAttributeColors(const TextAttribute& attr) const noexcept
 {
     _blinkingState.RecordBlinkingUsage(attr);
-    auto colors = attr.CalculateRgbColors(
+    auto colors = _colorCache.Resolve(
+        attr,
         _colorTable,
+        _colorTableGeneration,
         _defaultFg,
         _defaultBg,
         _screenReversed,
@@ -47,9 +47,18 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
         return hashedAction ^ hashedArgs;
     }
 
+    // Returns a number that's never been returned before. ActionMaps are stamped with one
+    // whenever they change, so that a stamp identifies both a map and its contents.
+    static uint64_t NextChangeStamp() noexcept
+    {
+        static std::atomic<uint64_t> nextStamp{ 0 };
+        return ++nextStamp;
+    }
+
     ActionMap::ActionMap() :
         _NestedCommands{ single_threaded_map<hstring, Model::Command>() },
-        _IterableCommands{ single_threaded_vector<Model::Command>() }
+        _IterableCommands{ single_threaded_vector<Model::Command>() },
+        _ChangeStamp{ NextChangeStamp() }
     {
     }
 
@@ -365,6 +374,77 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
         }
     }
 
+    // Method Description:
+    // - Populates the provided lookup with the key chords of our layer and our parents' layers.
+    // - This needs to be a bottom up approach, so that a key chord bound (or unbound)
+    //   in our layer takes precedence over the same key chord in our parents.
+    // Arguments:
+    // - lookup: the lookup we're populating
+    void ActionMap::_PopulateKeyChordLookup(KeyChordLookup& lookup) const
+    {
+        for (const auto& [keys, actionID] : _KeyMap)
+        {
+            lookup.emplace(keys, _GetActionByID(actionID));
+        }
+
+        FAIL_FAST_IF(_parents.size() > 1);
+        for (const auto& parent : _parents)
+        {
+            parent->_PopulateKeyChordLookup(lookup);
+        }
+    }
+
+    // Method Description:
+    // - Flattens the key chords of all layers into a single lookup table, so that
+    //   resolving a key press is a single hash lookup, no matter how many layers
+    //   and bindings there are. The table is rebuilt once an action is added to
+    //   any of the layers or the chain of parents changes.
+    // - This is called once the settings are loaded, so that the first key press
+    //   doesn't pay for it. Otherwise it's built on demand.
+    void ActionMap::BuildKeyChordLookup() const
+    {
+        if (!_IsKeyChordLookupCurrent())
+        {
+            KeyChordLookup lookup;
+            _PopulateKeyChordLookup(lookup);
+
+            std::vector<uint64_t> layers;
+            for (auto layer = this; layer; layer = layer->_parents.empty() ? nullptr : layer->_parents.front().get())
+            {
+                layers.emplace_back(layer->_ChangeStamp);
+            }
+
+            _KeyChordLookupCache = std::move(lookup);
+            _KeyChordLookupLayers = std::move(layers);
+        }
+    }
+
+    // Method Description:
+    // - Checks whether the lookup table built by BuildKeyChordLookup still reflects
+    //   this layer and all of its parents. Every layer's change stamp is unique
+    //   and changes whenever an action is added to it, so the table is current iff
+    //   the stamps of the layers are the same as when it was built.
+    // Return Value:
+    // - true if the lookup table can be used as is
+    bool ActionMap::_IsKeyChordLookupCurrent() const noexcept
+    {
+        if (!_KeyChordLookupCache)
+        {
+            return false;
+        }
+
+        size_t i = 0;
+        for (auto layer = this; layer; layer = layer->_parents.empty() ? nullptr : layer->_parents.front().get())
+        {
+            if (i == _KeyChordLookupLayers.size() || til::at(_KeyChordLookupLayers, i) != layer->_ChangeStamp)
+            {
+                return false;
+            }
+            ++i;
+        }
+        return i == _KeyChordLookupLayers.size();
+    }
+
     com_ptr<ActionMap> ActionMap::Copy() const
     {
         auto actionMap{ make_self<ActionMap>() };
@@ -422,6 +502,10 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
         _NameMapCache = nullptr;
         _GlobalHotkeysCache = nullptr;
         _KeyBindingMapCache = nullptr;
+        _KeyChordLookupCache.reset();
+
+        // invalidate the key chord lookups of the layers inheriting from us
+        _ChangeStamp = NextChangeStamp();
 
         // Handle nested commands
         const auto cmdImpl{ get_self<Command>(cmd) };
@@ -737,27 +821,18 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
     // Return Value:
     // - the command with the given key chord
     // - nullptr if the key chord is explicitly unbound
-    // - nullopt if it was not bound in this layer
+    // - nullopt if it was not bound in any layer
     std::optional<Model::Command> ActionMap::_GetActionByKeyChordInternal(Control::KeyChord const& keys) const
     {
-        // Check the current layer
-        if (const auto actionIDPair = _KeyMap.find(keys); actionIDPair != _KeyMap.end())
-        {
-            // the command was explicitly bound,
-            // return what we found (invalid commands exposed as nullptr)
-            return _GetActionByID(actionIDPair->second);
-        }
+        // This is called for every key press. Instead of walking all the
+        // layers, check the flattened lookup table of all of them.
+        BuildKeyChordLookup();
 
-        // the command was not bound in this layer,
-        // ask my parents
-        FAIL_FAST_IF(_parents.size() > 1);
-        for (const auto& parent : _parents)
+        if (const auto it = _KeyChordLookupCache->find(keys); it != _KeyChordLookupCache->end())
         {
-            const auto& inheritedCmd{ parent->_GetActionByKeyChordInternal(keys) };
-            if (inheritedCmd)
-            {
-                return *inheritedCmd;
-            }
+            // the command was explicitly bound in some layer,
+            // return what we found (invalid commands exposed as nullptr)
+            return it->second;
         }
 
         // This action is not explicitly bound
@@ -48,6 +48,11 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
         }
     };
 
+    // Maps a key chord to the command it resolves to across all layers:
+    // - nullptr if the key chord is explicitly unbound
+    // - nullopt if it's bound to an action that doesn't exist (see _GetActionByID)
+    using KeyChordLookup = std::unordered_map<Control::KeyChord, std::optional<Model::Command>, KeyChordHash, KeyChordEquality>;
+
     struct ActionMap : ActionMapT<ActionMap>, IInheritable<ActionMap>
     {
         ActionMap();
@@ -67,6 +72,7 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
 
         // population
         void AddAction(const Model::Command& cmd);
+        void BuildKeyChordLookup() const;
 
         // JSON
         static com_ptr<ActionMap> FromJson(const Json::Value& json);
@@ -81,11 +87,13 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
     private:
         std::optional<Model::Command> _GetActionByID(const InternalActionID actionID) const;
         std::optional<Model::Command> _GetActionByKeyChordInternal(const Control::KeyChord& keys) const;
+        bool _IsKeyChordLookupCurrent() const noexcept;
 
         void _PopulateAvailableActionsWithStandardCommands(std::unordered_map<hstring, Model::ActionAndArgs>& availableActions, std::unordered_set<InternalActionID>& visitedActionIDs) const;
         void _PopulateNameMapWithSpecialCommands(std::unordered_map<hstring, Model::Command>& nameMap) const;
         void _PopulateNameMapWithStandardCommands(std::unordered_map<hstring, Model::Command>& nameMap) const;
         void _PopulateKeyBindingMapWithStandardCommands(std::unordered_map<Control::KeyChord, Model::Command, KeyChordHash, KeyChordEquality>& keyBindingsMap, std::unordered_set<Control::KeyChord, KeyChordHash, KeyChordEquality>& unboundKeys) const;
+        void _PopulateKeyChordLookup(KeyChordLookup& lookup) const;
         std::vector<Model::Command> _GetCumulativeActions() const noexcept;
 
         void _TryUpdateActionMap(const Model::Command& cmd, Model::Command& oldCmd, Model::Command& consolidatedCmd);
@@ -96,8 +104,11 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
         Windows::Foundation::Collections::IMap<hstring, Model::Command> _NameMapCache{ nullptr };
         Windows::Foundation::Collections::IMap<Control::KeyChord, Model::Command> _GlobalHotkeysCache{ nullptr };
         Windows::Foundation::Collections::IMap<Control::KeyChord, Model::Command> _KeyBindingMapCache{ nullptr };
+        mutable std::optional<KeyChordLookup> _KeyChordLookupCache;
+        mutable std::vector<uint64_t> _KeyChordLookupLayers;
         Windows::Foundation::Collections::IMap<hstring, Model::Command> _NestedCommands{ nullptr };
         Windows::Foundation::Collections::IVector<Model::Command> _IterableCommands{ nullptr };
+        uint64_t _ChangeStamp;
         std::unordered_map<Control::KeyChord, InternalActionID, KeyChordHash, KeyChordEquality> _KeyMap;
         std::unordered_map<InternalActionID, Model::Command> _ActionMap;
 
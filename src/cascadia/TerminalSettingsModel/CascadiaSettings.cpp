@@ -20,6 +20,8 @@ using namespace Microsoft::Console;
 
 static constexpr std::wstring_view PACKAGED_PROFILE_ICON_PATH{ L"ms-appx:///ProfileIcons/" };
 
+static constexpr std::string_view ActionsKey{ "actions" };
+
 static constexpr std::wstring_view PACKAGED_PROFILE_ICON_EXTENSION{ L".png" };
 static constexpr std::wstring_view DEFAULT_LINUX_ICON_GUID{ L"{9acb9455-ca41-5af7-950f-6bca1bc9722f}" };
 
@@ -51,6 +53,7 @@ CascadiaSettings::CascadiaSettings(const bool addDynamicProfiles) :
         _profileGenerators.emplace_back(std::make_unique<PowershellCoreProfileGenerator>());
         _profileGenerators.emplace_back(std::make_unique<WslDistroGenerator>());
         _profileGenerators.emplace_back(std::make_unique<AzureCloudShellGenerator>());
+        _dynamicProfileCache = DynamicProfileCache::SharedInstance();
     }
 }
 
@@ -571,6 +574,7 @@ void CascadiaSettings::_ValidateNoDuplicateProfiles()
     {
         _allProfiles.RemoveAt(*iter);
     }
+    _InvalidateProfileIndex();
 
     if (foundDupe)
     {
@@ -632,6 +636,7 @@ void CascadiaSettings::_ReorderProfilesToMatchUserSettingsOrder()
             }
         }
     }
+    _InvalidateProfileIndex();
 }
 
 // Method Description:
@@ -914,6 +919,9 @@ void CascadiaSettings::_ValidateKeybindings()
             _warnings.Append(warning);
         }
     }
+
+    // Resolve all key chords up front, so that handling a key press is a single lookup.
+    winrt::get_self<implementation::ActionMap>(_globals->ActionMap())->BuildKeyChordLookup();
 }
 
 // Method Description:
@@ -1088,6 +1096,111 @@ void CascadiaSettings::UpdateColorSchemeReferences(const hstring oldName, const
     }
 }
 
+// Function Description:
+// - Serializes the given settings object and all of its ancestors, in the
+//   order they're consulted in, which together make up its effective settings.
+// Arguments:
+// - settings: the settings object to serialize
+// - out: the json array to append the serializations to
+// Return Value:
+// - <none>
+template<typename T>
+static void _AppendInheritanceChainJson(T& settings, Json::Value& out)
+{
+    out.append(settings.ToJson());
+    for (const auto& parent : settings.Parents())
+    {
+        _AppendInheritanceChainJson(*parent, out);
+    }
+}
+
+// Function Description:
+// - Serializes the global settings that feed into the TerminalSettings of every
+//   profile. Key bindings are left out: controls resolve them through the
+//   app's key bindings object, which is updated in place on reload.
+// Arguments:
+// - globals: the global settings to serialize
+// Return Value:
+// - the serialized global settings
+static Json::Value _GlobalTerminalSettingsJson(GlobalAppSettings& globals)
+{
+    Json::Value json{ Json::ValueType::arrayValue };
+    _AppendInheritanceChainJson(globals, json);
+    for (auto& layer : json)
+    {
+        layer.removeMember(JsonKey(ActionsKey));
+    }
+    return json;
+}
+
+// Function Description:
+// - Serializes everything the TerminalSettings for the given profile are
+//   created from, other than the global settings: the profile, its parents
+//   and the color schemes its appearances refer to.
+// Arguments:
+// - globals: the global settings holding the profile's color schemes
+// - profile: the profile to serialize
+// Return Value:
+// - the serialized profile
+static Json::Value _ProfileTerminalSettingsJson(GlobalAppSettings& globals, const winrt::Microsoft::Terminal::Settings::Model::Profile& profile)
+{
+    Json::Value json{ Json::ValueType::arrayValue };
+    _AppendInheritanceChainJson(*winrt::get_self<Profile>(profile), json);
+
+    const auto schemes{ globals.ColorSchemes() };
+    const auto appendScheme = [&](const winrt::Microsoft::Terminal::Settings::Model::IAppearanceConfig& appearance) {
+        if (const auto scheme{ appearance ? schemes.TryLookup(appearance.ColorSchemeName()) : nullptr })
+        {
+            json.append(winrt::get_self<ColorScheme>(scheme)->ToJson());
+        }
+    };
+    appendScheme(profile.DefaultAppearance());
+    appendScheme(profile.UnfocusedAppearance());
+    return json;
+}
+
+// Method Description:
+// - Compares these settings to the given, previously loaded ones. Returns the
+//   profiles whose TerminalSettings may differ between the two, so that a
+//   settings reload only needs to update controls using those profiles.
+// - A profile changed if it, one of its parents, or a color scheme it uses
+//   changed, or if it's new. If any of the global settings that feed into
+//   TerminalSettings changed, all profiles changed.
+// Arguments:
+// - previous: the settings to compare these settings to
+// Return Value:
+// - the GUIDs of the changed profiles
+IVectorView<winrt::guid> CascadiaSettings::ChangedProfiles(const Model::CascadiaSettings& previous)
+{
+    auto changed{ winrt::single_threaded_vector<winrt::guid>() };
+    const auto previousImpl{ winrt::get_self<CascadiaSettings>(previous) };
+
+    const auto globalsChanged = _GlobalTerminalSettingsJson(*_globals) != _GlobalTerminalSettingsJson(*previousImpl->_globals);
+
+    std::unordered_map<winrt::guid, Model::Profile> previousProfiles;
+    if (!globalsChanged)
+    {
+        for (const auto& profile : previousImpl->_allProfiles)
+        {
+            previousProfiles.emplace(profile.Guid(), profile);
+        }
+    }
+
+    for (const auto& profile : _allProfiles)
+    {
+        const auto guid{ profile.Guid() };
+        const auto previousProfile{ previousProfiles.find(guid) };
+        if (previousProfile != previousProfiles.end() &&
+            _ProfileTerminalSettingsJson(*_globals, profile) == _ProfileTerminalSettingsJson(*previousImpl->_globals, previousProfile->second))
+        {
+            continue;
+        }
+        changed.Append(guid);
+    }
+
+    return changed.GetView();
+}
+
 winrt::hstring CascadiaSettings::ApplicationDisplayName()
 {
     try
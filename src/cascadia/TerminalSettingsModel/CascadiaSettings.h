@@ -22,6 +22,7 @@ Author(s):
 #include "GlobalAppSettings.h"
 #include "TerminalWarnings.h"
 #include "IDynamicProfileGenerator.h"
+#include "DynamicProfileCache.h"
 
 #include "Profile.h"
 #include "ColorScheme.h"
@@ -34,6 +35,7 @@ namespace SettingsModelLocalTests
     class ProfileTests;
     class ColorSchemeTests;
     class KeyBindingsTests;
+    class SettingsLoadBenchmarks;
 };
 namespace TerminalAppUnitTests
 {
@@ -80,6 +82,7 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
 
         static hstring SettingsPath();
         static hstring DefaultSettingsPath();
+        static hstring DynamicProfileCachePath();
         Model::Profile ProfileDefaults() const;
 
         static winrt::hstring ApplicationDisplayName();
@@ -89,6 +92,7 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
         Model::Profile FindProfile(guid profileGuid) const noexcept;
         Model::ColorScheme GetColorSchemeForProfile(const guid profileGuid) const;
         void UpdateColorSchemeReferences(const hstring oldName, const hstring newName);
+        Windows::Foundation::Collections::IVectorView<guid> ChangedProfiles(const Model::CascadiaSettings& previous);
 
         Windows::Foundation::Collections::IVectorView<SettingsLoadWarnings> Warnings();
         void ClearWarnings();
@@ -117,18 +121,28 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
         Windows::Foundation::Collections::IObservableVector<Model::DefaultTerminal> _defaultTerminals;
         Model::DefaultTerminal _currentDefaultTerminal;
 
-        std::vector<std::unique_ptr<::Microsoft::Terminal::Settings::Model::IDynamicProfileGenerator>> _profileGenerators;
+        std::vector<std::shared_ptr<::Microsoft::Terminal::Settings::Model::IDynamicProfileGenerator>> _profileGenerators;
+        std::shared_ptr<::Microsoft::Terminal::Settings::Model::DynamicProfileCache> _dynamicProfileCache;
 
         std::string _userSettingsString;
         Json::Value _userSettings;
         Json::Value _defaultSettings;
         winrt::com_ptr<Profile> _userDefaultProfileSettings{ nullptr };
 
+        // The indices of the profiles in _allProfiles, by their Guid. Used to find
+        // the profile to layer a json object on without testing every profile.
+        // Profiles appended to _allProfiles are indexed lazily, on the next lookup.
+        std::unordered_map<winrt::guid, std::vector<uint32_t>> _profileIndicesByGuid;
+        uint32_t _indexedProfileCount{ 0 };
+
         void _LayerOrCreateProfile(const Json::Value& profileJson);
         winrt::com_ptr<implementation::Profile> _FindMatchingProfile(const Json::Value& profileJson);
         std::optional<uint32_t> _FindMatchingProfileIndex(const Json::Value& profileJson);
+        void _IndexProfile(const uint32_t index);
+        void _InvalidateProfileIndex() noexcept;
         void _LayerOrCreateColorScheme(const Json::Value& schemeJson);
-        Json::Value _ParseUtf8JsonString(std::string_view fileData);
+        static Json::Value _ParseUtf8JsonString(std::string_view fileData);
+        static const Json::Value& _DefaultSettingsJson();
 
         winrt::com_ptr<implementation::ColorScheme> _FindMatchingColorScheme(const Json::Value& schemeJson);
         void _ParseJsonString(std::string_view fileData, const bool isDefaultSettings);
@@ -173,6 +187,7 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
         friend class SettingsModelLocalTests::ProfileTests;
         friend class SettingsModelLocalTests::ColorSchemeTests;
         friend class SettingsModelLocalTests::KeyBindingsTests;
+        friend class SettingsModelLocalTests::SettingsLoadBenchmarks;
         friend class TerminalAppUnitTests::DynamicProfileTests;
         friend class TerminalAppUnitTests::JsonTests;
     };
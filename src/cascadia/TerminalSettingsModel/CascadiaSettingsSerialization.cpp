@@ -6,14 +6,18 @@
 
 #include <fmt/chrono.h>
 #include <shlobj.h>
+#include <til/metrics.h>
 
 // defaults.h is a file containing the default json settings in a std::string_view
 #include "defaults.h"
 #include "defaults-universal.h"
+// defaults-snapshot.h contains the same settings as defaults.h, flattened into
+// a JsonSnapshot that doesn't need to be parsed.
+#include "JsonSnapshot.h"
+#include "defaults-snapshot.h"
 // userDefault.h is like the above, but with a default template for the user's settings.json.
 #include "userDefaults.h"
-// Both defaults.h and userDefaults.h are generated at build time into the
-// "Generated Files" directory.
+// All of these are generated at build time into the "Generated Files" directory.
 
 #include "ApplicationState.h"
 #include "FileUtils.h"
@@ -50,6 +54,16 @@ static constexpr std::wstring_view FragmentsPath{ L"\\Microsoft\\Windows Termina
 
 static constexpr std::string_view AppExtensionHostName{ "com.microsoft.windows.terminal.settings" };
 
+static til::metrics::histogram s_loadTotalTime{ "settings.load.total_ns" };
+static til::metrics::histogram s_loadDefaultsTime{ "settings.load.defaults_ns" };
+static til::metrics::histogram s_loadUserSettingsTime{ "settings.load.user_settings_ns" };
+static til::metrics::histogram s_loadFirstRunTime{ "settings.load.first_run_ns" };
+static til::metrics::histogram s_loadDynamicProfilesTime{ "settings.load.dynamic_profiles_ns" };
+static til::metrics::histogram s_loadFragmentsTime{ "settings.load.fragments_ns" };
+static til::metrics::histogram s_loadLayerTime{ "settings.load.layer_ns" };
+static til::metrics::histogram s_loadWriteTime{ "settings.load.write_ns" };
+static til::metrics::histogram s_loadValidateTime{ "settings.load.validate_ns" };
+
 // Function Description:
 // - Extracting the value from an async task (like talking to the app catalog) when we are on the
 //   UI thread causes C++/WinRT to complain quite loudly (and halt execution!)
@@ -77,6 +91,54 @@ static auto _extractValueFromTaskWithoutMainThreadAwait(TTask&& task) -> decltyp
     return *finalVal;
 }
 
+// The state shared between _LoadDynamicProfiles and a generator running in the background.
+struct DynamicProfileRun
+{
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool done{ false };
+    std::vector<winrt::Microsoft::Terminal::Settings::Model::Profile> profiles;
+};
+
+// Function Description:
+// - Runs a dynamic profile generator on a background thread and hands its
+//   profiles to _LoadDynamicProfiles through the given run. The cache is
+//   updated even if _LoadDynamicProfiles stopped waiting for the generator.
+// Arguments:
+// - generator: the generator to run
+// - cache: the cache to update with the generated profiles, may be null
+// - run: receives the generated profiles
+static winrt::fire_and_forget _RunDynamicProfileGenerator(std::shared_ptr<IDynamicProfileGenerator> generator,
+                                                          std::shared_ptr<DynamicProfileCache> cache,
+                                                          std::shared_ptr<DynamicProfileRun> run)
+{
+    co_await winrt::resume_background();
+
+    const std::wstring generatorNamespace{ generator->GetNamespace() };
+    std::vector<winrt::Microsoft::Terminal::Settings::Model::Profile> profiles;
+    try
+    {
+        profiles = generator->GenerateProfiles();
+        for (auto& profile : profiles)
+        {
+            profile.Source(generatorNamespace);
+        }
+
+        if (cache)
+        {
+            cache->Store(generatorNamespace, profiles);
+        }
+    }
+    CATCH_LOG_MSG("Dynamic Profile Namespace: \"%ls\"", generatorNamespace.data());
+
+    {
+        std::scoped_lock lock{ run->mutex };
+        run->profiles = std::move(profiles);
+        run->done = true;
+    }
+    run->cv.notify_all();
+}
+
 static std::tuple<size_t, size_t> _LineAndColumnFromPosition(const std::string_view string, ptrdiff_t position)
 {
     size_t line = 1, column = position + 1;
@@ -139,14 +201,21 @@ static void _CatchRethrowSerializationExceptionWithLocationInfo(std::string_view
 // - Also runs and dynamic profile generators. If any of those generators create
 //   new profiles, we'll write the user settings back to the file, with the new
 //   profiles inserted into their list of profiles.
+// - The user's settings are parsed exactly once. Changes we make to the
+//   settings string are applied to the parsed settings as well.
+// - The time spent in each phase is recorded in the "settings.load.*" metrics.
 // Return Value:
 // - a unique_ptr containing a new CascadiaSettings object.
 winrt::Microsoft::Terminal::Settings::Model::CascadiaSettings CascadiaSettings::LoadAll()
 {
+    til::metrics::scoped_timer totalTimer{ s_loadTotalTime };
     try
     {
-        auto settings = LoadDefaults();
-        auto resultPtr = winrt::get_self<CascadiaSettings>(settings);
+        winrt::com_ptr<CascadiaSettings> resultPtr;
+        {
+            til::metrics::scoped_timer timer{ s_loadDefaultsTime };
+            resultPtr.copy_from(winrt::get_self<CascadiaSettings>(LoadDefaults()));
+        }
         resultPtr->ClearWarnings();
 
         // GH 3588, we need this below to know if the user chose something that wasn't our default.
@@ -154,24 +223,32 @@ winrt::Microsoft::Terminal::Settings::Model::CascadiaSettings CascadiaSettings::
         // the user's preferences are loaded and layered.
         const auto hardcodedDefaultGuid = resultPtr->GlobalSettings().DefaultProfile();
 
-        std::optional<std::string> fileData = _ReadUserSettings();
-        const bool foundFile = fileData.has_value();
-
-        // Make sure the file isn't totally empty. If it is, we'll treat the file
-        // like it doesn't exist at all.
-        const bool fileHasData = foundFile && !fileData.value().empty();
-        bool needToWriteFile = false;
-        if (fileHasData)
+        bool fileHasData;
         {
-            resultPtr->_ParseJsonString(fileData.value(), false);
+            til::metrics::scoped_timer timer{ s_loadUserSettingsTime };
+            std::optional<std::string> fileData = _ReadUserSettings();
+            const bool foundFile = fileData.has_value();
+
+            // Make sure the file isn't totally empty. If it is, we'll treat the file
+            // like it doesn't exist at all.
+            fileHasData = foundFile && !fileData.value().empty();
+            if (fileHasData)
+            {
+                resultPtr->_ParseJsonString(fileData.value(), false);
+            }
         }
+        bool needToWriteFile = false;
 
         // Load profiles from dynamic profile generators. _userSettings should be
         // created by now, because we're going to check in there for any generators
         // that should be disabled (if the user had any settings.)
-        resultPtr->_LoadDynamicProfiles();
+        {
+            til::metrics::scoped_timer timer{ s_loadDynamicProfilesTime };
+            resultPtr->_LoadDynamicProfiles();
+        }
         try
         {
+            til::metrics::scoped_timer timer{ s_loadFragmentsTime };
             resultPtr->_LoadFragmentExtensions();
         }
         CATCH_LOG();
@@ -181,6 +258,7 @@ winrt::Microsoft::Terminal::Settings::Model::CascadiaSettings CascadiaSettings::
             // We didn't find the user settings. We'll need to create a file
             // to use as the user defaults.
             // For now, just parse our user settings template as their user settings.
+            til::metrics::scoped_timer timer{ s_loadFirstRunTime };
             auto userSettings{ resultPtr->_ApplyFirstRunChangesToSettingsTemplate(UserSettingsJson) };
             resultPtr->_ParseJsonString(userSettings, false);
             needToWriteFile = true;
@@ -188,6 +266,8 @@ winrt::Microsoft::Terminal::Settings::Model::CascadiaSettings CascadiaSettings::
 
         try
         {
+            til::metrics::scoped_timer timer{ s_loadLayerTime };
+
             // See microsoft/terminal#2325: find the defaultSettings from the user's
             // settings. Layer those settings upon all the existing profiles we have
             // (defaults and dynamic profiles). We'll also set
@@ -204,46 +284,45 @@ winrt::Microsoft::Terminal::Settings::Model::CascadiaSettings CascadiaSettings::
             _CatchRethrowSerializationExceptionWithLocationInfo(resultPtr->_userSettingsString);
         }
 
-        // After layering the user settings, check if there are any new profiles
-        // that need to be inserted into their user settings file.
-        needToWriteFile = resultPtr->_AppendDynamicProfilesToUserSettings() || needToWriteFile;
-
-        if (needToWriteFile)
         {
-            // For safety's sake, we need to re-parse the JSON document to ensure that
-            // all future patches are applied with updated object offsets.
-            resultPtr->_ParseJsonString(resultPtr->_userSettingsString, false);
-        }
-
-        // Make sure there's a $schema at the top of the file.
-        needToWriteFile = resultPtr->_PrependSchemaDirective() || needToWriteFile;
-
-        // TODO:GH#2721 If powershell core is installed, we need to set that to the
-        // default profile, but only when the settings file was newly created. We'll
-        // re-write the segment of the user settings for "default profile" to have
-        // the powershell core GUID instead.
-
-        // If we created the file, or found new dynamic profiles, write the user
-        // settings string back to the file.
-        if (needToWriteFile)
-        {
-            // If AppendDynamicProfilesToUserSettings (or the pwsh check above)
-            // changed the file, then our local settings JSON is no longer accurate.
-            // We should re-parse, but not re-layer
-            resultPtr->_ParseJsonString(resultPtr->_userSettingsString, false);
-
-            try
-            {
-                WriteUTF8FileAtomic(_SettingsPath(), resultPtr->_userSettingsString);
-            }
-            catch (...)
+            til::metrics::scoped_timer timer{ s_loadWriteTime };
+
+            // After layering the user settings, check if there are any new profiles
+            // that need to be inserted into their user settings file.
+            // This only inserts text after the start of the root object, which is
+            // the only offset _PrependSchemaDirective relies on, so there's no need
+            // to re-parse the settings string in between.
+            needToWriteFile = resultPtr->_AppendDynamicProfilesToUserSettings() || needToWriteFile;
+
+            // Make sure there's a $schema at the top of the file.
+            needToWriteFile = resultPtr->_PrependSchemaDirective() || needToWriteFile;
+
+            // TODO:GH#2721 If powershell core is installed, we need to set that to the
+            // default profile, but only when the settings file was newly created. We'll
+            // re-write the segment of the user settings for "default profile" to have
+            // the powershell core GUID instead.
+
+            // If we created the file, or found new dynamic profiles, write the user
+            // settings string back to the file. Both of the above have already
+            // applied their changes to our parsed settings too.
+            if (needToWriteFile)
             {
-                resultPtr->AppendWarning(SettingsLoadWarnings::FailedToWriteToSettings);
+                try
+                {
+                    WriteUTF8FileAtomic(_SettingsPath(), resultPtr->_userSettingsString);
+                }
+                catch (...)
+                {
+                    resultPtr->AppendWarning(SettingsLoadWarnings::FailedToWriteToSettings);
+                }
             }
         }
 
         // If this throws, the app will catch it and use the default settings
-        resultPtr->_ValidateSettings();
+        {
+            til::metrics::scoped_timer timer{ s_loadValidateTime };
+            resultPtr->_ValidateSettings();
+        }
 
         return *resultPtr;
     }
@@ -315,7 +394,7 @@ winrt::Microsoft::Terminal::Settings::Model::CascadiaSettings CascadiaSettings::
     // We already have the defaults in memory, because we stamp them into a
     // header as part of the build process. We don't need to bother with reading
     // them from a file (and the potential that could fail)
-    resultPtr->_ParseJsonString(DefaultJson, true);
+    resultPtr->_defaultSettings = _DefaultSettingsJson();
     resultPtr->LayerJson(resultPtr->_defaultSettings);
     resultPtr->_ResolveDefaultProfile();
     resultPtr->_UpdateActiveProfiles();
@@ -336,6 +415,9 @@ winrt::Microsoft::Terminal::Settings::Model::CascadiaSettings CascadiaSettings::
 // - Uses the Json::Value _userSettings to check which DPGs should not be run.
 //   If the user settings has any namespaces in the "disabledProfileSources"
 //   property, we'll ensure that any DPGs with a matching namespace _don't_ run.
+// - All DPGs run concurrently. If we have cached profiles for a DPG that
+//   hasn't finished yet, we use those right away instead of waiting for it.
+//   Otherwise we wait for it, up to its timeout.
 // Arguments:
 // - <none>
 // Return Value:
@@ -352,28 +434,50 @@ void CascadiaSettings::_LoadDynamicProfiles()
         }
     }
 
-    const GUID nullGuid{ 0 };
-    for (auto& generator : _profileGenerators)
+    // Start all generators at once...
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<std::tuple<std::wstring, std::chrono::steady_clock::time_point, std::shared_ptr<DynamicProfileRun>>> runs;
+    for (const auto& generator : _profileGenerators)
     {
-        const std::wstring generatorNamespace{ generator->GetNamespace() };
+        std::wstring generatorNamespace{ generator->GetNamespace() };
 
         if (ignoredNamespaces.find(generatorNamespace) != ignoredNamespaces.end())
         {
             // namespace should be ignored
+            continue;
         }
-        else
+
+        auto run = std::make_shared<DynamicProfileRun>();
+        _RunDynamicProfileGenerator(generator, _dynamicProfileCache, run);
+        runs.emplace_back(std::move(generatorNamespace), start + generator->GetTimeout(), std::move(run));
+    }
+
+    // ...and collect their profiles in the order of the generators,
+    // so that the order of the profiles doesn't depend on timing.
+    for (const auto& [generatorNamespace, deadline, run] : runs)
+    {
+        auto cached = _dynamicProfileCache ? _dynamicProfileCache->Load(generatorNamespace) : std::nullopt;
+
+        auto& state = *run;
+        std::unique_lock lock{ state.mutex };
+        if (state.cv.wait_until(lock, cached ? start : deadline, [&state]() { return state.done; }))
         {
-            try
+            for (const auto& profile : state.profiles)
             {
-                auto profiles = generator->GenerateProfiles();
-                for (auto& profile : profiles)
-                {
-                    profile.Source(generatorNamespace);
-
-                    _allProfiles.Append(profile);
-                }
+                _allProfiles.Append(profile);
+            }
+        }
+        else if (cached)
+        {
+            for (auto& profile : *cached)
+            {
+                profile.Source(generatorNamespace);
+                _allProfiles.Append(profile);
             }
-            CATCH_LOG_MSG("Dynamic Profile Namespace: \"%ls\"", generatorNamespace.data());
+        }
+        else
+        {
+            LOG_HR_MSG(HRESULT_FROM_WIN32(ERROR_TIMEOUT), "Dynamic Profile Namespace: \"%ls\"", generatorNamespace.data());
         }
     }
 }
@@ -527,19 +631,21 @@ void CascadiaSettings::_ParseAndLayerFragmentFiles(const std::unordered_set<std:
                     // This stub is meant to be a modification to an existing profile,
                     // try to find the matching profile
                     profileStub[JsonKey(GuidKey)] = profileStub[JsonKey(UpdatesKey)];
-                    auto matchingProfile = _FindMatchingProfile(profileStub);
-                    if (matchingProfile)
+                    const auto matchingIndex = _FindMatchingProfileIndex(profileStub);
+                    if (matchingIndex)
                     {
                         try
                         {
                             // We found a matching profile, create a child of it and put the modifications there
                             // (we add a new inheritance layer)
+                            const auto matchingProfile{ winrt::get_self<Profile>(_allProfiles.GetAt(*matchingIndex)) };
                             auto childImpl{ matchingProfile->CreateChild() };
                             childImpl->LayerJson(profileStub);
                             childImpl->Origin(OriginTag::Fragment);
 
                             // replace parent in _profiles with child
-                            _allProfiles.SetAt(_FindMatchingProfileIndex(matchingProfile->ToJson()).value(), *childImpl);
+                            _allProfiles.SetAt(*matchingIndex, *childImpl);
+                            _IndexProfile(*matchingIndex);
                         }
                         catch (...)
                         {
@@ -626,6 +732,94 @@ void CascadiaSettings::_ParseJsonString(std::string_view fileData, const bool is
     }
 }
 
+// Function Description:
+// - Turns a JsonSnapshot, which was generated from a JSON document at build
+//   time, back into the Json::Value that parsing the document would've given.
+// Arguments:
+// - nodes: the nodes of the snapshot
+// Return value:
+// - the document the snapshot was generated from
+static Json::Value _JsonFromSnapshot(const gsl::span<const JsonSnapshot::Node> nodes)
+{
+    using JsonSnapshot::Kind;
+
+    Json::Value root;
+    // The objects and arrays that are still open. The values in them never
+    // move, because we only ever add members to the innermost one.
+    std::vector<Json::Value*> parents;
+
+    for (const auto& node : nodes)
+    {
+        if (node.kind == Kind::End)
+        {
+            parents.pop_back();
+            continue;
+        }
+
+        Json::Value value;
+        switch (node.kind)
+        {
+        case Kind::BeginObject:
+            value = Json::Value{ Json::ValueType::objectValue };
+            break;
+        case Kind::BeginArray:
+            value = Json::Value{ Json::ValueType::arrayValue };
+            break;
+        case Kind::String:
+            value = Json::Value{ node.string.data(), node.string.data() + node.string.size() };
+            break;
+        case Kind::Int:
+            value = Json::Value{ static_cast<Json::Int64>(node.number) };
+            break;
+        case Kind::Real:
+            value = Json::Value{ node.number };
+            break;
+        case Kind::Bool:
+            value = Json::Value{ node.number != 0 };
+            break;
+        default:
+            break;
+        }
+
+        Json::Value* added;
+        if (parents.empty())
+        {
+            root = std::move(value);
+            added = &root;
+        }
+        else if (parents.back()->isArray())
+        {
+            added = &parents.back()->append(std::move(value));
+        }
+        else
+        {
+            added = &((*parents.back())[JsonKey(node.key)] = std::move(value));
+        }
+
+        if (node.kind == Kind::BeginObject || node.kind == Kind::BeginArray)
+        {
+            parents.emplace_back(added);
+        }
+    }
+
+    return root;
+}
+
+// Function Description:
+// - Returns the contents of defaults.json. They're stamped into our binary at
+//   build time as a JsonSnapshot, so they don't need to be parsed, not even on
+//   the first load. They never change, so we only build them once per process
+//   and hand out copies of the result on every settings reload.
+// Arguments:
+// - <none>
+// Return value:
+// - the contents of defaults.json
+const Json::Value& CascadiaSettings::_DefaultSettingsJson()
+{
+    static const auto json{ _JsonFromSnapshot(DefaultJsonSnapshot) };
+    return json;
+}
+
 // Method Description:
 // - Attempts to read the given data as a string of JSON and parse that JSON
 //   into a Json::Value
@@ -679,6 +873,9 @@ bool CascadiaSettings::_PrependSchemaDirective()
     {
         _userSettingsString.insert(offset, ",");
     }
+
+    // Make the same change to the parsed settings, so we don't need to parse them again.
+    JsonUtils::SetValueForKey(_userSettings, SchemaKey, JsonKey(SchemaValue));
     return true;
 }
 
@@ -711,19 +908,33 @@ bool CascadiaSettings::_AppendDynamicProfilesToUserSettings()
     wbuilder.settings_["indentation"] = "    ";
     wbuilder.settings_["enableYAMLCompatibility"] = true; // suppress spaces around colons
 
-    auto isInJsonObj = [](const auto& profile, const auto& json) {
-        for (auto profileJson : _GetProfilesJsonObject(json))
+    // Group the profiles in the user and default settings by the guid of the
+    // profile they'd be layered on, so we only need to test a profile against
+    // the json objects with a matching guid, instead of all of them.
+    std::unordered_map<winrt::guid, std::vector<const Json::Value*>> profilesJsonByGuid;
+    for (const auto json : { &_userSettings, &_defaultSettings })
+    {
+        for (const auto& profileJson : _GetProfilesJsonObject(*json))
         {
             if (profileJson.isObject())
             {
-                const auto profileImpl = winrt::get_self<implementation::Profile>(profile);
-                if (profileImpl->ShouldBeLayered(profileJson))
+                profilesJsonByGuid[Profile::GetLayeringGuidForJson(profileJson)].emplace_back(&profileJson);
+            }
+        }
+    }
+
+    auto isInJsonObj = [&](const auto& profile) {
+        const auto candidates = profilesJsonByGuid.find(profile.Guid());
+        if (candidates != profilesJsonByGuid.end())
+        {
+            const auto profileImpl = winrt::get_self<implementation::Profile>(profile);
+            for (const auto profileJson : candidates->second)
+            {
+                // A json object with the same guid might still have a different source.
+                if (profileImpl->ShouldBeLayered(*profileJson))
                 {
                     return true;
                 }
-                // If the profileJson doesn't have a GUID, then it might be in
-                // the file still. We returned false because it shouldn't be
-                // layered, but it might be a name-only profile.
             }
         }
         return false;
@@ -742,11 +953,12 @@ bool CascadiaSettings::_AppendDynamicProfilesToUserSettings()
     const std::string indentation{ _userSettingsString, lastProfileIndentStartsAt + 1, lastProfile.getOffsetStart() - lastProfileIndentStartsAt - 1 };
 
     bool changedFile = false;
+    std::vector<Json::Value> appendedProfiles;
 
     for (const auto& profile : _allProfiles)
     {
         // Skip profiles that are in the user settings or the default settings.
-        if (isInJsonObj(profile, _userSettings) || isInJsonObj(profile, _defaultSettings))
+        if (isInJsonObj(profile))
         {
             continue;
         }
@@ -754,7 +966,7 @@ bool CascadiaSettings::_AppendDynamicProfilesToUserSettings()
         // Generate a diff for the profile, that contains the minimal set of
         // changes to re-create this profile.
         const auto profileImpl = winrt::get_self<implementation::Profile>(profile);
-        const auto diff = profileImpl->GenerateStub();
+        auto diff = profileImpl->GenerateStub();
 
         auto profileSerialization = Json::writeString(wbuilder, diff);
 
@@ -781,6 +993,20 @@ bool CascadiaSettings::_AppendDynamicProfilesToUserSettings()
         // Write the profile's serialization to the file
         _userSettingsString.insert(currentInsertIndex, profileSerialization);
         currentInsertIndex += profileSerialization.size();
+
+        appendedProfiles.emplace_back(std::move(diff));
+    }
+
+    // Make the same changes to the parsed settings, so we don't need to parse
+    // them again. We do this last, because profilesJsonByGuid points into them.
+    if (!appendedProfiles.empty())
+    {
+        auto& profilesProperty = _userSettings[JsonKey(ProfilesKey)];
+        auto& profilesList = profilesProperty.isArray() ? profilesProperty : profilesProperty[JsonKey(ProfilesListKey)];
+        for (auto& profileJson : appendedProfiles)
+        {
+            profilesList.append(std::move(profileJson));
+        }
     }
 
     return changedFile;
@@ -887,6 +1113,9 @@ void CascadiaSettings::_LayerOrCreateProfile(const Json::Value& profileJson)
             _allProfiles.SetAt(*profileIndex, *childImpl);
             profile = std::move(childImpl);
         }
+
+        // Layering may have changed the profile's name and with it its Guid.
+        _IndexProfile(*profileIndex);
     }
     else
     {
@@ -944,6 +1173,9 @@ winrt::com_ptr<Profile> CascadiaSettings::_FindMatchingProfile(const Json::Value
 //   object. Uses Profile::ShouldBeLayered to determine if the Json::Value is a
 //   match or not. This method should be used to find a profile to layer the
 //   given settings upon.
+// - Only the profiles with the Guid the json object would be layered on are
+//   tested, which we look up in _profileIndicesByGuid. Profiles that were
+//   appended to _allProfiles since the last call are indexed first.
 // - Returns nullopt if no such match exists.
 // Arguments:
 // - json: an object which may be a partial serialization of a Profile object.
@@ -951,7 +1183,27 @@ winrt::com_ptr<Profile> CascadiaSettings::_FindMatchingProfile(const Json::Value
 // - The index for the matching Profile, iff it exists. Otherwise, nullopt.
 std::optional<uint32_t> CascadiaSettings::_FindMatchingProfileIndex(const Json::Value& profileJson)
 {
-    for (uint32_t i = 0; i < _allProfiles.Size(); ++i)
+    const auto size = _allProfiles.Size();
+    if (size < _indexedProfileCount)
+    {
+        // Profiles were removed without us noticing. Start over.
+        _InvalidateProfileIndex();
+    }
+    for (; _indexedProfileCount < size; ++_indexedProfileCount)
+    {
+        _profileIndicesByGuid[_allProfiles.GetAt(_indexedProfileCount).Guid()].emplace_back(_indexedProfileCount);
+    }
+
+    const auto candidates = _profileIndicesByGuid.find(Profile::GetLayeringGuidForJson(profileJson));
+    if (candidates == _profileIndicesByGuid.end())
+    {
+        return std::nullopt;
+    }
+
+    // The indices are sorted, so this returns the first matching profile, just
+    // like testing every profile in order would. An index may be stale if the
+    // profile's Guid changed since, which is why we still test each candidate.
+    for (const auto i : candidates->second)
     {
         const auto profile{ _allProfiles.GetAt(i) };
         const auto profileImpl = winrt::get_self<Profile>(profile);
@@ -963,6 +1215,43 @@ std::optional<uint32_t> CascadiaSettings::_FindMatchingProfileIndex(const Json::
     return std::nullopt;
 }
 
+// Method Description:
+// - Adds the profile at the given index in _allProfiles to _profileIndicesByGuid,
+//   under its current Guid. Needs to be called whenever a profile in _allProfiles
+//   is replaced or modified in a way that may change its Guid.
+// Arguments:
+// - index: the index of the profile in _allProfiles
+// Return Value:
+// - <none>
+void CascadiaSettings::_IndexProfile(const uint32_t index)
+{
+    if (index >= _indexedProfileCount)
+    {
+        // Not indexed yet. _FindMatchingProfileIndex will pick it up.
+        return;
+    }
+
+    auto& indices = _profileIndicesByGuid[_allProfiles.GetAt(index).Guid()];
+    const auto it = std::lower_bound(indices.begin(), indices.end(), index);
+    if (it == indices.end() || *it != index)
+    {
+        indices.insert(it, index);
+    }
+}
+
+// Method Description:
+// - Forgets about all indexed profiles. Needs to be called whenever profiles
+//   are removed from or moved around in _allProfiles.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void CascadiaSettings::_InvalidateProfileIndex() noexcept
+{
+    _profileIndicesByGuid.clear();
+    _indexedProfileCount = 0;
+}
+
 // Method Description:
 // - Finds the "default profile settings" if they exist in the users settings,
 //   and applies them to the existing profiles. The "default profile settings"
@@ -1009,6 +1298,7 @@ void CascadiaSettings::_ApplyDefaultsFromUserSettings()
 
         // replace parent in _profiles with child
         _allProfiles.SetAt(profileIndex, *childImpl);
+        _IndexProfile(profileIndex);
     }
 }
 
@@ -1099,6 +1389,18 @@ winrt::hstring CascadiaSettings::SettingsPath()
     return winrt::hstring{ _SettingsPath().wstring() };
 }
 
+// function Description:
+// - Returns the full path to the file that caches the profiles of the dynamic
+//   profile generators. It's next to the settings file. See DynamicProfileCache.
+// Arguments:
+// - <none>
+// Return Value:
+// - the full path to the dynamic profile cache
+winrt::hstring CascadiaSettings::DynamicProfileCachePath()
+{
+    return winrt::hstring{ DynamicProfileCache::DefaultPath().wstring() };
+}
+
 winrt::hstring CascadiaSettings::DefaultSettingsPath()
 {
     // Both of these posts suggest getting the path to the exe, then removing
@@ -0,0 +1,133 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "pch.h"
+#include "DynamicProfileCache.h"
+
+#include "FileUtils.h"
+
+using namespace ::Microsoft::Terminal::Settings::Model;
+using namespace winrt::Microsoft::Terminal::Settings::Model;
+
+static constexpr std::wstring_view CacheFilename{ L"dynamicProfiles.json" };
+
+// Returns the process-wide cache, stored next to the settings.json.
+const std::shared_ptr<DynamicProfileCache>& DynamicProfileCache::SharedInstance()
+{
+    static const auto cache = std::make_shared<DynamicProfileCache>(DefaultPath());
+    return cache;
+}
+
+// Returns the path of the dynamicProfiles.json next to the settings.json.
+const std::filesystem::path& DynamicProfileCache::DefaultPath()
+{
+    static const auto path = GetBaseSettingsPath() / CacheFilename;
+    return path;
+}
+
+DynamicProfileCache::DynamicProfileCache(std::filesystem::path path) noexcept :
+    _path{ std::move(path) }
+{
+}
+
+const std::filesystem::path& DynamicProfileCache::Path() const noexcept
+{
+    return _path;
+}
+
+// Method Description:
+// - Returns the profiles the given generator produced the last time it ran.
+//   Each call returns new profile objects, which the caller may modify.
+// Arguments:
+// - generatorNamespace: the namespace of the generator
+// Return Value:
+// - the cached profiles, or nullopt if the generator never ran (or the cache is unreadable).
+std::optional<std::vector<Profile>> DynamicProfileCache::Load(const std::wstring_view generatorNamespace)
+try
+{
+    std::scoped_lock lock{ _mutex };
+    _readIfNeeded();
+
+    const auto& json = std::as_const(_root)[til::u16u8(generatorNamespace)];
+    if (!json.isArray())
+    {
+        return std::nullopt;
+    }
+
+    std::vector<Profile> profiles;
+    profiles.reserve(json.size());
+    for (const auto& profileJson : json)
+    {
+        profiles.emplace_back(*implementation::Profile::FromJson(profileJson));
+    }
+    return profiles;
+}
+catch (...)
+{
+    LOG_CAUGHT_EXCEPTION();
+    return std::nullopt;
+}
+
+// Method Description:
+// - Replaces the cached profiles of the given generator and writes the cache
+//   back to disk, unless nothing changed.
+// Arguments:
+// - generatorNamespace: the namespace of the generator
+// - profiles: the profiles the generator just produced
+// Return Value:
+// - true if the cache changed.
+bool DynamicProfileCache::Store(const std::wstring_view generatorNamespace, const std::vector<Profile>& profiles)
+{
+    Json::Value json{ Json::arrayValue };
+    for (const auto& profile : profiles)
+    {
+        json.append(winrt::get_self<implementation::Profile>(profile)->ToJson());
+    }
+
+    std::scoped_lock lock{ _mutex };
+    _readIfNeeded();
+
+    auto& cached = _root[til::u16u8(generatorNamespace)];
+    if (cached == json)
+    {
+        return false;
+    }
+
+    cached = std::move(json);
+    _write();
+    return true;
+}
+
+void DynamicProfileCache::_readIfNeeded()
+{
+    if (_loaded)
+    {
+        return;
+    }
+    _loaded = true;
+
+    const auto data = ReadUTF8FileIfExists(_path).value_or(std::string{});
+    if (data.empty())
+    {
+        return;
+    }
+
+    std::string errs;
+    std::unique_ptr<Json::CharReader> reader{ Json::CharReaderBuilder::CharReaderBuilder().newCharReader() };
+
+    Json::Value root;
+    if (reader->parse(data.data(), data.data() + data.size(), &root, &errs) && root.isObject())
+    {
+        _root = std::move(root);
+    }
+}
+
+// Errors are only logged: the cache is just an optimization.
+void DynamicProfileCache::_write() const
+try
+{
+    Json::StreamWriterBuilder wbuilder;
+    const auto content = Json::writeString(wbuilder, _root);
+    WriteUTF8FileAtomic(_path, content);
+}
+CATCH_LOG()
@@ -0,0 +1,43 @@
+/*++
+Copyright (c) Microsoft Corporation
+Licensed under the MIT license.
+
+Module Name:
+- DynamicProfileCache.h
+
+Abstract:
+- Remembers the profiles each dynamic profile generator produced the last time
+  it ran, in dynamicProfiles.json next to the settings. This allows us to load
+  the settings without waiting for slow generators (like the WSL one, which has
+  to wait for wsl.exe): their cached profiles are used instead, and once their
+  fresh results arrive the cache is updated. If that changes the cache file,
+  the app reloads the settings, just like it does when settings.json changes.
+--*/
+#pragma once
+
+#include "Profile.h"
+
+namespace Microsoft::Terminal::Settings::Model
+{
+    class DynamicProfileCache final
+    {
+    public:
+        static const std::shared_ptr<DynamicProfileCache>& SharedInstance();
+        static const std::filesystem::path& DefaultPath();
+
+        DynamicProfileCache(std::filesystem::path path) noexcept;
+
+        const std::filesystem::path& Path() const noexcept;
+        std::optional<std::vector<winrt::Microsoft::Terminal::Settings::Model::Profile>> Load(const std::wstring_view generatorNamespace);
+        bool Store(const std::wstring_view generatorNamespace, const std::vector<winrt::Microsoft::Terminal::Settings::Model::Profile>& profiles);
+
+    private:
+        void _readIfNeeded();
+        void _write() const;
+
+        std::filesystem::path _path;
+        std::mutex _mutex;
+        bool _loaded{ false };
+        Json::Value _root{ Json::objectValue };
+    };
+}
@@ -13,6 +13,8 @@ Abstract:
 - Each DPG must have a unique namespace to associate with itself. If the
   namespace is not unique, the generator risks affecting profiles from
   conflicting generators.
+- All DPGs run concurrently, each on a background thread. If a DPG doesn't
+  finish within its timeout, the settings are loaded without its profiles.
 
 Author(s):
 - Mike Griese - August 2019
@@ -33,5 +35,6 @@ public:
     virtual ~IDynamicProfileGenerator() = 0;
     virtual std::wstring_view GetNamespace() = 0;
     virtual std::vector<winrt::Microsoft::Terminal::Settings::Model::Profile> GenerateProfiles() = 0;
+    virtual std::chrono::milliseconds GetTimeout() { return std::chrono::seconds{ 5 }; }
 };
 inline Microsoft::Terminal::Settings::Model::IDynamicProfileGenerator::~IDynamicProfileGenerator() {}
@@ -0,0 +1,40 @@
+/*++
+Copyright (c) Microsoft Corporation
+Licensed under the MIT license.
+
+Module Name:
+- JsonSnapshot.h
+
+Abstract:
+- A JSON document flattened into an array of nodes at build time, by
+  tools/GenerateSnapshotForJson.ps1. Turning it into a Json::Value only
+  needs to walk the array, there's no text left to parse.
+- The nodes are in document order. Objects and arrays are opened by a
+  BeginObject or BeginArray node and closed by an End node. The members
+  of an object carry their name in key.
+--*/
+
+#pragma once
+
+namespace JsonSnapshot
+{
+    enum class Kind : uint8_t
+    {
+        BeginObject,
+        BeginArray,
+        End,
+        String,
+        Int,
+        Real,
+        Bool,
+        Null
+    };
+
+    struct Node
+    {
+        Kind kind;
+        std::string_view key; // the name of the member, if the parent is an object
+        std::string_view string; // the value of a String
+        double number; // the value of an Int, Real or Bool
+    };
+}
@@ -265,26 +265,13 @@ bool Profile::ShouldBeLayered(const Json::Value& json) const
 {
     // First, check that GUIDs match. This is easy. If they don't match, they
     // should _definitely_ not layer.
-    const auto otherGuid{ JsonUtils::GetValueForKey<std::optional<winrt::guid>>(json, GuidKey) };
-    const auto otherSource{ JsonUtils::GetValueForKey<std::optional<winrt::hstring>>(json, SourceKey) };
-    if (otherGuid)
-    {
-        if (otherGuid.value() != Guid())
-        {
-            return false;
-        }
-    }
-    else
+    if (GetLayeringGuidForJson(json) != Guid())
     {
-        // If the other json object didn't have a GUID,
-        // check if we auto-generate the same guid using the name and source.
-        const auto otherName{ JsonUtils::GetValueForKey<std::optional<winrt::hstring>>(json, NameKey) };
-        if (Guid() != _GenerateGuidForProfile(otherName ? *otherName : L"Default", otherSource ? *otherSource : L""))
-        {
-            return false;
-        }
+        return false;
     }
 
+    const auto otherSource{ JsonUtils::GetValueForKey<std::optional<winrt::hstring>>(json, SourceKey) };
+
     // For profiles with a `source`, also check the `source` property.
     bool sourceMatches = false;
     const auto mySource{ Source() };
@@ -516,6 +503,28 @@ winrt::guid Profile::GetGuidOrGenerateForJson(const Json::Value& json) noexcept
     return Profile::_GenerateGuidForProfile(name, source);
 }
 
+// Function Description:
+// - Returns the GUID a profile must have for the given JSON object to be
+//   layered on it (see ShouldBeLayered). This is the json's `guid`, or if it
+//   has none, the guid we'd auto-generate using its name and source.
+// - Unlike GetGuidOrGenerateForJson, a json object without a name is treated
+//   like a profile named "Default", just like a Profile without a name.
+// Arguments:
+// - json: the JSON object to get the GUID for
+// Return Value:
+// - The GUID of the profiles the json object may be layered on.
+winrt::guid Profile::GetLayeringGuidForJson(const Json::Value& json)
+{
+    if (const auto guid{ JsonUtils::GetValueForKey<std::optional<winrt::guid>>(json, GuidKey) })
+    {
+        return *guid;
+    }
+
+    const auto name{ JsonUtils::GetValueForKey<std::optional<winrt::hstring>>(json, NameKey) };
+    const auto source{ JsonUtils::GetValueForKey<std::optional<winrt::hstring>>(json, SourceKey) };
+    return _GenerateGuidForProfile(name ? *name : L"Default", source ? *source : L"");
+}
+
 // Method Description:
 // - Create a new serialized JsonObject from an instance of this class
 // Arguments:
@@ -51,6 +51,8 @@ class TerminalCoreUnitTests::TerminalBufferTests final
 
     TEST_METHOD(TestGetReverseTab);
 
+    TEST_METHOD(TestChunkedExportThroughResize);
+
     TEST_METHOD_SETUP(MethodSetup)
     {
         // STEP 1: Set up the Terminal
@@ -592,3 +594,69 @@ void TerminalBufferTests::TestGetReverseTab()
                          L"Cursor adjusted to last item in the sample list from position beyond end.");
     }
 }
+
+void TerminalBufferTests::TestChunkedExportThroughResize()
+{
+    auto& termSm = *term->_stateMachine;
+    const auto expectedLines = [](const std::string_view prefix, const size_t first, const size_t last) {
+        std::string lines;
+        for (auto i = first; i < last; ++i)
+        {
+            fmt::format_to(std::back_inserter(lines), "{} {}\r\n", prefix, i);
+        }
+        return lines;
+    };
+
+    for (auto i = 0; i < 40; ++i)
+    {
+        termSm.ProcessString(fmt::format(L"line {}\r\n", i));
+    }
+
+    Log::Comment(L"The export covers the 40 lines plus the row of the cursor.");
+    auto state = term->BeginBufferExport(TextBuffer::ExportFormat::PlainText);
+    VERIFY_ARE_EQUAL(size_t{ 41 }, state.endRow - state.firstRow);
+
+    std::string out;
+    term->ExportBufferRows(state, out, 10);
+    VERIFY_ARE_EQUAL(expectedLines("line", 0, 10), out);
+    VERIFY_ARE_EQUAL(size_t{ 0 }, state.skippedRows);
+    VERIFY_IS_FALSE(state.IsDone());
+
+    Log::Comment(L"Circle the buffer, so that some of the rows scroll out before they're exported.");
+    for (auto i = 0; i < 110; ++i)
+    {
+        termSm.ProcessString(fmt::format(L"more {}\r\n", i));
+    }
+    VERIFY_ARE_EQUAL(size_t{ 19 }, term->_buffer->GetCircledRowCount() - state.firstRow);
+
+    out.clear();
+    term->ExportBufferRows(state, out, 10);
+    VERIFY_ARE_EQUAL(expectedLines("line", 19, 29), out);
+    VERIFY_ARE_EQUAL(size_t{ 9 }, state.skippedRows);
+
+    Log::Comment(L"Changing only the height still replaces the buffer, which must fail the export.");
+    VERIFY_SUCCEEDED(term->UserResize({ TerminalViewWidth, TerminalViewHeight - 10 }));
+    out.clear();
+    VERIFY_THROWS_SPECIFIC(term->ExportBufferRows(state, out, 10), wil::ResultException, [](wil::ResultException& e) { return e.GetErrorCode() == E_CHANGED_STATE; });
+    VERIFY_IS_TRUE(out.empty());
+
+    Log::Comment(L"An export started after the resize runs to completion.");
+    state = term->BeginBufferExport(TextBuffer::ExportFormat::PlainText);
+    while (!state.IsDone())
+    {
+        term->ExportBufferRows(state, out, 10);
+    }
+    VERIFY_ARE_EQUAL(size_t{ 0 }, state.skippedRows);
+    VERIFY_ARE_EQUAL(1.0, state.Progress());
+    VERIFY_ARE_NOT_EQUAL(std::string::npos, out.find(expectedLines("more", 100, 110)));
+
+    Log::Comment(L"Clearing the scrollback moves the rows within the buffer, which must fail the export as well.");
+    state = term->BeginBufferExport(TextBuffer::ExportFormat::PlainText);
+    out.clear();
+    term->ExportBufferRows(state, out, 10);
+    VERIFY_IS_FALSE(state.IsDone());
+    termSm.ProcessString(L"\x1b[3J");
+    out.clear();
+    VERIFY_THROWS_SPECIFIC(term->ExportBufferRows(state, out, 10), wil::ResultException, [](wil::ResultException& e) { return e.GetErrorCode() == E_CHANGED_STATE; });
+    VERIFY_IS_TRUE(out.empty());
+}
@@ -55,6 +55,11 @@ namespace TerminalAppUnitTests
         TEST_METHOD(UserProfilesWithInvalidSourcesAreIgnored);
         // This does the same, but by disabling a profile source
         TEST_METHOD(UserProfilesFromDisabledSourcesDontAppear);
+
+        // Generators run concurrently, each with a timeout, and their profiles are cached.
+        TEST_METHOD(GeneratorsRunConcurrently);
+        TEST_METHOD(SlowGeneratorsTimeOut);
+        TEST_METHOD(CachedProfilesAreUsedUntilGeneratorsFinish);
     };
 
     void DynamicProfileTests::TestSimpleGenerate()
@@ -670,4 +675,142 @@ namespace TerminalAppUnitTests
         VERIFY_ARE_EQUAL(2u, settings->_allProfiles.Size());
     }
 
+    void DynamicProfileTests::GeneratorsRunConcurrently()
+    {
+        const auto generateSlowly = [](std::wstring name) {
+            return [name]() {
+                std::this_thread::sleep_for(std::chrono::milliseconds{ 500 });
+                std::vector<Profile> profiles;
+                Profile p0;
+                p0.Name(name);
+                profiles.push_back(p0);
+                return profiles;
+            };
+        };
+
+        auto gen0 = std::make_unique<TestDynamicProfileGenerator>(L"Terminal.App.UnitTest.0");
+        gen0->pfnGenerate = generateSlowly(L"profile0");
+        auto gen1 = std::make_unique<TestDynamicProfileGenerator>(L"Terminal.App.UnitTest.1");
+        gen1->pfnGenerate = generateSlowly(L"profile1");
+
+        auto settings = winrt::make_self<implementation::CascadiaSettings>(false);
+        settings->_profileGenerators.emplace_back(std::move(gen0));
+        settings->_profileGenerators.emplace_back(std::move(gen1));
+
+        const auto start = std::chrono::steady_clock::now();
+        settings->_LoadDynamicProfiles();
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+
+        Log::Comment(L"Both generators sleep for 500ms. Run one after the other, they'd take a second.");
+        VERIFY_IS_TRUE(elapsed < std::chrono::milliseconds{ 900 });
+
+        Log::Comment(L"The profiles are still in the order of the generators.");
+        VERIFY_ARE_EQUAL(2u, settings->_allProfiles.Size());
+        VERIFY_ARE_EQUAL(L"profile0", settings->_allProfiles.GetAt(0).Name());
+        VERIFY_ARE_EQUAL(L"profile1", settings->_allProfiles.GetAt(1).Name());
+    }
+
+    void DynamicProfileTests::SlowGeneratorsTimeOut()
+    {
+        auto gen0 = std::make_unique<TestDynamicProfileGenerator>(L"Terminal.App.UnitTest.0");
+        gen0->pfnGenerate = []() {
+            std::vector<Profile> profiles;
+            Profile p0;
+            p0.Name(L"profile0");
+            profiles.push_back(p0);
+            return profiles;
+        };
+        auto gen1 = std::make_unique<TestDynamicProfileGenerator>(L"Terminal.App.UnitTest.1");
+        // The generator keeps running after we stopped waiting for it.
+        // Make sure it's done before the test ends.
+        auto generated = std::make_shared<wil::unique_event>(wil::EventOptions::ManualReset);
+        gen1->timeout = std::chrono::milliseconds{ 100 };
+        gen1->pfnGenerate = [generated]() {
+            auto setGenerated = generated->SetEvent_scope_exit();
+            std::this_thread::sleep_for(std::chrono::seconds{ 2 });
+            std::vector<Profile> profiles;
+            Profile p0;
+            p0.Name(L"profile1");
+            profiles.push_back(p0);
+            return profiles;
+        };
+
+        auto settings = winrt::make_self<implementation::CascadiaSettings>(false);
+        settings->_profileGenerators.emplace_back(std::move(gen0));
+        settings->_profileGenerators.emplace_back(std::move(gen1));
+
+        const auto start = std::chrono::steady_clock::now();
+        settings->_LoadDynamicProfiles();
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+
+        Log::Comment(L"We don't wait for the slow generator, and load the settings without its profiles.");
+        VERIFY_IS_TRUE(elapsed < std::chrono::seconds{ 1 });
+        VERIFY_ARE_EQUAL(1u, settings->_allProfiles.Size());
+        VERIFY_ARE_EQUAL(L"profile0", settings->_allProfiles.GetAt(0).Name());
+
+        generated->wait();
+    }
+
+    void DynamicProfileTests::CachedProfilesAreUsedUntilGeneratorsFinish()
+    {
+        const auto cachePath = std::filesystem::temp_directory_path() / L"TerminalApp.UnitTests.dynamicProfiles.json";
+        std::filesystem::remove(cachePath);
+        auto removeCache = wil::scope_exit([&]() { std::filesystem::remove(cachePath); });
+
+        const auto cache = std::make_shared<::Microsoft::Terminal::Settings::Model::DynamicProfileCache>(cachePath);
+        {
+            std::vector<Profile> profiles;
+            Profile p0;
+            p0.Name(L"cached");
+            p0.Source(L"Terminal.App.UnitTest.0");
+            profiles.push_back(p0);
+            VERIFY_IS_TRUE(cache->Store(L"Terminal.App.UnitTest.0", profiles));
+            VERIFY_IS_FALSE(cache->Store(L"Terminal.App.UnitTest.0", profiles));
+        }
+
+        auto gen0 = std::make_unique<TestDynamicProfileGenerator>(L"Terminal.App.UnitTest.0");
+        gen0->pfnGenerate = []() {
+            std::this_thread::sleep_for(std::chrono::milliseconds{ 500 });
+            std::vector<Profile> profiles;
+            Profile p0;
+            p0.Name(L"fresh");
+            profiles.push_back(p0);
+            return profiles;
+        };
+
+        auto settings = winrt::make_self<implementation::CascadiaSettings>(false);
+        settings->_profileGenerators.emplace_back(std::move(gen0));
+        settings->_dynamicProfileCache = cache;
+
+        const auto start = std::chrono::steady_clock::now();
+        settings->_LoadDynamicProfiles();
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+
+        Log::Comment(L"The cached profiles are used without waiting for the generator.");
+        VERIFY_IS_TRUE(elapsed < std::chrono::milliseconds{ 400 });
+        VERIFY_ARE_EQUAL(1u, settings->_allProfiles.Size());
+        VERIFY_ARE_EQUAL(L"cached", settings->_allProfiles.GetAt(0).Name());
+        VERIFY_ARE_EQUAL(L"Terminal.App.UnitTest.0", settings->_allProfiles.GetAt(0).Source());
+
+        Log::Comment(L"Once the generator finishes, its profiles replace the cached ones, on disk too.");
+        std::optional<std::vector<Profile>> cached;
+        for (auto i = 0; i < 50; ++i)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds{ 100 });
+            cached = cache->Load(L"Terminal.App.UnitTest.0");
+            if (cached && cached->size() == 1 && cached->at(0).Name() == L"fresh")
+            {
+                break;
+            }
+        }
+        VERIFY_IS_TRUE(cached.has_value());
+        VERIFY_ARE_EQUAL(1u, cached->size());
+        VERIFY_ARE_EQUAL(L"fresh", cached->at(0).Name());
+
+        ::Microsoft::Terminal::Settings::Model::DynamicProfileCache reloaded{ cachePath };
+        const auto reloadedProfiles = reloaded.Load(L"Terminal.App.UnitTest.0");
+        VERIFY_IS_TRUE(reloadedProfiles.has_value());
+        VERIFY_ARE_EQUAL(L"fresh", reloadedProfiles->at(0).Name());
+    }
+
 };
@@ -28,6 +28,7 @@ public:
         _namespace{ ns } {};
 
     std::wstring_view GetNamespace() override { return _namespace; };
+    std::chrono::milliseconds GetTimeout() override { return timeout; };
 
     std::vector<winrt::Microsoft::Terminal::Settings::Model::Profile> GenerateProfiles() override
     {
@@ -39,6 +40,7 @@ public:
     }
 
     std::wstring _namespace;
+    std::chrono::milliseconds timeout{ std::chrono::seconds{ 5 } };
 
     std::function<std::vector<winrt::Microsoft::Terminal::Settings::Model::Profile>()> pfnGenerate{ nullptr };
 };
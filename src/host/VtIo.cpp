@@ -10,9 +10,13 @@
 
 #include "../renderer/base/renderer.hpp"
 #include "../types/inc/utils.hpp"
+#include "../terminal/parser/stateMachine.hpp"
+#include "../terminal/parser/ascii.hpp"
 #include "input.h" // ProcessCtrlEvents
 #include "output.h" // CloseConsoleProcessState
 
+#include <til/metrics.h>
+
 using namespace Microsoft::Console;
 using namespace Microsoft::Console::Render;
 using namespace Microsoft::Console::VirtualTerminal;
@@ -20,6 +24,119 @@ using namespace Microsoft::Console::Types;
 using namespace Microsoft::Console::Utils;
 using namespace Microsoft::Console::Interactivity;
 
+static til::metrics::counter s_passthroughChars{ "conpty.passthrough.chars" };
+
+// Routine Description:
+// - Determines if a CSI sequence is one of the queries that our own dispatch
+//   answers: DSR (OS and CPR), DA1, DA2, DA3 and DECREQTPARM.
+// Arguments:
+// - parameters - everything between the CSI and the final character
+// - finalChar - the final character of the sequence
+// Return Value:
+// - true if we reply to the sequence ourselves
+static bool _IsAnsweredQuery(std::wstring_view parameters, const wchar_t finalChar) noexcept
+{
+    wchar_t marker = 0;
+    if (!parameters.empty() && parameters.front() >= L'<' && parameters.front() <= L'?')
+    {
+        marker = parameters.front();
+        parameters.remove_prefix(1);
+    }
+
+    // Only the first parameter matters to any of these queries.
+    size_t value = 0;
+    for (const auto wch : parameters.substr(0, parameters.find(L';')))
+    {
+        if (wch < L'0' || wch > L'9' || value > 9)
+        {
+            return false;
+        }
+        value = value * 10 + (wch - L'0');
+    }
+
+    switch (finalChar)
+    {
+    case L'n':
+        return marker == 0 && (value == 5 || value == 6);
+    case L'c':
+        return (marker == 0 || marker == L'>' || marker == L'=') && value == 0;
+    case L'x':
+        return marker == 0 && value <= 1;
+    default:
+        return false;
+    }
+}
+
+// Routine Description:
+// - Returns the given client output the way it needs to be forwarded to the
+//   terminal, so that it does there what it does in our buffer:
+//   - The queries that our own dispatch answers are dropped. The client
+//     mustn't get a second answer from the terminal, which may not answer
+//     them at all. A query that is split across two writes is forwarded as is.
+//   - Unless the client disabled DISABLE_NEWLINE_AUTO_RETURN, we return the
+//     cursor on every line feed, but the terminal doesn't. A CR is inserted
+//     before each line feed that isn't already preceded by one.
+// Arguments:
+// - text - the client's output
+// - returnOnNewline - whether line feeds return the cursor to the left margin
+// Return Value:
+// - the output to forward to the terminal
+static std::wstring _ForwardedOutput(const std::wstring_view text, const bool returnOnNewline)
+{
+    std::wstring result;
+    result.reserve(text.size());
+
+    for (size_t i = 0; i < text.size();)
+    {
+        auto parametersBegin = std::wstring_view::npos;
+        if (text[i] == AsciiChars::ESC && i + 1 < text.size())
+        {
+            // ESC Z is DECID, which we answer just like DA1.
+            if (text[i + 1] == L'Z')
+            {
+                i += 2;
+                continue;
+            }
+            if (text[i + 1] == L'[')
+            {
+                parametersBegin = i + 2;
+            }
+        }
+        else if (text[i] == L'\x9b')
+        {
+            parametersBegin = i + 1;
+        }
+
+        if (parametersBegin != std::wstring_view::npos)
+        {
+            auto parametersEnd = parametersBegin;
+            while (parametersEnd < text.size() && text[parametersEnd] >= L'0' && text[parametersEnd] <= L'?')
+            {
+                ++parametersEnd;
+            }
+
+            if (parametersEnd < text.size() &&
+                _IsAnsweredQuery(text.substr(parametersBegin, parametersEnd - parametersBegin), text[parametersEnd]))
+            {
+                i = parametersEnd + 1;
+                continue;
+            }
+        }
+
+        if (returnOnNewline &&
+            (text[i] == AsciiChars::LF || text[i] == AsciiChars::FF || text[i] == AsciiChars::VT) &&
+            (result.empty() || result.back() != AsciiChars::CR))
+        {
+            result.push_back(AsciiChars::CR);
+        }
+
+        result.push_back(text[i]);
+        ++i;
+    }
+
+    return result;
+}
+
 VtIo::VtIo() :
     _initialized(false),
     _objectsCreated(false),
@@ -70,6 +187,7 @@ VtIo::VtIo() :
     _lookingForCursorPosition = pArgs->GetInheritCursor();
     _resizeQuirk = pArgs->IsResizeQuirkEnabled();
     _win32InputMode = pArgs->IsWin32InputModeEnabled();
+    _passthroughMode = pArgs->IsPassthroughModeEnabled();
 
     // If we were already given VT handles, set up the VT IO engine to use those.
     if (pArgs->InConptyMode())
@@ -438,6 +556,18 @@ void VtIo::EnableConptyModeForTests(std::unique_ptr<Microsoft::Console::Render::
     _objectsCreated = true;
     _pVtRenderEngine = std::move(vtRenderEngine);
 }
+
+// Method Description:
+// - This is a test helper method. It acts as if we were (or weren't) started
+//   with the `--passthrough` flag. Call EnableConptyModeForTests first.
+// Arguments:
+// - enabled: whether passthrough mode should be enabled
+// Return Value:
+// - <none>
+void VtIo::SetPassthroughModeForTests(const bool enabled) noexcept
+{
+    _passthroughMode = enabled;
+}
 #endif
 
 // Method Description:
@@ -456,6 +586,109 @@ bool VtIo::IsResizeQuirkEnabled() const
     return _resizeQuirk;
 }
 
+// Method Description:
+// - Returns true if VT output written by clients to the active screen buffer
+//   is forwarded to the terminal as is, instead of being rendered into VT
+//   again from the buffer. See BeginPassthrough.
+// Arguments:
+// - <none>
+// Return Value:
+// - true iff we were started with the `--passthrough` flag enabled and
+//   render to a terminal that accepts UTF-8.
+bool VtIo::IsPassthroughEnabled() const noexcept
+{
+    return _passthroughMode && _pVtRenderEngine && _IoMode != VtIoMode::XTERM_ASCII;
+}
+
+// Method Description:
+// - Forwards VT output written by a client to the terminal. The output is then
+//   parsed into the buffer as usual, to keep its state up to date for console
+//   API consumers, but nothing that parsing it invalidates is rendered again.
+//   Call EndPassthrough once it has been parsed.
+// - Changes that weren't made by VT output, like those of console API calls,
+//   are left to the render thread. They're repainted after the forwarded output.
+// - Queries that we answer while parsing the output aren't forwarded, so
+//   that the client gets exactly one answer to them, and line feeds are
+//   adjusted to the newline mode. See _ForwardedOutput.
+// - The console lock must be held from here until EndPassthrough returns.
+// Arguments:
+// - machine: The state machine the output will be parsed with.
+// - text: The client's output.
+// Return Value:
+// - S_OK or suitable HRESULT error from writing the pipe.
+[[nodiscard]] HRESULT VtIo::BeginPassthrough(StateMachine& machine, const std::wstring_view text) noexcept
+try
+{
+    s_passthroughChars.add(text.size());
+
+    // If an earlier write left a sequence unfinished and the renderer isn't
+    // waiting for the rest of it anymore, the terminal has dropped it (see
+    // AbortPassthrough). So do we, or we'd parse the rest differently.
+    if (!machine.IsGround() && !_pVtRenderEngine->IsPassthroughPaused())
+    {
+        machine.ProcessCharacter(AsciiChars::CAN);
+    }
+
+    const auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+    return _pVtRenderEngine->BeginPassthrough(_ForwardedOutput(text, gci.IsReturnOnNewlineAutomatic()));
+}
+CATCH_RETURN()
+
+// Method Description:
+// - Ends a BeginPassthrough call, after the forwarded output has been parsed into the buffer.
+// - If the output ended in the middle of a sequence, the terminal is still
+//   waiting for the rest of it. Passthrough then stays active in the renderer,
+//   which holds back all of our own output, until a later write completes it
+//   or AbortPassthrough gives up on it.
+// Arguments:
+// - machine: The state machine the forwarded output was parsed with.
+// Return Value:
+// - S_OK or suitable HRESULT error from writing the pipe.
+[[nodiscard]] HRESULT VtIo::EndPassthrough(const StateMachine& machine) noexcept
+try
+{
+    auto& g = ServiceLocator::LocateGlobals();
+    const auto& screenInfo = g.getConsoleInformation().GetActiveOutputBuffer();
+    const auto& cursor = screenInfo.GetTextBuffer().GetCursor();
+
+    // Let the renderer pick up a viewport that moved while the output was parsed.
+    // The terminal has already scrolled along with it, so the engine ignores
+    // the scroll this invalidates.
+    g.pRender->TriggerScroll();
+
+    auto position = cursor.GetPosition();
+    screenInfo.GetViewport().ConvertToOrigin(&position);
+
+    if (!machine.IsGround())
+    {
+        return _pVtRenderEngine->PausePassthrough(position, cursor.IsVisible(), screenInfo.GetAttributes());
+    }
+
+    return _pVtRenderEngine->EndPassthrough(position, cursor.IsVisible(), screenInfo.GetAttributes());
+}
+CATCH_RETURN()
+
+// Method Description:
+// - Gives up on a sequence that the client left unfinished, if passthrough is
+//   paused waiting for the rest of it. The terminal is told to drop it, and our
+//   own state machine drops it with the client's next passthrough write.
+// - Called for output to the active buffer that isn't passed through and
+//   when a client disconnects, since the client may never finish the sequence.
+//   The renderer also aborts on its own after a while. See VtEngine::AbortPassthrough.
+// Arguments:
+// - <none>
+// Return Value:
+// - S_OK or suitable HRESULT error from writing the pipe. S_FALSE if
+//   passthrough wasn't paused.
+[[nodiscard]] HRESULT VtIo::AbortPassthrough() noexcept
+{
+    if (_pVtRenderEngine)
+    {
+        return _pVtRenderEngine->AbortPassthrough();
+    }
+    return S_FALSE;
+}
+
 // Method Description:
 // - Manually tell the renderer that it should emit a "Erase Scrollback"
 //   sequence to the connected terminal. We need to do this in certain cases
@@ -13,6 +13,8 @@ class ConsoleArguments;
 
 namespace Microsoft::Console::VirtualTerminal
 {
+    class StateMachine;
+
     class VtIo : public Microsoft::Console::ITerminalOwner
     {
     public:
@@ -41,10 +43,16 @@ namespace Microsoft::Console::VirtualTerminal
 
 #ifdef UNIT_TESTING
         void EnableConptyModeForTests(std::unique_ptr<Microsoft::Console::Render::VtEngine> vtRenderEngine);
+        void SetPassthroughModeForTests(const bool enabled) noexcept;
 #endif
 
         bool IsResizeQuirkEnabled() const;
 
+        bool IsPassthroughEnabled() const noexcept;
+        [[nodiscard]] HRESULT BeginPassthrough(StateMachine& machine, const std::wstring_view text) noexcept;
+        [[nodiscard]] HRESULT EndPassthrough(const StateMachine& machine) noexcept;
+        [[nodiscard]] HRESULT AbortPassthrough() noexcept;
+
         [[nodiscard]] HRESULT ManuallyClearScrollback() const noexcept;
 
     private:
@@ -63,6 +71,7 @@ namespace Microsoft::Console::VirtualTerminal
 
         bool _resizeQuirk{ false };
         bool _win32InputMode{ false };
+        bool _passthroughMode{ false };
 
         std::unique_ptr<Microsoft::Console::Render::VtEngine> _pVtRenderEngine;
         std::unique_ptr<Microsoft::Console::VtInputThread> _pVtInputThread;
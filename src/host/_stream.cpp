@@ -30,6 +30,54 @@ using Microsoft::Console::VirtualTerminal::StateMachine;
 
 constexpr unsigned int LOCAL_BUFFER_SIZE = 100;
 
+// Routine Description:
+// - Returns the length of the run of printable ASCII characters at the start of
+//   the given text. Each of those always occupies exactly one narrow cell and
+//   needs no further processing, which is what allows WriteCharsLegacy to
+//   write them to the buffer in bulk.
+// Arguments:
+// - text - the text to scan
+// Return Value:
+// - the number of leading characters in the range [0x20, 0x7E]
+static size_t _PrintableAsciiPrefixLength(const std::wstring_view text) noexcept
+{
+    size_t i = 0;
+
+#pragma warning(push)
+#pragma warning(disable : 26481) // Don't use pointer arithmetic. Use span instead (bounds.1).
+#pragma warning(disable : 26490) // Don't use reinterpret_cast (type.1).
+#if _M_AMD64
+    // Check 8 characters at a time. The comparisons are signed, which makes
+    // characters from U+8000 upwards negative and thus less than 0x20 as well.
+    const auto lower = _mm_set1_epi16(0x1f);
+    const auto upper = _mm_set1_epi16(0x7f);
+    for (; i + 8 <= text.size(); i += 8)
+    {
+        const auto chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text.data() + i));
+        const auto printable = _mm_and_si128(_mm_cmpgt_epi16(chars, lower), _mm_cmplt_epi16(chars, upper));
+        const auto mask = _mm_movemask_epi8(printable);
+        if (mask != 0xffff)
+        {
+            // Each character produced 2 bits in the mask. Find the first one that isn't set.
+            unsigned long index;
+            _BitScanForward(&index, static_cast<unsigned long>(~mask));
+            return i + index / 2;
+        }
+    }
+#endif
+#pragma warning(pop)
+
+    for (; i < text.size(); ++i)
+    {
+        const auto wch = til::at(text, i);
+        if (wch < L' ' || wch > L'~')
+        {
+            break;
+        }
+    }
+    return i;
+}
+
 // Routine Description:
 // - This routine updates the cursor position.  Its input is the non-special
 //   cased new location of the cursor.  For example, if the cursor were being
@@ -388,6 +436,34 @@ constexpr unsigned int LOCAL_BUFFER_SIZE = 100;
         XPosition = cursor.GetPosition().X;
         size_t i = 0;
         wchar_t* LocalBufPtr = LocalBuffer;
+        const wchar_t* text = LocalBuffer;
+
+        // Runs of printable ASCII are by far the most common input. They're written
+        // straight from the input string instead of being copied into LocalBuffer
+        // character by character, and they aren't limited to its size either.
+        // A run that's followed by a character that the loop below would have
+        // collected into the same LocalBuffer (a tab for instance) is left to it,
+        // so that this never results in more writes to the buffer than before.
+        if (XPosition < coordScreenBufferSize.X)
+        {
+            const auto remaining = (BufferSize - *pcb) / sizeof(WCHAR);
+            const auto limit = std::min(remaining, gsl::narrow_cast<size_t>(coordScreenBufferSize.X - XPosition));
+            const auto length = _PrintableAsciiPrefixLength({ lpString, limit });
+            if (length != 0 &&
+                (length == limit ||
+                 (!fUnprocessed && (lpString[length] == UNICODE_CARRIAGERETURN || lpString[length] == UNICODE_LINEFEED || lpString[length] == UNICODE_BACKSPACE))))
+            {
+                text = lpString;
+                i = length;
+                XPosition += gsl::narrow_cast<SHORT>(length);
+                lpString += length;
+                pwchRealUnicode += length;
+                pwchBuffer += length;
+                *pcb += length * sizeof(WCHAR);
+                goto EndWhile;
+            }
+        }
+
         while (*pcb < BufferSize && i < LOCAL_BUFFER_SIZE && XPosition < coordScreenBufferSize.X)
         {
 #pragma prefast(suppress : 26019, "Buffer is taken in multiples of 2. Validation is ok.")
@@ -553,7 +629,7 @@ constexpr unsigned int LOCAL_BUFFER_SIZE = 100;
             }
 
             // line was wrapped if we're writing up to the end of the current row
-            OutputCellIterator it(std::wstring_view(LocalBuffer, i), Attributes);
+            OutputCellIterator it(std::wstring_view(text, i), Attributes);
             const auto itEnd = screenInfo.Write(it);
 
             // Notify accessibility
@@ -937,9 +1013,18 @@ constexpr unsigned int LOCAL_BUFFER_SIZE = 100;
                                   const DWORD dwFlags,
                                   _Inout_opt_ PSHORT const psScrollY)
 {
+    auto& vtIo = *ServiceLocator::LocateGlobals().getConsoleInformation().GetVtIo();
+
     if (!WI_IsFlagSet(screenInfo.OutputMode, ENABLE_VIRTUAL_TERMINAL_PROCESSING) ||
         !WI_IsFlagSet(screenInfo.OutputMode, ENABLE_PROCESSED_OUTPUT))
     {
+        // Output that isn't passed through can't wait for the client to
+        // finish a sequence it left unfinished. See VtIo::AbortPassthrough.
+        if (screenInfo.IsActiveScreenBuffer())
+        {
+            LOG_IF_FAILED(vtIo.AbortPassthrough());
+        }
+
         return WriteCharsLegacy(screenInfo,
                                 pwchBufferBackupLimit,
                                 pwchBuffer,
@@ -971,8 +1056,20 @@ constexpr unsigned int LOCAL_BUFFER_SIZE = 100;
 
                 StateMachine& machine = screenInfo.GetStateMachine();
                 size_t const cch = BufferSize / sizeof(WCHAR);
+                const std::wstring_view text{ pwchRealUnicode, cch };
 
-                machine.ProcessString({ pwchRealUnicode, cch });
+                // In conpty passthrough mode the terminal gets the output of the active buffer as is.
+                // We still parse it, since console API consumers expect to find it in the buffer.
+                if (vtIo.IsPassthroughEnabled() && screenInfo.IsActiveScreenBuffer())
+                {
+                    LOG_IF_FAILED(vtIo.BeginPassthrough(machine, text));
+                    auto endPassthrough = wil::scope_exit([&]() { LOG_IF_FAILED(vtIo.EndPassthrough(machine)); });
+                    machine.ProcessString(text);
+                }
+                else
+                {
+                    machine.ProcessString(text);
+                }
                 *pcb += BufferSize;
             }
         }
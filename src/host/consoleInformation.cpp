@@ -259,8 +259,10 @@ COLORREF CONSOLE_INFORMATION::GetDefaultBackground() const noexcept
 std::pair<COLORREF, COLORREF> CONSOLE_INFORMATION::LookupAttributeColors(const TextAttribute& attr) const noexcept
 {
     _blinkingState.RecordBlinkingUsage(attr);
-    return attr.CalculateRgbColors(
+    return _colorCache.Resolve(
+        attr,
         GetColorTable(),
+        GetColorTableGeneration(),
         GetDefaultForeground(),
         GetDefaultBackground(),
         IsScreenReversed(),
@@ -527,6 +527,13 @@ void EventsToUnicode(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents,
 
     try
     {
+        // Appending is by far the common case and can store the records as they are.
+        if (append)
+        {
+            written = context.Write(buffer);
+            return S_OK;
+        }
+
         auto events = IInputEvent::Create(buffer);
 
         return _WriteConsoleInputWImplHelper(context, events, written, append);
@@ -786,7 +793,6 @@ void EventsToUnicode(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents,
 {
     try
     {
-        const auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
         const auto& storageBuffer = context.GetActiveBuffer();
         const auto storageSize = storageBuffer.GetBufferSize().Dimensions();
 
@@ -825,40 +831,22 @@ void EventsToUnicode(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents,
         // We will start reading the buffer at the point of the top left corner (origin) of the (potentially adjusted) request
         const auto sourcePoint = clippedRequestRectangle.Origin();
 
-        // Get an iterator to the beginning of the return buffer
-        // We might have to seek this forward or skip around if we clipped the request.
-        auto targetIter = targetBuffer.begin();
-        COORD targetPos = { 0 };
-        const auto targetLimit = Viewport::FromDimensions(targetPoint, clippedRequestRectangle.Dimensions());
-
-        // Get an iterator to the beginning of the request inside the screen buffer
-        // This should walk exactly along every cell of the clipped request.
-        auto sourceIter = storageBuffer.GetCellDataAt(sourcePoint, clippedRequestRectangle);
-
-        // Walk through every cell of the target, advancing the buffer.
-        // Validate that we always still have a valid iterator to the backing store,
-        // that we always are writing inside the user's buffer (before the end)
-        // and we're always targeting the user's buffer inside its original bounds.
-        while (sourceIter && targetIter < targetBuffer.end())
+        // Copy the clipped request one row at a time into its position within the user's buffer,
+        // stopping early if the user's buffer ends before the request does.
+        if (clippedRequestRectangle.Width() > 0 && clippedRequestRectangle.Height() > 0)
         {
-            // If the point we're trying to write is inside the limited buffer write zone...
-            if (targetLimit.IsInBounds(targetPos))
+            const auto& textBuffer = storageBuffer.GetTextBuffer();
+            const auto sourceWidth = gsl::narrow_cast<size_t>(clippedRequestRectangle.Width());
+            for (SHORT row = 0; row < clippedRequestRectangle.Height(); ++row)
             {
-                // Copy the data into position...
-                *targetIter = gci.AsCharInfo(*sourceIter);
-                // ... and advance the read iterator.
-                sourceIter++;
-            }
-
-            // Always advance the write iterator, we might have skipped it due to clipping.
-            targetIter++;
+                const auto targetOffset = gsl::narrow_cast<size_t>(targetPoint.Y + row) * targetSize.X + targetPoint.X;
+                if (targetOffset >= targetBuffer.size())
+                {
+                    break;
+                }
 
-            // Increment the target
-            targetPos.X++;
-            if (targetPos.X >= targetSize.X)
-            {
-                targetPos.X = 0;
-                targetPos.Y++;
+                const auto cells = targetBuffer.subspan(targetOffset, std::min(sourceWidth, targetBuffer.size() - targetOffset));
+                textBuffer.ReadCharInfos({ sourcePoint.X, gsl::narrow_cast<SHORT>(sourcePoint.Y + row) }, cells);
             }
         }
 
@@ -1009,9 +997,8 @@ void EventsToUnicode(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents,
             // Convert to a CHAR_INFO view to fit into the iterator
             const auto charInfos = gsl::span<const CHAR_INFO>(subspan.data(), subspan.size());
 
-            // Make the iterator and write to the target position.
-            OutputCellIterator it(charInfos);
-            storageBuffer.Write(it, target);
+            // Write the whole line to the target position at once.
+            storageBuffer.GetTextBuffer().WriteCharInfos(target, charInfos);
         }
 
         // Since we've managed to write part of the request, return the clamped part that we actually used.
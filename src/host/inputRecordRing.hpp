@@ -0,0 +1,196 @@
+/*++
+Copyright (c) Microsoft Corporation
+Licensed under the MIT license.
+
+Module Name:
+- inputRecordRing.hpp
+
+Abstract:
+- A growable ring buffer of INPUT_RECORDs, used as the backing store of the InputBuffer.
+- Records are stored by value in a single allocation whose capacity is a power of two,
+  so that pushing and popping events doesn't allocate once the ring has grown to
+  fit the typical amount of pending input. Bulk appends and reads copy at most two
+  contiguous spans.
+--*/
+
+#pragma once
+
+class InputRecordRing final
+{
+public:
+    bool empty() const noexcept
+    {
+        return _size == 0;
+    }
+
+    size_t size() const noexcept
+    {
+        return _size;
+    }
+
+    size_t capacity() const noexcept
+    {
+        return _buffer.size();
+    }
+
+    void clear() noexcept
+    {
+        _head = 0;
+        _size = 0;
+    }
+
+    void swap(InputRecordRing& other) noexcept
+    {
+        _buffer.swap(other._buffer);
+        std::swap(_head, other._head);
+        std::swap(_size, other._size);
+    }
+
+    INPUT_RECORD& operator[](const size_t index) noexcept
+    {
+        return til::at(_buffer, _physical(index));
+    }
+
+    const INPUT_RECORD& operator[](const size_t index) const noexcept
+    {
+        return til::at(_buffer, _physical(index));
+    }
+
+    INPUT_RECORD& front() noexcept
+    {
+        return (*this)[0];
+    }
+
+    const INPUT_RECORD& front() const noexcept
+    {
+        return (*this)[0];
+    }
+
+    INPUT_RECORD& back() noexcept
+    {
+        return (*this)[_size - 1];
+    }
+
+    const INPUT_RECORD& back() const noexcept
+    {
+        return (*this)[_size - 1];
+    }
+
+    void push_back(const INPUT_RECORD& record)
+    {
+        _reserve(_size + 1);
+        til::at(_buffer, _physical(_size)) = record;
+        ++_size;
+    }
+
+    // Routine Description:
+    // - Appends all given records to the end of the ring.
+    // Arguments:
+    // - records - the records to append
+    void append(const gsl::span<const INPUT_RECORD> records)
+    {
+        _reserve(_size + records.size());
+
+        // The free space starts right after the last record and
+        // may wrap around to the beginning of the buffer.
+        const auto tail = _physical(_size);
+        const auto first = std::min(records.size(), _buffer.size() - tail);
+        std::copy_n(records.begin(), first, _buffer.begin() + tail);
+        std::copy(records.begin() + first, records.end(), _buffer.begin());
+        _size += records.size();
+    }
+
+    // Routine Description:
+    // - Copies records out of the ring, starting at the front. The ring isn't modified.
+    // Arguments:
+    // - out - the destination. Up to out.size() records are copied.
+    // Return Value:
+    // - the number of records that were copied
+    size_t copy_to(const gsl::span<INPUT_RECORD> out) const noexcept
+    {
+        const auto count = std::min(out.size(), _size);
+        const auto first = std::min(count, _buffer.size() - _head);
+        std::copy_n(_buffer.begin() + _head, first, out.begin());
+        std::copy_n(_buffer.begin(), count - first, out.begin() + first);
+        return count;
+    }
+
+    // Routine Description:
+    // - Removes the given number of records from the front of the ring.
+    void pop_front(const size_t count = 1) noexcept
+    {
+        const auto n = std::min(count, _size);
+        _size -= n;
+        _head = _size ? _physical(n) : 0;
+
+        // Don't hold on to the memory of a paste storm once it's been read.
+        if (_size == 0 && _buffer.size() > MaximumRetainedCapacity)
+        {
+            std::vector<INPUT_RECORD>{}.swap(_buffer);
+        }
+    }
+
+    // Routine Description:
+    // - Removes all records matching the given predicate, preserving the order of the others.
+    template<typename Predicate>
+    void remove_if(Predicate&& predicate)
+    {
+        size_t kept = 0;
+        for (size_t i = 0; i < _size; ++i)
+        {
+            auto& record = (*this)[i];
+            if (!predicate(std::as_const(record)))
+            {
+                (*this)[kept++] = record;
+            }
+        }
+        _size = kept;
+    }
+
+    // Routine Description:
+    // - Rotates the contents of the ring so that they're stored contiguously.
+    // Return Value:
+    // - all records in the ring, in order
+    gsl::span<const INPUT_RECORD> linearize() noexcept
+    {
+        if (_head + _size > _buffer.size())
+        {
+            std::rotate(_buffer.begin(), _buffer.begin() + _head, _buffer.end());
+            _head = 0;
+        }
+        return { _buffer.data() + _head, _size };
+    }
+
+private:
+    static constexpr size_t MinimumCapacity = 64;
+    static constexpr size_t MaximumRetainedCapacity = 4096;
+
+    size_t _physical(const size_t index) const noexcept
+    {
+        // The capacity is always a power of two, which makes this a cheap modulo.
+        return (_head + index) & (_buffer.size() - 1);
+    }
+
+    void _reserve(const size_t capacity)
+    {
+        if (capacity <= _buffer.size())
+        {
+            return;
+        }
+
+        auto newCapacity = std::max(_buffer.size(), MinimumCapacity);
+        while (newCapacity < capacity)
+        {
+            newCapacity *= 2;
+        }
+
+        std::vector<INPUT_RECORD> buffer(newCapacity);
+        copy_to(buffer);
+        _buffer.swap(buffer);
+        _head = 0;
+    }
+
+    std::vector<INPUT_RECORD> _buffer;
+    size_t _head = 0;
+    size_t _size = 0;
+};
@@ -29,6 +29,7 @@ Revision History:
 
 #include "../host/RenderData.hpp"
 #include "../renderer/inc/BlinkingState.hpp"
+#include "../buffer/out/TextAttributeColorCache.hpp"
 
 // clang-format off
 // Flags flags
@@ -162,6 +163,7 @@ private:
     Microsoft::Console::VirtualTerminal::VtIo _vtIo;
     Microsoft::Console::CursorBlinker _blinker;
     mutable Microsoft::Console::Render::BlinkingState _blinkingState;
+    mutable TextAttributeColorCache _colorCache;
 };
 
 #define ConsoleLocked() (ServiceLocator::LocateGlobals()->getConsoleInformation()->ConsoleLock.OwningThread == NtCurrentTeb()->ClientId.UniqueThread)
@@ -6,6 +6,7 @@
 
 #include "../interactivity/inc/ServiceLocator.hpp"
 #include "../types/inc/colorTable.hpp"
+#include "../buffer/out/TextAttributeColorCache.hpp"
 
 #pragma hdrstop
 
@@ -84,6 +85,7 @@ Settings::Settings() :
     gsl::span<COLORREF> tableView = { _colorTable.data(), _colorTable.size() };
     ::Microsoft::Console::Utils::Initialize256ColorTable(tableView);
     ::Microsoft::Console::Utils::InitializeCampbellColorTableForConhost(tableView);
+    _colorTableGeneration = TextAttributeColorCache::NextColorTableGeneration();
 }
 
 // Routine Description:
@@ -124,6 +126,7 @@ void Settings::ApplyDesktopSpecificDefaults()
 
     gsl::span<COLORREF> tableView = { _colorTable.data(), _colorTable.size() };
     ::Microsoft::Console::Utils::InitializeCampbellColorTableForConhost(tableView);
+    _colorTableGeneration = TextAttributeColorCache::NextColorTableGeneration();
 
     _fTrimLeadingZeros = false;
     _fEnableColorSelection = false;
@@ -729,6 +732,7 @@ void Settings::SetHistoryNoDup(const bool bHistoryNoDup)
 void Settings::SetColorTableEntry(const size_t index, const COLORREF ColorValue)
 {
     _colorTable.at(index) = ColorValue;
+    _colorTableGeneration = TextAttributeColorCache::NextColorTableGeneration();
 }
 
 bool Settings::IsStartupTitleIsLinkNameSet() const
@@ -751,6 +755,15 @@ COLORREF Settings::GetColorTableEntry(const size_t index) const
     return _colorTable.at(index);
 }
 
+// Method Description:
+// - Returns a value identifying the current contents of the color table.
+//   It changes every time the color table is modified, which lets
+//   consumers cache colors resolved through the table.
+size_t Settings::GetColorTableGeneration() const noexcept
+{
+    return _colorTableGeneration;
+}
+
 COLORREF Settings::GetCursorColor() const noexcept
 {
     return _CursorColor;
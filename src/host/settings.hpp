@@ -167,6 +167,7 @@ public:
 
     void SetColorTableEntry(const size_t index, const COLORREF ColorValue);
     COLORREF GetColorTableEntry(const size_t index) const;
+    size_t GetColorTableGeneration() const noexcept;
 
     COLORREF GetCursorColor() const noexcept;
     CursorType GetCursorType() const noexcept;
@@ -234,6 +235,7 @@ private:
     bool _fCopyColor;
 
     std::array<COLORREF, XTERM_COLOR_TABLE_SIZE> _colorTable;
+    size_t _colorTableGeneration; // changes whenever _colorTable does
 
     // this is used for the special STARTF_USESIZE mode.
     bool _fUseWindowSizePixels;
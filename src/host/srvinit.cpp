@@ -243,6 +243,10 @@ static bool s_IsOnDesktop()
 
     CommandHistory::s_Free((HANDLE)ProcessData);
 
+    // The process may have left a passed through sequence unfinished, and
+    // nobody is going to finish it for it.
+    LOG_IF_FAILED(gci.GetVtIo()->AbortPassthrough());
+
     bool const fRecomputeOwner = ProcessData->fRootProcess;
     gci.ProcessHandleList.FreeProcessData(ProcessData);
 
@@ -12,6 +12,7 @@
 #include "../Settings.hpp"
 
 #include "CommonState.hpp"
+#include "../_stream.h"
 
 using namespace WEX::Common;
 using namespace WEX::Logging;
@@ -120,6 +121,11 @@ class ConptyOutputTests
     TEST_METHOD(WriteAFewSimpleLines);
     TEST_METHOD(InvalidateUntilOneBeforeEnd);
     TEST_METHOD(SetConsoleTitleWithControlChars);
+    TEST_METHOD(PassthroughForwardsOutputVerbatim);
+    TEST_METHOD(PassthroughHoldsOutputUntilSequenceEnds);
+    TEST_METHOD(PassthroughAbortsUnfinishedSequence);
+    TEST_METHOD(PassthroughAnswersQueriesOnce);
+    TEST_METHOD(PassthroughMatchesNewlineMode);
 
 private:
     bool _writeCallback(const char* const pch, size_t const cch);
@@ -399,3 +405,235 @@ void ConptyOutputTests::SetConsoleTitleWithControlChars()
 
     VERIFY_SUCCEEDED(renderer.PaintFrame());
 }
+
+void ConptyOutputTests::PassthroughForwardsOutputVerbatim()
+{
+    Log::Comment(NoThrowString().Format(
+        L"In passthrough mode, VT output written to the active buffer should "
+        L"be forwarded to the terminal as is, and not be rendered again."));
+
+    auto& g = ServiceLocator::LocateGlobals();
+    auto& renderer = *g.pRender;
+    auto& gci = g.getConsoleInformation();
+    auto& si = gci.GetActiveOutputBuffer();
+    auto& tb = si.GetTextBuffer();
+
+    _flushFirstFrame();
+
+    gci.GetVtIo()->SetPassthroughModeForTests(true);
+    auto restorePassthrough = wil::scope_exit([&]() { gci.GetVtIo()->SetPassthroughModeForTests(false); });
+    WI_SetFlag(si.OutputMode, ENABLE_VIRTUAL_TERMINAL_PROCESSING);
+
+    // Even though the sequence would be reordered and optimized by the
+    // renderer, the terminal gets exactly what the client wrote.
+    expectedOutput.push_back("\x1b[31mABC\x1b[2;1HD");
+
+    std::unique_ptr<WriteData> waiter;
+    std::wstring seq = L"\x1b[31mABC\x1b[2;1HD";
+    size_t seqCb = 2 * seq.size();
+    VERIFY_SUCCEEDED(DoWriteConsole(&seq[0], &seqCb, si, false, waiter));
+    VERIFY_ARE_EQUAL(0u, expectedOutput.size());
+
+    // The output still ends up in the buffer...
+    {
+        auto iter = tb.GetCellDataAt({ 0, 0 });
+        VERIFY_ARE_EQUAL(L"A", (iter++)->Chars());
+        VERIFY_ARE_EQUAL(L"B", (iter++)->Chars());
+        VERIFY_ARE_EQUAL(L"C", (iter++)->Chars());
+    }
+    {
+        auto iter = tb.GetCellDataAt({ 0, 1 });
+        VERIFY_ARE_EQUAL(L"D", (iter++)->Chars());
+    }
+
+    // ...but since the terminal already drew it, the next frame is empty.
+    VERIFY_SUCCEEDED(renderer.PaintFrame());
+}
+
+void ConptyOutputTests::PassthroughHoldsOutputUntilSequenceEnds()
+{
+    Log::Comment(NoThrowString().Format(
+        L"In passthrough mode, a write that ends in the middle of a sequence "
+        L"should hold back everything else until the client completes it."));
+
+    auto& g = ServiceLocator::LocateGlobals();
+    auto& renderer = *g.pRender;
+    auto& gci = g.getConsoleInformation();
+    auto& si = gci.GetActiveOutputBuffer();
+    auto& tb = si.GetTextBuffer();
+
+    _flushFirstFrame();
+
+    gci.GetVtIo()->SetPassthroughModeForTests(true);
+    auto restorePassthrough = wil::scope_exit([&]() { gci.GetVtIo()->SetPassthroughModeForTests(false); });
+    WI_SetFlag(si.OutputMode, ENABLE_VIRTUAL_TERMINAL_PROCESSING);
+
+    std::unique_ptr<WriteData> waiter;
+    std::wstring seq = L"\x1b[3";
+    size_t seqCb = 2 * seq.size();
+    expectedOutput.push_back("\x1b[3");
+    VERIFY_SUCCEEDED(DoWriteConsole(&seq[0], &seqCb, si, false, waiter));
+    VERIFY_ARE_EQUAL(0u, expectedOutput.size());
+
+    Log::Comment(L"Neither frames nor anything else we write may end up in the middle of the sequence.");
+    VERIFY_SUCCEEDED(DoSrvSetConsoleTitleW(L"Foo"));
+    VERIFY_SUCCEEDED(renderer.PaintFrame());
+    VERIFY_SUCCEEDED(gci.GetVtIo()->ManuallyClearScrollback());
+
+    Log::Comment(L"Once the sequence is complete, the held back output follows it.");
+    seq = L"1mX";
+    seqCb = 2 * seq.size();
+    expectedOutput.push_back("1mX");
+    expectedOutput.push_back("\x1b[3J");
+    VERIFY_SUCCEEDED(DoWriteConsole(&seq[0], &seqCb, si, false, waiter));
+    VERIFY_ARE_EQUAL(0u, expectedOutput.size());
+
+    {
+        auto iter = tb.GetCellDataAt({ 0, 0 });
+        VERIFY_ARE_EQUAL(L"X", iter->Chars());
+    }
+
+    Log::Comment(L"The title change is painted with the next frame.");
+    expectedOutput.push_back("\x1b]0;Foo\a");
+    VERIFY_SUCCEEDED(renderer.PaintFrame());
+    VERIFY_ARE_EQUAL(0u, expectedOutput.size());
+}
+
+void ConptyOutputTests::PassthroughAbortsUnfinishedSequence()
+{
+    Log::Comment(NoThrowString().Format(
+        L"In passthrough mode, output that isn't passed through should make "
+        L"both the terminal and us drop a sequence that a write left unfinished."));
+
+    auto& g = ServiceLocator::LocateGlobals();
+    auto& gci = g.getConsoleInformation();
+    auto& si = gci.GetActiveOutputBuffer();
+    auto& tb = si.GetTextBuffer();
+
+    _flushFirstFrame();
+
+    gci.GetVtIo()->SetPassthroughModeForTests(true);
+    auto restorePassthrough = wil::scope_exit([&]() { gci.GetVtIo()->SetPassthroughModeForTests(false); });
+    WI_SetFlag(si.OutputMode, ENABLE_VIRTUAL_TERMINAL_PROCESSING);
+
+    std::unique_ptr<WriteData> waiter;
+    std::wstring seq = L"\x1b[3";
+    size_t seqCb = 2 * seq.size();
+    expectedOutput.push_back("\x1b[3");
+    VERIFY_SUCCEEDED(DoWriteConsole(&seq[0], &seqCb, si, false, waiter));
+    VERIFY_SUCCEEDED(gci.GetVtIo()->ManuallyClearScrollback());
+    VERIFY_ARE_EQUAL(0u, expectedOutput.size());
+
+    Log::Comment(L"A write without VT processing cancels the sequence and releases the held back output.");
+    WI_ClearFlag(si.OutputMode, ENABLE_VIRTUAL_TERMINAL_PROCESSING);
+    seq = L"X";
+    seqCb = 2 * seq.size();
+    expectedOutput.push_back("\x18");
+    expectedOutput.push_back("\x1b[3J");
+    VERIFY_SUCCEEDED(DoWriteConsole(&seq[0], &seqCb, si, false, waiter));
+    VERIFY_ARE_EQUAL(0u, expectedOutput.size());
+
+    Log::Comment(L"The rest of the sequence is then just text, for us as well as for the terminal.");
+    WI_SetFlag(si.OutputMode, ENABLE_VIRTUAL_TERMINAL_PROCESSING);
+    seq = L"1mY";
+    seqCb = 2 * seq.size();
+    expectedOutput.push_back("1mY");
+    VERIFY_SUCCEEDED(DoWriteConsole(&seq[0], &seqCb, si, false, waiter));
+    VERIFY_ARE_EQUAL(0u, expectedOutput.size());
+    VERIFY_IS_TRUE(si.GetStateMachine().IsGround());
+
+    {
+        auto iter = tb.GetCellDataAt({ 0, 0 });
+        VERIFY_ARE_EQUAL(L"X", (iter++)->Chars());
+        VERIFY_ARE_EQUAL(L"1", (iter++)->Chars());
+        VERIFY_ARE_EQUAL(L"m", (iter++)->Chars());
+        VERIFY_ARE_EQUAL(L"Y", (iter++)->Chars());
+    }
+}
+
+void ConptyOutputTests::PassthroughAnswersQueriesOnce()
+{
+    Log::Comment(NoThrowString().Format(
+        L"In passthrough mode, queries that conhost answers itself should "
+        L"be answered, but not be forwarded to the terminal."));
+
+    auto& g = ServiceLocator::LocateGlobals();
+    auto& gci = g.getConsoleInformation();
+    auto& si = gci.GetActiveOutputBuffer();
+    auto& inputBuffer = *gci.pInputBuffer;
+
+    _flushFirstFrame();
+
+    gci.GetVtIo()->SetPassthroughModeForTests(true);
+    auto restorePassthrough = wil::scope_exit([&]() { gci.GetVtIo()->SetPassthroughModeForTests(false); });
+    WI_SetFlag(si.OutputMode, ENABLE_VIRTUAL_TERMINAL_PROCESSING);
+    inputBuffer.Flush();
+
+    Log::Comment(L"DSR-CPR and DA1 are stripped, the DEC DSR (which we don't answer) isn't.");
+    expectedOutput.push_back("AB\x1b[?6nC");
+
+    std::unique_ptr<WriteData> waiter;
+    std::wstring seq = L"A\x1b[6nB\x1b[c\x1b[?6nC";
+    size_t seqCb = 2 * seq.size();
+    VERIFY_SUCCEEDED(DoWriteConsole(&seq[0], &seqCb, si, false, waiter));
+    VERIFY_ARE_EQUAL(0u, expectedOutput.size());
+
+    Log::Comment(L"The client gets our answers in the input buffer.");
+    std::deque<std::unique_ptr<IInputEvent>> events;
+    VERIFY_SUCCESS_NTSTATUS(inputBuffer.Read(events, inputBuffer.GetNumberOfReadyEvents(), false, false, true, false));
+
+    std::wstring replies;
+    for (const auto& event : events)
+    {
+        const auto keyEvent = static_cast<const KeyEvent*>(event.get());
+        if (keyEvent->IsKeyDown())
+        {
+            replies.push_back(keyEvent->GetCharData());
+        }
+    }
+    VERIFY_ARE_EQUAL(std::wstring{ L"\x1b[1;2R\x1b[?1;0c" }, replies);
+}
+
+void ConptyOutputTests::PassthroughMatchesNewlineMode()
+{
+    Log::Comment(NoThrowString().Format(
+        L"In passthrough mode, line feeds should return the cursor in the "
+        L"terminal exactly when they do in the buffer."));
+
+    auto& g = ServiceLocator::LocateGlobals();
+    auto& gci = g.getConsoleInformation();
+    auto& si = gci.GetActiveOutputBuffer();
+    auto& tb = si.GetTextBuffer();
+
+    _flushFirstFrame();
+
+    gci.GetVtIo()->SetPassthroughModeForTests(true);
+    auto restorePassthrough = wil::scope_exit([&]() { gci.GetVtIo()->SetPassthroughModeForTests(false); });
+    const auto returnOnNewline = gci.IsReturnOnNewlineAutomatic();
+    auto restoreNewlineMode = wil::scope_exit([&]() { gci.SetAutomaticReturnOnNewline(returnOnNewline); });
+    WI_SetFlag(si.OutputMode, ENABLE_VIRTUAL_TERMINAL_PROCESSING);
+
+    Log::Comment(L"By default, a CR is added to every line feed that doesn't have one.");
+    gci.SetAutomaticReturnOnNewline(true);
+    expectedOutput.push_back("A\r\nB\r\nC");
+
+    std::unique_ptr<WriteData> waiter;
+    std::wstring seq = L"A\nB\r\nC";
+    size_t seqCb = 2 * seq.size();
+    VERIFY_SUCCEEDED(DoWriteConsole(&seq[0], &seqCb, si, false, waiter));
+    VERIFY_ARE_EQUAL(0u, expectedOutput.size());
+
+    VERIFY_ARE_EQUAL(L"B", tb.GetCellDataAt({ 0, 1 })->Chars());
+    VERIFY_ARE_EQUAL(L"C", tb.GetCellDataAt({ 0, 2 })->Chars());
+
+    Log::Comment(L"With DISABLE_NEWLINE_AUTO_RETURN, line feeds are forwarded as is.");
+    gci.SetAutomaticReturnOnNewline(false);
+    expectedOutput.push_back("\nD");
+
+    seq = L"\nD";
+    seqCb = 2 * seq.size();
+    VERIFY_SUCCEEDED(DoWriteConsole(&seq[0], &seqCb, si, false, waiter));
+    VERIFY_ARE_EQUAL(0u, expectedOutput.size());
+
+    VERIFY_ARE_EQUAL(L"D", tb.GetCellDataAt({ 1, 3 })->Chars());
+}
@@ -150,6 +150,7 @@ class ScreenBufferTests
 
     TEST_METHOD(BackspaceDefaultAttrs);
     TEST_METHOD(BackspaceDefaultAttrsWriteCharsLegacy);
+    TEST_METHOD(WriteCharsLegacyPrintableRuns);
 
     TEST_METHOD(BackspaceDefaultAttrsInPrompt);
 
@@ -2612,6 +2613,44 @@ void ScreenBufferTests::BackspaceDefaultAttrsWriteCharsLegacy()
     VERIFY_ARE_EQUAL(magenta, gci.LookupAttributeColors(attrB).second);
 }
 
+void ScreenBufferTests::WriteCharsLegacyPrintableRuns()
+{
+    // WriteCharsLegacy writes runs of printable ASCII straight from the input
+    // and only handles the characters around them one at a time. Make sure
+    // that the two of them still produce the same output when mixed.
+
+    CONSOLE_INFORMATION& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+    SCREEN_INFORMATION& si = gci.GetActiveOutputBuffer().GetActiveBuffer();
+    const TextBuffer& tbi = si.GetTextBuffer();
+    Cursor& cursor = si.GetTextBuffer().GetCursor();
+
+    VERIFY_SUCCEEDED(si.SetViewportOrigin(true, COORD({ 0, 0 }), true));
+    cursor.SetPosition({ 0, 0 });
+
+    const auto width = gsl::narrow_cast<size_t>(si.GetBufferSize().Width());
+
+    Log::Comment(L"Write a run longer than both a row and the local buffer of WriteCharsLegacy,");
+    Log::Comment(L"followed by a CRLF, a tab, another CRLF and a wide character.");
+    std::wstring run;
+    for (size_t i = 0; i < width + 10; ++i)
+    {
+        run.push_back(gsl::narrow_cast<wchar_t>(L'A' + i % 26));
+    }
+
+    std::wstring str = run + L"\r\nab\tc\r\nx\x304Ay";
+    size_t seqCb = str.size() * sizeof(wchar_t);
+    VERIFY_SUCCESS_NTSTATUS(WriteCharsLegacy(si, str.data(), str.data(), str.data(), &seqCb, nullptr, cursor.GetPosition().X, 0, nullptr));
+    VERIFY_ARE_EQUAL(str.size() * sizeof(wchar_t), seqCb);
+
+    VERIFY_ARE_EQUAL(run.substr(0, width), tbi.GetRowByOffset(0).GetText());
+    VERIFY_ARE_EQUAL(run.substr(width), tbi.GetRowByOffset(1).GetText().substr(0, 10));
+    VERIFY_ARE_EQUAL(std::wstring{ L"ab      c" }, tbi.GetRowByOffset(2).GetText().substr(0, 9));
+    VERIFY_ARE_EQUAL(std::wstring{ L"x\x304Ay" }, tbi.GetRowByOffset(3).GetText().substr(0, 3));
+
+    const COORD expectedCursor{ 4, 3 };
+    VERIFY_ARE_EQUAL(expectedCursor, cursor.GetPosition());
+}
+
 void ScreenBufferTests::BackspaceDefaultAttrsInPrompt()
 {
     // Tests MSFT:19853701 - when you edit the prompt line at a bash prompt,
@@ -149,10 +149,15 @@ class TextBufferTests
     void WriteLinesToBuffer(const std::vector<std::wstring>& text, TextBuffer& buffer);
     TEST_METHOD(GetWordBoundaries);
     TEST_METHOD(MoveByWord);
+    TEST_METHOD(MoveByWordPerformance);
     TEST_METHOD(GetGlyphBoundaries);
 
     TEST_METHOD(GetTextRects);
     TEST_METHOD(GetText);
+    TEST_METHOD(GetSelectionData);
+    TEST_METHOD(GetSelectionDataPerformance);
+
+    TEST_METHOD(ExportRows);
 
     TEST_METHOD(HyperlinkTrim);
     TEST_METHOD(NoHyperlinkTrim);
@@ -2214,6 +2219,100 @@ void TextBufferTests::MoveByWord()
     }
 }
 
+void TextBufferTests::MoveByWordPerformance()
+{
+    // Walks word by word through a full 10k line buffer, forwards and backwards, and
+    // verifies that every word is visited. Also checks that the per-row word boundary
+    // index picks up writes to the row and different sets of delimiters.
+
+    COORD bufferSize{ 120, 10000 };
+    UINT cursorSize = 12;
+    TextAttribute attr{ 0x7f };
+    auto _buffer = std::make_unique<TextBuffer>(bufferSize, attr, cursorSize, _renderTarget);
+
+    // Setup: Fill each row with words and delimiters, shifted by a word on every row.
+    // Every row starts with a word and ends in whitespace, so words never span rows.
+    const std::array<std::wstring_view, 7> words{ L"lorem", L"ipsum,", L"(dolor)", L"sit", L"amet;", L"x", L"consectetur" };
+    std::vector<std::wstring> text;
+    text.reserve(bufferSize.Y);
+    for (size_t y = 0; y < gsl::narrow_cast<size_t>(bufferSize.Y); ++y)
+    {
+        std::wstring line;
+        for (auto i = y; line.size() + words.at(i % words.size()).size() + 2 < gsl::narrow_cast<size_t>(bufferSize.X); ++i)
+        {
+            line.append(words.at(i % words.size()));
+            line.append(i % 3 ? L" " : L"  ");
+        }
+        text.emplace_back(std::move(line));
+    }
+    WriteLinesToBuffer(text, *_buffer);
+
+    const std::wstring_view delimiters = L" ,();";
+    std::vector<COORD> expected;
+    const auto isRegular = [&](const wchar_t wch) {
+        return wch != L' ' && delimiters.find(wch) == std::wstring_view::npos;
+    };
+    for (SHORT y = 0; y < bufferSize.Y; ++y)
+    {
+        const auto& line = text.at(y);
+        for (size_t x = 0; x < line.size(); ++x)
+        {
+            if (isRegular(line.at(x)) && (x == 0 || !isRegular(line.at(x - 1))))
+            {
+                expected.push_back({ gsl::narrow_cast<SHORT>(x), y });
+            }
+        }
+    }
+
+    using clock = std::chrono::steady_clock;
+    using duration = std::chrono::duration<double, std::milli>;
+
+    const auto lastCharPos = _buffer->GetLastNonSpaceCharacter();
+    const auto start = clock::now();
+    std::vector<COORD> forwards{ _buffer->GetSize().Origin() };
+    for (auto pos = forwards.back(); _buffer->MoveToNextWord(pos, delimiters, lastCharPos);)
+    {
+        forwards.push_back(pos);
+    }
+
+    const auto middle = clock::now();
+    std::vector<COORD> backwards{ expected.back() };
+    for (auto pos = backwards.back(); _buffer->MoveToPreviousWord(pos, delimiters);)
+    {
+        backwards.push_back(pos);
+    }
+    std::reverse(backwards.begin(), backwards.end());
+
+    const auto end = clock::now();
+    VERIFY_ARE_EQUAL(expected.size(), forwards.size());
+    VERIFY_IS_TRUE(expected == forwards);
+    VERIFY_ARE_EQUAL(expected.size(), backwards.size());
+    VERIFY_IS_TRUE(expected == backwards);
+
+    Log::Comment(fmt::format(L"{} words in {} rows: forwards {:.3f}ms, backwards {:.3f}ms",
+                             expected.size(),
+                             bufferSize.Y,
+                             duration{ middle - start }.count(),
+                             duration{ end - middle }.count())
+                     .c_str());
+
+    // The rows key their boundaries on an id for the delimiters, which only changes along with them.
+    const auto delimitersId = _buffer->_GetWordDelimiters(delimiters).id;
+    VERIFY_ARE_EQUAL(delimitersId, _buffer->_GetWordDelimiters(std::wstring{ delimiters }).id);
+    VERIFY_ARE_NOT_EQUAL(delimitersId, _buffer->_GetWordDelimiters(L" ").id);
+
+    // The first row reads "lorem  ipsum, (dolor) ...". Selecting a word with another
+    // set of delimiters mustn't reuse the boundaries found for the old ones.
+    VERIFY_ARE_EQUAL(COORD({ 12, 0 }), _buffer->GetWordEnd({ 7, 0 }, L" ", false));
+    VERIFY_ARE_EQUAL(COORD({ 11, 0 }), _buffer->GetWordEnd({ 7, 0 }, delimiters, false));
+    VERIFY_ARE_EQUAL(COORD({ 7, 0 }), _buffer->GetWordStart({ 9, 0 }, delimiters, false));
+
+    // Writing to a row must discard its boundaries.
+    _buffer->WriteLine(OutputCellIterator{ std::wstring_view{ L"loremXipsum" } }, { 0, 0 });
+    VERIFY_ARE_EQUAL(COORD({ 11, 0 }), _buffer->GetWordEnd({ 7, 0 }, delimiters, false));
+    VERIFY_ARE_EQUAL(COORD({ 0, 0 }), _buffer->GetWordStart({ 9, 0 }, delimiters, false));
+}
+
 void TextBufferTests::GetGlyphBoundaries()
 {
     struct ExpectedResult
@@ -2580,6 +2679,240 @@ void TextBufferTests::GetText()
     }
 }
 
+void TextBufferTests::GetSelectionData()
+{
+    // GetSelectionData() is used to copy text to the clipboard, along with its HTML and
+    // RTF representations. It must produce exactly what GetText(), GenHTML() and
+    // GenRTF() used to produce, just in a single pass over the buffer.
+
+    BEGIN_TEST_METHOD_PROPERTIES()
+        TEST_METHOD_PROPERTY(L"Data:blockSelection", L"{false, true}")
+        TEST_METHOD_PROPERTY(L"Data:includeCRLF", L"{false, true}")
+        TEST_METHOD_PROPERTY(L"Data:trimTrailingWhitespace", L"{false, true}")
+    END_TEST_METHOD_PROPERTIES();
+
+    bool blockSelection;
+    bool includeCRLF;
+    bool trimTrailingWhitespace;
+    VERIFY_SUCCEEDED(TestData::TryGetValue(L"blockSelection", blockSelection), L"Get 'blockSelection' variant");
+    VERIFY_SUCCEEDED(TestData::TryGetValue(L"includeCRLF", includeCRLF), L"Get 'includeCRLF' variant");
+    VERIFY_SUCCEEDED(TestData::TryGetValue(L"trimTrailingWhitespace", trimTrailingWhitespace), L"Get 'trimTrailingWhitespace' variant");
+
+    COORD bufferSize{ 10, 20 };
+    UINT cursorSize = 12;
+    TextAttribute attr{ 0x07 };
+    auto _buffer = std::make_unique<TextBuffer>(bufferSize, attr, cursorSize, _renderTarget);
+
+    // Setup: Write text that has to be escaped in HTML and RTF, in a couple of colors.
+    // The underlined attribute has the same colors as its neighbors, so it mustn't
+    // start a new span.
+    TextAttribute underlined{ 0x1e };
+    underlined.SetUnderlined(true);
+    _buffer->Write(OutputCellIterator{ L"<a>", TextAttribute{ 0x07 } }, { 0, 0 });
+    _buffer->Write(OutputCellIterator{ L"&b", TextAttribute{ 0x1e } }, { 3, 0 });
+    _buffer->Write(OutputCellIterator{ L"{c}", underlined }, { 5, 0 });
+    _buffer->Write(OutputCellIterator{ L"\\x\\", TextAttribute{ 0x2f } }, { 0, 1 });
+    _buffer->Write(OutputCellIterator{ L"  ab", TextAttribute{ 0x07 } }, { 0, 2 });
+    _buffer->Write(OutputCellIterator{ L"0123456789", TextAttribute{ 0x4e } }, { 0, 3 }, std::nullopt);
+    _buffer->Write(OutputCellIterator{ L"wrapped text", TextAttribute{ 0x5d } }, { 0, 4 });
+
+    const auto GetAttributeColors = [](const TextAttribute& textAttr) {
+        const auto legacy = textAttr.GetLegacyAttributes();
+        return std::pair<COLORREF, COLORREF>{ RGB((legacy & 0x0f) * 16, 0x80, 0), RGB(0, 0x40, (legacy >> 4) * 16) };
+    };
+
+    // simulate a selection from origin to {4,5}
+    const auto textRects = _buffer->GetTextRects({ 0, 0 }, { 4, 5 }, blockSelection, false);
+
+    const auto formatWrappedRows = blockSelection;
+    const auto textData = _buffer->GetText(includeCRLF, trimTrailingWhitespace, textRects, GetAttributeColors, formatWrappedRows);
+
+    std::wstring expectedText;
+    for (const auto& text : textData.text)
+    {
+        expectedText += text;
+    }
+    const auto expectedHtml = TextBuffer::GenHTML(textData, 12, L"Consolas", RGB(0x0c, 0x0c, 0x0c));
+    const auto expectedRtf = TextBuffer::GenRTF(textData, 12, L"Consolas", RGB(0x0c, 0x0c, 0x0c));
+
+    TextBuffer::SelectionFormatting formatting;
+    formatting.GetAttributeColors = GetAttributeColors;
+    formatting.fontHeightPoints = 12;
+    formatting.fontFaceName = L"Consolas";
+    formatting.backgroundColor = RGB(0x0c, 0x0c, 0x0c);
+    formatting.html = true;
+    formatting.rtf = true;
+
+    const auto data = _buffer->GetSelectionData(includeCRLF, trimTrailingWhitespace, textRects, formatting, formatWrappedRows);
+    VERIFY_ARE_EQUAL(expectedText, data.text);
+    VERIFY_ARE_EQUAL(expectedHtml, data.html);
+    VERIFY_ARE_EQUAL(expectedRtf, data.rtf);
+
+    Log::Comment(L"Only the requested formats should be generated.");
+    const auto textOnly = _buffer->GetSelectionData(includeCRLF, trimTrailingWhitespace, textRects, {}, formatWrappedRows);
+    VERIFY_ARE_EQUAL(expectedText, textOnly.text);
+    VERIFY_IS_TRUE(textOnly.html.empty());
+    VERIFY_IS_TRUE(textOnly.rtf.empty());
+}
+
+void TextBufferTests::GetSelectionDataPerformance()
+{
+    // Copies the entire scrollback of a colorful buffer with and without formatting,
+    // and logs how long it took compared to GetText() followed by GenHTML() and GenRTF().
+
+    COORD bufferSize{ 120, 9001 };
+    UINT cursorSize = 12;
+    TextAttribute attr{ 0x07 };
+    auto _buffer = std::make_unique<TextBuffer>(bufferSize, attr, cursorSize, _renderTarget);
+
+    // Setup: Fill each row with words in a couple of alternating colors, like a
+    // colorized directory listing or build log.
+    const std::wstring_view word{ L"lorem <ipsum> " };
+    for (SHORT y = 0; y < bufferSize.Y; ++y)
+    {
+        for (SHORT x = 0; x + gsl::narrow_cast<SHORT>(word.size()) <= bufferSize.X; x += gsl::narrow_cast<SHORT>(word.size()))
+        {
+            const auto legacy = gsl::narrow_cast<WORD>(((x / word.size()) + y) % 7 + 1);
+            _buffer->WriteLine(OutputCellIterator{ word, TextAttribute{ legacy } }, { x, y });
+        }
+    }
+
+    const auto GetAttributeColors = [](const TextAttribute& textAttr) {
+        const auto legacy = textAttr.GetLegacyAttributes();
+        return std::pair<COLORREF, COLORREF>{ RGB((legacy & 0x0f) * 16, 0x80, 0), RGB(0, 0x40, (legacy >> 4) * 16) };
+    };
+
+    const auto textRects = _buffer->GetTextRects({ 0, 0 }, { gsl::narrow_cast<SHORT>(bufferSize.X - 1), gsl::narrow_cast<SHORT>(bufferSize.Y - 1) }, false, false);
+
+    TextBuffer::SelectionFormatting formatting;
+    formatting.GetAttributeColors = GetAttributeColors;
+    formatting.fontHeightPoints = 12;
+    formatting.fontFaceName = L"Consolas";
+    formatting.backgroundColor = RGB(0x0c, 0x0c, 0x0c);
+
+    using clock = std::chrono::steady_clock;
+    using duration = std::chrono::duration<double, std::milli>;
+
+    for (const auto copyFormatting : { false, true })
+    {
+        formatting.html = copyFormatting;
+        formatting.rtf = copyFormatting;
+
+        const auto start = clock::now();
+        const auto textData = _buffer->GetText(true, true, textRects, GetAttributeColors);
+        std::wstring text;
+        for (const auto& row : textData.text)
+        {
+            text += row;
+        }
+        std::string html;
+        std::string rtf;
+        if (copyFormatting)
+        {
+            html = TextBuffer::GenHTML(textData, formatting.fontHeightPoints, formatting.fontFaceName, formatting.backgroundColor);
+            rtf = TextBuffer::GenRTF(textData, formatting.fontHeightPoints, formatting.fontFaceName, formatting.backgroundColor);
+        }
+
+        const auto middle = clock::now();
+        const auto data = _buffer->GetSelectionData(true, true, textRects, formatting);
+
+        const auto end = clock::now();
+        VERIFY_ARE_EQUAL(text, data.text);
+        VERIFY_ARE_EQUAL(html, data.html);
+        VERIFY_ARE_EQUAL(rtf, data.rtf);
+
+        Log::Comment(fmt::format(L"{} rows {}: GetText+GenHTML+GenRTF {:.3f}ms, GetSelectionData {:.3f}ms",
+                                 textRects.size(),
+                                 copyFormatting ? L"with formatting" : L"as text",
+                                 duration{ middle - start }.count(),
+                                 duration{ end - middle }.count())
+                         .c_str());
+    }
+}
+
+void TextBufferTests::ExportRows()
+{
+    COORD bufferSize{ 5, 10 };
+    UINT cursorSize = 12;
+    auto _buffer = std::make_unique<TextBuffer>(bufferSize, TextAttribute{}, cursorSize, _renderTarget);
+
+    // Setup: Write lines of text to the buffer
+    const std::vector<std::wstring> bufferText = { L"1234567",
+                                                   L"",
+                                                   L"ab  ",
+                                                   L"  x" };
+    WriteLinesToBuffer(bufferText, *_buffer);
+
+    // Followed by some text with attributes. The trailing whitespace of the
+    // 5th row has a colored background.
+    TextAttribute boldRed{};
+    boldRed.SetBold(true);
+    boldRed.SetIndexedForeground(FOREGROUND_RED);
+    TextAttribute indexedBackground{};
+    indexedBackground.SetIndexedBackground256(100);
+    TextAttribute rgbForeground{};
+    rgbForeground.SetForeground(RGB(1, 2, 3));
+    _buffer->Write(OutputCellIterator{ L"ab", boldRed }, { 0, 4 }, std::nullopt);
+    _buffer->Write(OutputCellIterator{ L"c", TextAttribute{} }, { 2, 4 }, std::nullopt);
+    _buffer->Write(OutputCellIterator{ L"  ", indexedBackground }, { 3, 4 }, std::nullopt);
+    _buffer->Write(OutputCellIterator{ L"z", rgbForeground }, { 0, 5 }, std::nullopt);
+
+    // buffer should look like this:
+    // ______
+    // |12345| <-- wrapped
+    // |67   |
+    // |ab   |
+    // |  x  |
+    // |abc  | <-- "ab" is bold and red, the last 2 cells have a colored background
+    // |z    | <-- "z" has an RGB foreground
+    // |_____|
+
+    Log::Comment(L"Export the plain text. Wrapped rows should be joined and trailing whitespace trimmed.");
+    {
+        std::string out;
+        TextAttribute lastAttributes{};
+        _buffer->ExportRows(out, 0, 6, TextBuffer::ExportFormat::PlainText, lastAttributes);
+        VERIFY_ARE_EQUAL(std::string{ "1234567\r\nab\r\n  x\r\nabc\r\nz\r\n" }, out);
+        VERIFY_ARE_EQUAL(TextAttribute{}, lastAttributes);
+    }
+
+    Log::Comment(L"Export with attributes. Sequences should only be written when the attributes change.");
+    const std::string expectedVt{ "1234567\r\nab\r\n  x\r\n"
+                                  "\x1b[0;1;31mab\x1b[0mc\x1b[0;48;5;100m  \r\n"
+                                  "\x1b[0;38;2;1;2;3mz\r\n" };
+    {
+        std::string out;
+        TextAttribute lastAttributes{};
+        _buffer->ExportRows(out, 0, 6, TextBuffer::ExportFormat::VirtualTerminal, lastAttributes);
+        VERIFY_ARE_EQUAL(expectedVt, out);
+        VERIFY_ARE_EQUAL(rgbForeground, lastAttributes);
+    }
+
+    Log::Comment(L"Exporting in chunks should produce the same result.");
+    {
+        std::string out;
+        TextAttribute lastAttributes{};
+        for (SHORT row = 0; row < 6; row += 2)
+        {
+            _buffer->ExportRows(out, row, row + 2, TextBuffer::ExportFormat::VirtualTerminal, lastAttributes);
+        }
+        VERIFY_ARE_EQUAL(expectedVt, out);
+    }
+
+    Log::Comment(L"Rows that circled out of the buffer should be counted.");
+    {
+        VERIFY_ARE_EQUAL(size_t{ 0 }, _buffer->GetCircledRowCount());
+        VERIFY_IS_TRUE(_buffer->IncrementCircularBuffer());
+        VERIFY_IS_TRUE(_buffer->IncrementCircularBuffer());
+        VERIFY_ARE_EQUAL(size_t{ 2 }, _buffer->GetCircledRowCount());
+
+        std::string out;
+        TextAttribute lastAttributes{};
+        _buffer->ExportRows(out, 0, 1, TextBuffer::ExportFormat::PlainText, lastAttributes);
+        VERIFY_ARE_EQUAL(std::string{ "ab\r\n" }, out);
+    }
+}
+
 // This tests that when we increment the circular buffer, obsolete hyperlink references
 // are removed from the hyperlink map
 void TextBufferTests::HyperlinkTrim()
@@ -37,6 +37,7 @@ class Microsoft::Console::VirtualTerminal::VtIoTests
     TEST_METHOD(DtorTestStackAllocMany);
 
     TEST_METHOD(RendererDtorAndThread);
+    TEST_METHOD(RendererDefersPaintNotifications);
 
 #if TIL_FEATURE_CONHOSTDXENGINE_ENABLED
     TEST_METHOD(RendererDtorAndThreadAndDx);
@@ -433,6 +434,58 @@ void VtIoTests::RendererDtorAndThread()
     }
 }
 
+namespace
+{
+    class CountingRenderThread : public IRenderThread
+    {
+    public:
+        void NotifyPaint() override { ++notifications; }
+        void EnablePainting() override {}
+        void DisablePainting() override {}
+        void WaitForPaintCompletionAndDisable(const DWORD) override {}
+
+        int notifications = 0;
+    };
+}
+
+void VtIoTests::RendererDefersPaintNotifications()
+{
+    Log::Comment(L"Paint notifications made while they're deferred are sent once, when the outermost deferral ends.");
+
+    auto data = std::make_unique<MockRenderData>();
+    auto thread = std::make_unique<CountingRenderThread>();
+    auto* pThread = thread.get();
+    auto pRenderer = std::make_unique<Microsoft::Console::Render::Renderer>(data.get(), nullptr, 0, std::move(thread));
+
+    pRenderer->TriggerRedrawAll();
+    VERIFY_ARE_EQUAL(1, pThread->notifications);
+
+    pRenderer->DeferPaintNotifications();
+    pRenderer->DeferPaintNotifications();
+    pRenderer->TriggerRedrawAll();
+    pRenderer->TriggerTitleChange();
+    pRenderer->TriggerRedrawAll();
+    VERIFY_ARE_EQUAL(1, pThread->notifications);
+
+    pRenderer->ResumePaintNotifications();
+    VERIFY_ARE_EQUAL(1, pThread->notifications, L"Only the outermost deferral sends the notification.");
+
+    pRenderer->ResumePaintNotifications();
+    VERIFY_ARE_EQUAL(2, pThread->notifications);
+
+    Log::Comment(L"Nothing is sent if nothing was requested in between.");
+    pRenderer->DeferPaintNotifications();
+    pRenderer->ResumePaintNotifications();
+    VERIFY_ARE_EQUAL(2, pThread->notifications);
+
+    Log::Comment(L"Notifications made on other threads aren't held back.");
+    pRenderer->DeferPaintNotifications();
+    std::thread([&]() { pRenderer->TriggerRedrawAll(); }).join();
+    VERIFY_ARE_EQUAL(3, pThread->notifications);
+    pRenderer->ResumePaintNotifications();
+    VERIFY_ARE_EQUAL(3, pThread->notifications);
+}
+
 #if TIL_FEATURE_CONHOSTDXENGINE_ENABLED
 void VtIoTests::RendererDtorAndThreadAndDx()
 {
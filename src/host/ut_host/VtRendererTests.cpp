@@ -83,6 +83,10 @@ class Microsoft::Console::Render::VtRendererTest
 
     TEST_METHOD(TestCursorVisibility);
 
+    TEST_METHOD(FlushPolicyFlushesInteractiveFrames);
+    TEST_METHOD(FlushPolicyBatchesBursts);
+    TEST_METHOD(FlushPolicyBatchesFramesWrittenToPipe);
+
     void Test16Colors(VtEngine* engine);
 
     std::deque<std::string> qExpectedInput;
@@ -1611,3 +1615,94 @@ void VtRendererTest::FormattedString()
     qExpectedInput.push_back("\x1b[28;3;500;500;500m");
     VERIFY_SUCCEEDED(engine->_WriteFormatted(bigFormat, bigValue, bigValue, bigValue));
 }
+
+void VtRendererTest::FlushPolicyFlushesInteractiveFrames()
+{
+    using namespace std::chrono_literals;
+    const auto start = VtFlushPolicy::clock::now();
+    const auto large = VtFlushPolicy::InteractiveFrameBytes + 1;
+    VtFlushPolicy policy;
+
+    Log::Comment(L"Nothing buffered, nothing to flush.");
+    VERIFY_IS_FALSE(policy.ShouldFlush(0, 0, start, start));
+
+    Log::Comment(L"A small frame after a quiet period, like an echo, is flushed right away.");
+    VERIFY_IS_TRUE(policy.ShouldFlush(3, 3, start, start + 100ms));
+
+    Log::Comment(L"So is a large frame, as long as it doesn't follow another one.");
+    VERIFY_IS_TRUE(policy.ShouldFlush(large, large, start + 200ms, start + 200ms));
+
+    Log::Comment(L"A small frame is flushed right away even in the middle of a burst.");
+    VERIFY_IS_TRUE(policy.ShouldFlush(3, 3, start + 201ms, start + 201ms));
+}
+
+void VtRendererTest::FlushPolicyBatchesBursts()
+{
+    using namespace std::chrono_literals;
+    const auto start = VtFlushPolicy::clock::now();
+    const auto large = VtFlushPolicy::InteractiveFrameBytes + 1;
+    VtFlushPolicy policy;
+
+    Log::Comment(L"The first large frame is flushed, since we don't know about the burst yet.");
+    VERIFY_IS_TRUE(policy.ShouldFlush(large, large, start, start));
+
+    Log::Comment(L"Large frames that follow it closely are batched...");
+    VERIFY_IS_FALSE(policy.ShouldFlush(large, large, start + 8ms, start + 8ms));
+    VERIFY_IS_FALSE(policy.ShouldFlush(large, 2 * large, start + 8ms, start + 12ms));
+
+    Log::Comment(L"...until the time budget is exceeded.");
+    VERIFY_IS_TRUE(policy.ShouldFlush(large, 3 * large, start + 8ms, start + 8ms + VtFlushPolicy::BurstTimeBudget));
+
+    Log::Comment(L"...or the byte budget is exceeded.");
+    VERIFY_IS_FALSE(policy.ShouldFlush(large, large, start + 30ms, start + 30ms));
+    VERIFY_IS_TRUE(policy.ShouldFlush(VtFlushPolicy::BurstByteBudget, VtFlushPolicy::BurstByteBudget + large, start + 30ms, start + 31ms));
+
+    Log::Comment(L"Once the burst is over, large frames are flushed right away again.");
+    VERIFY_IS_TRUE(policy.ShouldFlush(large, large, start + 1s, start + 1s));
+}
+
+void VtRendererTest::FlushPolicyBatchesFramesWrittenToPipe()
+{
+    wil::unique_hfile readPipe;
+    wil::unique_hfile writePipe;
+    // Make the pipe large enough that writing to it never blocks this test.
+    VERIFY_WIN32_BOOL_SUCCEEDED(CreatePipe(readPipe.addressof(), writePipe.addressof(), nullptr, 1024 * 1024));
+
+    Viewport view = SetUpViewport();
+    auto engine = std::make_unique<Xterm256Engine>(std::move(writePipe), view);
+
+    const auto available = [&]() {
+        DWORD bytes = 0;
+        VERIFY_WIN32_BOOL_SUCCEEDED(PeekNamedPipe(readPipe.get(), nullptr, 0, nullptr, &bytes, nullptr));
+        return bytes;
+    };
+    const auto drain = [&]() {
+        std::string bytes(available(), '\0');
+        DWORD read = 0;
+        VERIFY_WIN32_BOOL_SUCCEEDED(ReadFile(readPipe.get(), bytes.data(), gsl::narrow<DWORD>(bytes.size()), &read, nullptr));
+        bytes.resize(read);
+        return bytes;
+    };
+    const std::string text(VtFlushPolicy::InteractiveFrameBytes * 2, 'A');
+    const auto paintLargeFrame = [&]() {
+        VERIFY_SUCCEEDED(engine->InvalidateAll());
+        TestPaint(*engine, [&]() {
+            VERIFY_SUCCEEDED(engine->_Write(text));
+        });
+    };
+
+    Log::Comment(L"The first frame is flushed at the end of the frame.");
+    paintLargeFrame();
+    VERIFY_ARE_NOT_EQUAL(std::string::npos, drain().find(text));
+
+    Log::Comment(L"A large frame right after it is batched instead.");
+    paintLargeFrame();
+    VERIFY_ARE_EQUAL(0ul, available());
+    VERIFY_IS_TRUE(engine->RequiresContinuousRedraw());
+
+    Log::Comment(L"The next frame without anything to paint flushes it as soon as it starts.");
+    TestPaint(*engine, [&]() {
+        VERIFY_ARE_NOT_EQUAL(std::string::npos, drain().find(text));
+    });
+    VERIFY_IS_FALSE(engine->RequiresContinuousRedraw());
+}
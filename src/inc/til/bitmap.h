@@ -148,7 +148,7 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
                 _sz{},
                 _rc{},
                 _bits{ _alloc },
-                _runs{ _alloc }
+                _runs{ std::nullopt }
             {
             }
 
@@ -172,7 +172,7 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
                 _sz(sz),
                 _rc(sz),
                 _bits(_sz.area(), fill ? std::numeric_limits<unsigned long long>::max() : 0, _alloc),
-                _runs{ _alloc }
+                _runs{ std::nullopt }
             {
             }
 
@@ -268,7 +268,7 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
                 // If we don't have cached runs, rebuild.
                 if (!_runs.has_value())
                 {
-                    _runs.emplace(begin(), end());
+                    _runs.emplace(begin(), end(), run_allocator_type{ _alloc });
                 }
 
                 // Return the runs.
@@ -278,105 +278,184 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
             // optional fill the uncovered area with bits.
             void translate(const til::point delta, bool fill = false)
             {
-                if (delta.x() == 0)
+                if (delta == til::point{})
                 {
-                    // fast path by using bit shifting
-                    translate_y(delta.y(), fill);
                     return;
                 }
 
-                // FUTURE: PERF: GH #4015: This could use in-place walk semantics instead of a temporary.
-                bitmap<allocator_type> other{ _sz, _alloc };
+                const auto width = _sz.width();
+                const auto height = _sz.height();
 
-                for (auto run : *this)
+                if (std::abs(delta.x()) >= width || std::abs(delta.y()) >= height)
                 {
-                    // Offset by the delta
-                    run += delta;
-
-                    // Intersect with the bounds of our bitmap area
-                    // as part of it could have slid out of bounds.
-                    run &= _rc;
+                    // Everything slid out of bounds.
+                    if (fill)
+                    {
+                        set_all();
+                    }
+                    else
+                    {
+                        reset_all();
+                    }
+                    return;
+                }
 
-                    // Set it into the new bitmap.
-                    other.set(run);
+                // Our bits are stored row by row, so moving every bit by delta is
+                // the same as moving it by (delta.y * width + delta.x) positions,
+                // which the bitset can do a whole word at a time.
+                // Shifting in either direction fills the vacated bits with 0.
+                const auto shift = delta.y() * width + delta.x();
+#pragma warning(push)
+                // we can't depend on GSL here, so we use static_cast for explicit narrowing
+#pragma warning(disable : 26472)
+                if (shift > 0)
+                {
+                    _bits <<= static_cast<size_t>(shift);
+                }
+                else
+                {
+                    _bits >>= static_cast<size_t>(-shift);
                 }
 
-                // If we were asked to fill... find the uncovered region.
-                if (fill)
+                // Bits that were moved past the left or right edge of a row ended up
+                // at the opposite edge of the neighboring row. Those columns are
+                // exactly the ones that were uncovered by a horizontal move.
+                if (delta.x() != 0)
                 {
-                    // Original Rect of As.
-                    //
-                    // X <-- origin
-                    // A A A A
-                    // A A A A
-                    // A A A A
-                    // A A A A
-                    const auto originalRect = _rc;
-
-                    // If Delta = (2, 2)
-                    // Translated Rect of Bs.
-                    //
-                    // X <-- origin
-                    //
-                    //
-                    //     B B B B
-                    //     B B B B
-                    //     B B B B
-                    //     B B B B
-                    const auto translatedRect = _rc + delta;
-
-                    // Subtract the B from the A one to see what wasn't filled by the move.
-                    // C is the overlap of A and B:
-                    //
-                    // X <-- origin
-                    // A A A A                     1 1 1 1
-                    // A A A A                     1 1 1 1
-                    // A A C C B B     subtract    2 2
-                    // A A C C B B    --------->   2 2
-                    //     B B B B      A - B
-                    //     B B B B
-                    //
-                    // 1 and 2 are the spaces to fill that are "uncovered".
-                    const auto fillRects = originalRect - translatedRect;
-                    for (const auto& f : fillRects)
+                    const auto column = delta.x() > 0 ? 0 : width + delta.x();
+                    const auto count = static_cast<size_t>(std::abs(delta.x()));
+                    for (ptrdiff_t row = 0; row < height; ++row)
                     {
-                        other.set(f);
+                        _bits.set(static_cast<size_t>(row * width + column), count, fill);
                     }
                 }
 
-                // Swap us with the temporary one.
-                std::swap(other, *this);
+                // The rows that were uncovered by a vertical move are already 0.
+                if (fill && delta.y() != 0)
+                {
+                    const auto count = static_cast<size_t>(std::abs(delta.y()) * width);
+                    _bits.set(delta.y() > 0 ? 0 : _bits.size() - count, count, true);
+                }
+#pragma warning(pop)
+
+                // If we have cached runs, move them along instead of recalculating them.
+                // A moved run is still as long as possible, and clipping the runs
+                // to our bounds can't make any two of them touch.
+                if (_runs.has_value())
+                {
+                    auto& runs = *_runs;
+                    auto kept = runs.begin();
+                    for (auto run : runs)
+                    {
+                        run += delta;
+                        run &= _rc;
+                        if (!run.empty())
+                        {
+                            *kept++ = run;
+                        }
+                    }
+                    runs.erase(kept, runs.end());
+
+                    if (fill)
+                    {
+                        // Find the uncovered region: subtract the moved rectangle
+                        // from the original one to see what wasn't filled by the move.
+                        for (const auto& f : _rc - (_rc + delta))
+                        {
+                            _addRuns(f);
+                        }
+                    }
+                }
             }
 
             void set(const til::point pt)
             {
                 THROW_HR_IF(E_INVALIDARG, !_rc.contains(pt));
-                _runs.reset(); // reset cached runs on any non-const method
 
                 _bits.set(_rc.index_of(pt));
+                _addRuns(til::rectangle{ pt });
             }
 
             void set(const til::rectangle rc)
             {
                 THROW_HR_IF(E_INVALIDARG, !_rc.contains(rc));
-                _runs.reset(); // reset cached runs on any non-const method
 
                 for (auto row = rc.top(); row < rc.bottom(); ++row)
                 {
                     _bits.set(_rc.index_of(til::point{ rc.left(), row }), rc.width(), true);
                 }
+                _addRuns(rc);
             }
 
-            void set_all() noexcept
+            // Sets all the given rectangles. This is cheaper than setting
+            // them one by one, as the runs are only recalculated once.
+            template<typename InputIt>
+            void set(InputIt first, const InputIt last)
             {
                 _runs.reset(); // reset cached runs on any non-const method
+
+                for (; first != last; ++first)
+                {
+                    const til::rectangle rc{ *first };
+                    THROW_HR_IF(E_INVALIDARG, !_rc.contains(rc));
+
+                    for (auto row = rc.top(); row < rc.bottom(); ++row)
+                    {
+                        _bits.set(_rc.index_of(til::point{ rc.left(), row }), rc.width(), true);
+                    }
+                }
+            }
+
+            void set_all() noexcept
+            {
                 _bits.set();
+
+                // The runs are trivial now: one for each row.
+                _runs.reset();
+                try
+                {
+                    auto& runs = _runs.emplace(run_allocator_type{ _alloc });
+                    runs.reserve(_sz.height());
+                    for (ptrdiff_t row = 0; row < _sz.height(); ++row)
+                    {
+                        runs.emplace_back(til::point{ 0, row }, til::size{ _sz.width(), 1 });
+                    }
+                }
+                catch (...)
+                {
+                    _runs.reset(); // they'll be recalculated on demand.
+                }
             }
 
             void reset_all() noexcept
             {
-                _runs.reset(); // reset cached runs on any non-const method
                 _bits.reset();
+
+                // There are no runs left, but keep their memory around for reuse.
+                if (_runs.has_value())
+                {
+                    _runs->clear();
+                }
+            }
+
+            // Sets all bits that are set in the other bitmap, which must have the same size.
+            bitmap& operator|=(const bitmap& other)
+            {
+                THROW_HR_IF(E_INVALIDARG, _sz != other._sz);
+                _runs.reset(); // reset cached runs on any non-const method
+
+                _bits |= other._bits;
+                return *this;
+            }
+
+            // Resets all bits that aren't set in the other bitmap, which must have the same size.
+            bitmap& operator&=(const bitmap& other)
+            {
+                THROW_HR_IF(E_INVALIDARG, _sz != other._sz);
+                _runs.reset(); // reset cached runs on any non-const method
+
+                _bits &= other._bits;
+                return *this;
             }
 
             // True if we resized. False if it was the same size as before.
@@ -473,59 +552,51 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
             }
 
         private:
-            void translate_y(ptrdiff_t delta_y, bool fill)
+            // Adds the rectangle to our cached runs, if we have any, after its bits have been set.
+            // This avoids recalculating all runs when only small areas are set between calls to runs().
+            void _addRuns(const til::rectangle rc) noexcept
             {
-                if (delta_y == 0)
+                if (!_runs.has_value() || rc.empty())
                 {
                     return;
                 }
 
-                const auto bitShift = delta_y * _sz.width();
-
-#pragma warning(push)
-                // we can't depend on GSL here, so we use static_cast for explicit narrowing
-#pragma warning(disable : 26472)
-                const auto newBits = static_cast<size_t>(std::abs(bitShift));
-#pragma warning(pop)
-                const bool isLeftShift = bitShift > 0;
-
-                if (newBits >= _bits.size())
+                try
                 {
-                    if (fill)
-                    {
-                        set_all();
-                    }
-                    else
+                    auto& runs = *_runs;
+                    for (auto row = rc.top(); row < rc.bottom(); ++row)
                     {
-                        reset_all();
-                    }
-                    return;
-                }
+                        auto left = rc.left();
+                        auto right = rc.right();
+
+                        // Runs are sorted by row and then column. Find the first run in this
+                        // row that overlaps or touches the new one, and merge all those that do.
+                        const auto first = std::lower_bound(runs.begin(), runs.end(), row, [&](const til::rectangle& run, ptrdiff_t y) {
+                            return run.top() < y || (run.top() == y && run.right() < left);
+                        });
+                        auto last = first;
+                        for (; last != runs.end() && last->top() == row && last->left() <= right; ++last)
+                        {
+                            left = std::min(left, last->left());
+                            right = std::max(right, last->right());
+                        }
 
-                if (isLeftShift)
-                {
-                    // This operator doesn't modify the size of `_bits`: the
-                    // new bits are set to 0.
-                    _bits <<= newBits;
-                }
-                else
-                {
-                    _bits >>= newBits;
+                        const til::rectangle merged{ til::point{ left, row }, til::size{ right - left, 1 } };
+                        if (first == last)
+                        {
+                            runs.insert(first, merged);
+                        }
+                        else
+                        {
+                            *first = merged;
+                            runs.erase(first + 1, last);
+                        }
+                    }
                 }
-
-                if (fill)
+                catch (...)
                 {
-                    if (isLeftShift)
-                    {
-                        _bits.set(0, newBits, true);
-                    }
-                    else
-                    {
-                        _bits.set(_bits.size() - newBits, newBits, true);
-                    }
+                    _runs.reset(); // they'll be recalculated on demand.
                 }
-
-                _runs.reset(); // reset cached runs on any non-const method
             }
 
             allocator_type _alloc;
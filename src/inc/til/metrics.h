@@ -0,0 +1,391 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#pragma once
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace til::metrics
+{
+    // Counters and histograms for hot paths, readable at runtime and dumpable as text.
+    //
+    // Metrics are meant to be defined as globals next to the code they measure:
+    //   static til::metrics::counter s_framesPainted{ "render.frames" };
+    //   ...
+    //   s_framesPainted.add();
+    // They register themselves with the registry on construction, which can
+    // then be queried or dumped from any thread at any time.
+    //
+    // Recording a value is a relaxed atomic add into one of a fixed number of shards.
+    // Threads are assigned a shard round-robin, so unless there are more busy threads
+    // than shards, threads writing to the same metric don't contend on the same cache
+    // line. Shards are still shared, which is why recording is an atomic operation.
+    // Only reading a metric sums up the shards, which makes reads comparatively
+    // expensive. Recording is always on, so keep it out of per-character paths.
+
+    namespace details
+    {
+        inline constexpr size_t shard_count = 8;
+
+#ifdef __cpp_lib_hardware_interference_size
+        inline constexpr size_t cache_line_size = std::hardware_destructive_interference_size;
+#else
+        inline constexpr size_t cache_line_size = 64;
+#endif
+
+        // Every thread is assigned a shard on first use, round-robin.
+        inline size_t shard_index() noexcept
+        {
+            static std::atomic<size_t> next{ 0 };
+            thread_local const auto index = next.fetch_add(1, std::memory_order_relaxed) % shard_count;
+            return index;
+        }
+
+        // Returns the number of bits needed to represent value, i.e. 0 for 0, 1 for 1, 2 for 2-3, ...
+        inline size_t bit_width(const uint64_t value) noexcept
+        {
+#if defined(_M_X64) || defined(_M_ARM64)
+            unsigned long index;
+            return _BitScanReverse64(&index, value) ? index + 1 : 0;
+#elif defined(_MSC_VER)
+            unsigned long index;
+            if (_BitScanReverse(&index, gsl::narrow_cast<unsigned long>(value >> 32)))
+            {
+                return index + 33;
+            }
+            return _BitScanReverse(&index, gsl::narrow_cast<unsigned long>(value)) ? index + 1 : 0;
+#else
+            return value ? 64 - __builtin_clzll(value) : 0;
+#endif
+        }
+    }
+
+    enum class kind
+    {
+        counter,
+        histogram,
+    };
+
+    class metric;
+
+    class registry
+    {
+    public:
+        static registry& instance() noexcept
+        {
+            static registry r;
+            return r;
+        }
+
+        void add(metric* m) noexcept
+        {
+            try
+            {
+                std::scoped_lock lock{ _mutex };
+                _metrics.emplace_back(m);
+            }
+            catch (...)
+            {
+                // A metric that failed to register still works, it just can't be found or dumped.
+            }
+        }
+
+        void remove(metric* m) noexcept
+        {
+            std::scoped_lock lock{ _mutex };
+            _metrics.erase(std::remove(_metrics.begin(), _metrics.end(), m), _metrics.end());
+        }
+
+        const metric* find(const std::string_view name) const noexcept;
+        void reset() noexcept;
+        std::string dump() const;
+
+    private:
+        registry() = default;
+
+        mutable std::mutex _mutex;
+        std::vector<metric*> _metrics;
+    };
+
+    class metric
+    {
+    public:
+        metric(const metric&) = delete;
+        metric& operator=(const metric&) = delete;
+
+        std::string_view name() const noexcept
+        {
+            return _name;
+        }
+
+        kind type() const noexcept
+        {
+            return _kind;
+        }
+
+        virtual void reset() noexcept = 0;
+        virtual void format(std::string& out) const = 0;
+
+    protected:
+        metric(const std::string_view name, const kind type) noexcept :
+            _name{ name },
+            _kind{ type }
+        {
+            registry::instance().add(this);
+        }
+
+        virtual ~metric()
+        {
+            registry::instance().remove(this);
+        }
+
+    private:
+        std::string_view _name;
+        kind _kind;
+    };
+
+    // A monotonic sum, like "number of frames painted" or "number of bytes parsed".
+    class counter final : public metric
+    {
+    public:
+        explicit counter(const std::string_view name) noexcept :
+            metric{ name, kind::counter }
+        {
+        }
+
+        void add(const uint64_t value = 1) noexcept
+        {
+            _shards[details::shard_index()].value.fetch_add(value, std::memory_order_relaxed);
+        }
+
+        uint64_t value() const noexcept
+        {
+            uint64_t sum = 0;
+            for (const auto& shard : _shards)
+            {
+                sum += shard.value.load(std::memory_order_relaxed);
+            }
+            return sum;
+        }
+
+        void reset() noexcept override
+        {
+            for (auto& shard : _shards)
+            {
+                shard.value.store(0, std::memory_order_relaxed);
+            }
+        }
+
+        void format(std::string& out) const override
+        {
+            fmt::format_to(std::back_inserter(out), "{:<40} {}\n", name(), value());
+        }
+
+    private:
+        struct alignas(details::cache_line_size) shard
+        {
+            std::atomic<uint64_t> value{ 0 };
+        };
+
+        std::array<shard, details::shard_count> _shards{};
+    };
+
+    // The distribution of a value, like "lock wait time in ns" or "bytes per flush".
+    // Values are sorted into power of two buckets: bucket 0 holds 0, bucket 1 holds 1,
+    // bucket 2 holds 2-3, bucket 3 holds 4-7, and so on. Percentiles are thus
+    // reported as the upper bound of the bucket they fall into.
+    class histogram final : public metric
+    {
+    public:
+        static constexpr size_t bucket_count = 65;
+
+        explicit histogram(const std::string_view name) noexcept :
+            metric{ name, kind::histogram }
+        {
+        }
+
+        void record(const uint64_t value) noexcept
+        {
+            auto& shard = _shards[details::shard_index()];
+            shard.count.fetch_add(1, std::memory_order_relaxed);
+            shard.sum.fetch_add(value, std::memory_order_relaxed);
+            shard.buckets[details::bit_width(value)].fetch_add(1, std::memory_order_relaxed);
+
+            auto max = shard.max.load(std::memory_order_relaxed);
+            while (value > max && !shard.max.compare_exchange_weak(max, value, std::memory_order_relaxed))
+            {
+            }
+        }
+
+        uint64_t count() const noexcept
+        {
+            uint64_t count = 0;
+            for (const auto& shard : _shards)
+            {
+                count += shard.count.load(std::memory_order_relaxed);
+            }
+            return count;
+        }
+
+        uint64_t sum() const noexcept
+        {
+            uint64_t sum = 0;
+            for (const auto& shard : _shards)
+            {
+                sum += shard.sum.load(std::memory_order_relaxed);
+            }
+            return sum;
+        }
+
+        uint64_t max() const noexcept
+        {
+            uint64_t max = 0;
+            for (const auto& shard : _shards)
+            {
+                max = std::max(max, shard.max.load(std::memory_order_relaxed));
+            }
+            return max;
+        }
+
+        // Returns the upper bound of the bucket the given percentile (0-100) falls into.
+        uint64_t percentile(const double p) const noexcept
+        {
+            std::array<uint64_t, bucket_count> buckets{};
+            uint64_t total = 0;
+            for (const auto& shard : _shards)
+            {
+                for (size_t i = 0; i < bucket_count; ++i)
+                {
+                    const auto n = shard.buckets[i].load(std::memory_order_relaxed);
+                    buckets[i] += n;
+                    total += n;
+                }
+            }
+
+            const auto rank = static_cast<uint64_t>(std::ceil(std::clamp(p, 0.0, 100.0) / 100.0 * total));
+            uint64_t seen = 0;
+            for (size_t i = 0; i < bucket_count; ++i)
+            {
+                seen += buckets[i];
+                if (seen >= rank && seen != 0)
+                {
+                    return i == 0 ? 0 : i == 64 ? UINT64_MAX : (uint64_t{ 1 } << i) - 1;
+                }
+            }
+            return 0;
+        }
+
+        void reset() noexcept override
+        {
+            for (auto& shard : _shards)
+            {
+                shard.count.store(0, std::memory_order_relaxed);
+                shard.sum.store(0, std::memory_order_relaxed);
+                shard.max.store(0, std::memory_order_relaxed);
+                for (auto& bucket : shard.buckets)
+                {
+                    bucket.store(0, std::memory_order_relaxed);
+                }
+            }
+        }
+
+        void format(std::string& out) const override
+        {
+            fmt::format_to(std::back_inserter(out),
+                           "{:<40} count={} sum={} max={} p50<={} p90<={} p99<={}\n",
+                           name(),
+                           count(),
+                           sum(),
+                           max(),
+                           percentile(50),
+                           percentile(90),
+                           percentile(99));
+        }
+
+    private:
+        struct alignas(details::cache_line_size) shard
+        {
+            std::atomic<uint64_t> count{ 0 };
+            std::atomic<uint64_t> sum{ 0 };
+            std::atomic<uint64_t> max{ 0 };
+            std::array<std::atomic<uint64_t>, bucket_count> buckets{};
+        };
+
+        std::array<shard, details::shard_count> _shards{};
+    };
+
+    // Records the time between its construction and destruction into a histogram, in nanoseconds.
+    class scoped_timer
+    {
+    public:
+        explicit scoped_timer(histogram& target) noexcept :
+            _target{ target },
+            _start{ std::chrono::steady_clock::now() }
+        {
+        }
+
+        scoped_timer(const scoped_timer&) = delete;
+        scoped_timer& operator=(const scoped_timer&) = delete;
+
+        ~scoped_timer()
+        {
+            const auto elapsed = std::chrono::steady_clock::now() - _start;
+            _target.record(gsl::narrow_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+        }
+
+    private:
+        histogram& _target;
+        std::chrono::steady_clock::time_point _start;
+    };
+
+    // Returns the metric with the given name, or nullptr if there's none.
+    // Use type() to find out whether to static_cast it to a counter or a histogram.
+    inline const metric* registry::find(const std::string_view name) const noexcept
+    {
+        std::scoped_lock lock{ _mutex };
+        const auto it = std::find_if(_metrics.begin(), _metrics.end(), [&](const metric* m) { return m->name() == name; });
+        return it != _metrics.end() ? *it : nullptr;
+    }
+
+    // Resets every registered metric to zero, for instance to measure a single operation.
+    inline void registry::reset() noexcept
+    {
+        std::scoped_lock lock{ _mutex };
+        for (const auto m : _metrics)
+        {
+            m->reset();
+        }
+    }
+
+    // Returns all registered metrics as text, one metric per line, sorted by name.
+    inline std::string registry::dump() const
+    {
+        std::scoped_lock lock{ _mutex };
+        std::vector<const metric*> metrics{ _metrics.begin(), _metrics.end() };
+        std::sort(metrics.begin(), metrics.end(), [](const metric* lhs, const metric* rhs) { return lhs->name() < rhs->name(); });
+
+        std::string out;
+        for (const auto m : metrics)
+        {
+            m->format(out);
+        }
+        return out;
+    }
+
+    inline const metric* find(const std::string_view name) noexcept
+    {
+        return registry::instance().find(name);
+    }
+
+    inline std::string dump()
+    {
+        return registry::instance().dump();
+    }
+
+    inline void reset() noexcept
+    {
+        registry::instance().reset();
+    }
+}
@@ -208,8 +208,6 @@ void Clipboard::StoreSelectionToClipboard(bool const copyFormatting)
     const auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
     const auto& buffer = gci.GetActiveOutputBuffer().GetTextBuffer();
 
-    const auto GetAttributeColors = std::bind(&CONSOLE_INFORMATION::LookupAttributeColors, &gci, std::placeholders::_1);
-
     bool includeCRLF, trimTrailingWhitespace;
     if (WI_IsFlagSet(GetKeyState(VK_SHIFT), KEY_PRESSED))
     {
@@ -221,28 +219,35 @@ void Clipboard::StoreSelectionToClipboard(bool const copyFormatting)
         includeCRLF = trimTrailingWhitespace = true;
     }
 
-    const auto text = buffer.GetText(includeCRLF,
-                                     trimTrailingWhitespace,
-                                     selectionRects,
-                                     GetAttributeColors);
+    // The plain text, HTML and RTF are all generated while walking the selection once.
+    // The colors are only looked up if they're actually going to be used.
+    TextBuffer::SelectionFormatting formatting;
+    if (copyFormatting)
+    {
+        const auto& fontData = gci.GetActiveOutputBuffer().GetCurrentFont();
+        formatting.GetAttributeColors = std::bind(&CONSOLE_INFORMATION::LookupAttributeColors, &gci, std::placeholders::_1);
+        formatting.fontHeightPoints = fontData.GetUnscaledSize().Y * 72 / ServiceLocator::LocateGlobals().dpi;
+        formatting.fontFaceName = fontData.GetFaceName();
+        formatting.backgroundColor = gci.GetDefaultBackground();
+        formatting.html = true;
+        formatting.rtf = true;
+    }
 
-    CopyTextToSystemClipboard(text, copyFormatting);
+    const auto data = buffer.GetSelectionData(includeCRLF,
+                                              trimTrailingWhitespace,
+                                              selectionRects,
+                                              formatting);
+
+    CopyTextToSystemClipboard(data);
 }
 
 // Routine Description:
 // - Copies the text given onto the global system clipboard.
 // Arguments:
-// - rows - Rows of text data to copy
-// - fAlsoCopyFormatting - true if the color and formatting should also be copied, false otherwise
-void Clipboard::CopyTextToSystemClipboard(const TextBuffer::TextAndColor& rows, bool const fAlsoCopyFormatting)
+// - data - The selected text, and its HTML and RTF representations if they were generated
+void Clipboard::CopyTextToSystemClipboard(const TextBuffer::SelectionData& data)
 {
-    std::wstring finalString;
-
-    // Concatenate strings into one giant string to put onto the clipboard.
-    for (const auto& str : rows.text)
-    {
-        finalString += str;
-    }
+    const auto& finalString = data.text;
 
     // allocate the final clipboard data
     const size_t cchNeeded = finalString.size() + 1;
@@ -270,17 +275,14 @@ void Clipboard::CopyTextToSystemClipboard(const TextBuffer::TextAndColor& rows,
         THROW_LAST_ERROR_IF(!EmptyClipboard());
         THROW_LAST_ERROR_IF_NULL(SetClipboardData(CF_UNICODETEXT, globalHandle.get()));
 
-        if (fAlsoCopyFormatting)
+        if (!data.html.empty())
         {
-            const auto& fontData = ServiceLocator::LocateGlobals().getConsoleInformation().GetActiveOutputBuffer().GetCurrentFont();
-            int const iFontHeightPoints = fontData.GetUnscaledSize().Y * 72 / ServiceLocator::LocateGlobals().dpi;
-            const COLORREF bgColor = ServiceLocator::LocateGlobals().getConsoleInformation().GetDefaultBackground();
-
-            std::string HTMLToPlaceOnClip = TextBuffer::GenHTML(rows, iFontHeightPoints, fontData.GetFaceName(), bgColor);
-            CopyToSystemClipboard(HTMLToPlaceOnClip, L"HTML Format");
+            CopyToSystemClipboard(data.html, L"HTML Format");
+        }
 
-            std::string RTFToPlaceOnClip = TextBuffer::GenRTF(rows, iFontHeightPoints, fontData.GetFaceName(), bgColor);
-            CopyToSystemClipboard(RTFToPlaceOnClip, L"Rich Text Format");
+        if (!data.rtf.empty())
+        {
+            CopyToSystemClipboard(data.rtf, L"Rich Text Format");
         }
     }
 
@@ -1641,6 +1641,98 @@ class UiaTextRangeTests
         }
     }
 
+    TEST_METHOD(FindAttributeOnLongRuns)
+    {
+        // Screen readers search for attributes across the entire buffer. Those searches
+        // look at runs of attributes, so they're fast for the long runs that are typical
+        // of terminal output. This tests that the results match the attributes of the
+        // individual cells, and logs how long a search over the entire buffer takes.
+        const auto bufferSize{ _pTextBuffer->GetSize() };
+        const auto documentEnd{ bufferSize.EndExclusive() };
+
+        // Set up the buffer's attributes: a long italic run spanning multiple rows.
+        TextAttribute italicAttr;
+        italicAttr.SetItalic(true);
+        const COORD runStart{ 10, gsl::narrow<SHORT>(bufferSize.Height() / 2) };
+        const auto runLength{ bufferSize.Width() * 2 + 10 };
+        _pTextBuffer->Write(OutputCellIterator{ italicAttr, gsl::narrow<size_t>(runLength) }, runStart);
+
+        // Find the expected result by looking at every cell.
+        std::optional<COORD> expectedStart;
+        COORD expectedEnd{};
+        for (auto iter{ _pTextBuffer->GetCellDataAt({ 0, 0 }) }; iter; ++iter)
+        {
+            if (iter->TextAttr().IsItalic())
+            {
+                if (!expectedStart)
+                {
+                    expectedStart = iter.Pos();
+                }
+                expectedEnd = iter.Pos();
+            }
+        }
+        VERIFY_IS_TRUE(expectedStart.has_value());
+        bufferSize.IncrementInBounds(expectedEnd, true);
+        VERIFY_ARE_EQUAL(runStart, *expectedStart);
+
+        Microsoft::WRL::ComPtr<UiaTextRange> utr;
+        THROW_IF_FAILED(Microsoft::WRL::MakeAndInitialize<UiaTextRange>(&utr, _pUiaData, &_dummyProvider, COORD{ 0, 0 }, documentEnd));
+
+        VARIANT var{};
+        var.vt = VT_BOOL;
+        var.boolVal = true;
+
+        for (const auto searchBackwards : { false, true })
+        {
+            Log::Comment(searchBackwards ? L"Find the italic run - Backwards" : L"Find the italic run");
+            Microsoft::WRL::ComPtr<ITextRangeProvider> result;
+            VERIFY_SUCCEEDED(utr->FindAttribute(UIA_IsItalicAttributeId, var, searchBackwards, result.GetAddressOf()));
+            VERIFY_IS_NOT_NULL(result.Get());
+
+            Microsoft::WRL::ComPtr<UiaTextRange> resultUtr{ static_cast<UiaTextRange*>(result.Get()) };
+            VERIFY_ARE_EQUAL(*expectedStart, resultUtr->_start);
+            VERIFY_ARE_EQUAL(expectedEnd, resultUtr->_end);
+
+            Log::Comment(L"The found range should be italic throughout");
+            VARIANT value;
+            VERIFY_SUCCEEDED(result->GetAttributeValue(UIA_IsItalicAttributeId, &value));
+            VERIFY_ARE_EQUAL(VT_BOOL, value.vt);
+            VERIFY_IS_TRUE(value.boolVal);
+        }
+
+        {
+            Log::Comment(L"The entire buffer has mixed italics");
+            Microsoft::WRL::ComPtr<IUnknown> mixedVal;
+            THROW_IF_FAILED(UiaGetReservedMixedAttributeValue(&mixedVal));
+            VARIANT value;
+            VERIFY_SUCCEEDED(utr->GetAttributeValue(UIA_IsItalicAttributeId, &value));
+            VERIFY_ARE_EQUAL(VT_UNKNOWN, value.vt);
+            VERIFY_ARE_EQUAL(mixedVal.Get(), value.punkVal);
+        }
+
+        {
+            Log::Comment(L"Search for an attribute that isn't in the buffer. This has to look at the entire buffer.");
+            VARIANT strikethrough{};
+            strikethrough.vt = VT_I4;
+            strikethrough.lVal = TextDecorationLineStyle_Single;
+
+            using clock = std::chrono::steady_clock;
+            using duration = std::chrono::duration<double, std::micro>;
+            constexpr auto iterations = 100;
+
+            const auto start = clock::now();
+            for (auto i = 0; i < iterations; ++i)
+            {
+                Microsoft::WRL::ComPtr<ITextRangeProvider> result;
+                VERIFY_SUCCEEDED(utr->FindAttribute(UIA_StrikethroughStyleAttributeId, strikethrough, false, result.GetAddressOf()));
+                VERIFY_IS_NULL(result.Get());
+            }
+            const duration elapsed = clock::now() - start;
+
+            Log::Comment(NoThrowString().Format(L"%dx%d buffer: %.1fus per search", bufferSize.Width(), bufferSize.Height(), elapsed.count() / iterations));
+        }
+    }
+
     TEST_METHOD(BlockRange)
     {
         // This test replicates GH#7960.
@@ -5,6 +5,8 @@
 
 #include "renderer.hpp"
 
+#include <til/metrics.h>
+
 #pragma hdrstop
 
 using namespace Microsoft::Console::Render;
@@ -16,6 +18,10 @@ static constexpr auto maxRetriesForRenderEngine = 3;
 // The renderer will wait this number of milliseconds * how many tries have elapsed before trying again.
 static constexpr auto renderBackoffBaseTimeMilliseconds{ 150 };
 
+static til::metrics::counter s_framesPainted{ "render.frames" };
+static til::metrics::counter s_rowsPainted{ "render.rows" };
+static til::metrics::counter s_paintNotificationsCoalesced{ "render.notifications_coalesced" };
+
 // Routine Description:
 // - Creates a new renderer controller for a console.
 // Arguments:
@@ -131,6 +137,8 @@ try
         return S_OK;
     }
 
+    s_framesPainted.add();
+
     auto endPaint = wil::scope_exit([&]() {
         LOG_IF_FAILED(pEngine->EndPaint());
 
@@ -186,6 +194,14 @@ CATCH_RETURN()
 
 void Renderer::_NotifyPaintFrame()
 {
+    // Paint notifications of a thread that currently defers them are sent once it's done.
+    if (_paintNotificationsDeferredThread.load(std::memory_order_relaxed) == GetCurrentThreadId())
+    {
+        s_paintNotificationsCoalesced.add();
+        _paintNotificationPending = true;
+        return;
+    }
+
     // If we're running in the unittests, we might not have a render thread.
     if (_pThread)
     {
@@ -194,6 +210,45 @@ void Renderer::_NotifyPaintFrame()
     }
 }
 
+// Method Description:
+// - Holds back paint notifications made on the calling thread until a matching
+//   call to ResumePaintNotifications. Invalidations are still passed on to the
+//   engines right away, only waking up the render thread is deferred.
+// - This lets a thread that makes many changes in a row, like the console IO thread
+//   servicing an API call, notify the render thread once for all of them instead of
+//   having it wake up and contend for the console lock after each one.
+// - Calls can be nested. Only one thread may defer notifications at a time.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void Renderer::DeferPaintNotifications() noexcept
+{
+    if (_paintNotificationsDeferred++ == 0)
+    {
+        _paintNotificationsDeferredThread.store(GetCurrentThreadId(), std::memory_order_relaxed);
+    }
+}
+
+// Method Description:
+// - Ends a DeferPaintNotifications call. Once the outermost one ends,
+//   the render thread is notified if a paint was requested in between.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void Renderer::ResumePaintNotifications()
+{
+    if (_paintNotificationsDeferred != 0 && --_paintNotificationsDeferred == 0)
+    {
+        _paintNotificationsDeferredThread.store(0, std::memory_order_relaxed);
+        if (std::exchange(_paintNotificationPending, false))
+        {
+            _NotifyPaintFrame();
+        }
+    }
+}
+
 // Routine Description:
 // - Called when the system has requested we redraw a portion of the console.
 // Arguments:
@@ -705,6 +760,7 @@ void Renderer::_PaintBufferOutput(_In_ IRenderEngine* const pEngine)
             const auto& buffer = _pData->GetTextBuffer();
 
             // Now walk through each row of text that we need to redraw.
+            s_rowsPainted.add(gsl::narrow_cast<uint64_t>(redraw.Height()));
             for (auto row = redraw.Top(); row < redraw.BottomExclusive(); row++)
             {
                 // Calculate the boundaries of a single line. This is from the left to right edge of the dirty
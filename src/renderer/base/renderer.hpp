@@ -81,6 +81,9 @@ namespace Microsoft::Console::Render
 
         void AddRenderEngine(_In_ IRenderEngine* const pEngine) override;
 
+        void DeferPaintNotifications() noexcept override;
+        void ResumePaintNotifications() override;
+
         void SetRendererEnteredErrorStateCallback(std::function<void()> pfn);
         void ResetErrorStateAndResume();
 
@@ -94,6 +97,10 @@ namespace Microsoft::Console::Render
         std::unique_ptr<IRenderThread> _pThread;
         bool _destructing = false;
 
+        size_t _paintNotificationsDeferred = 0;
+        std::atomic<DWORD> _paintNotificationsDeferredThread{ 0 };
+        bool _paintNotificationPending = false;
+
         std::optional<interval_tree::IntervalTree<til::point, size_t>::interval> _hoveredInterval;
 
         void _NotifyPaintFrame();
@@ -66,6 +66,9 @@ namespace Microsoft::Console::Render
 
         virtual void AddRenderEngine(_In_ IRenderEngine* const pEngine) = 0;
 
+        virtual void DeferPaintNotifications() noexcept = 0;
+        virtual void ResumePaintNotifications() = 0;
+
     protected:
         IRenderer() = default;
     };
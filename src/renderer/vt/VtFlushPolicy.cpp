@@ -0,0 +1,44 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+
+#include "VtFlushPolicy.hpp"
+
+#pragma hdrstop
+
+using namespace Microsoft::Console::Render;
+
+// Routine Description:
+// - Called at the end of every frame, to decide whether the buffered output
+//   should be written now or held back to be written together with the next frame.
+// Arguments:
+// - frameBytes - the number of bytes the frame that just ended produced
+// - pendingBytes - the number of bytes buffered in total, including this frame
+// - pendingSince - when the oldest of the buffered bytes was buffered
+// - now - the current time
+// Return Value:
+// - true if the buffered output should be written now.
+bool VtFlushPolicy::ShouldFlush(const size_t frameBytes,
+                                const size_t pendingBytes,
+                                const clock::time_point pendingSince,
+                                const clock::time_point now) noexcept
+{
+    const auto inBurst = _lastFrameBytes > InteractiveFrameBytes && now - _lastFrameEnd < BurstWindow;
+    _lastFrameBytes = frameBytes;
+    _lastFrameEnd = now;
+
+    if (pendingBytes == 0)
+    {
+        return false;
+    }
+
+    // Echo and other small updates shouldn't wait for anything. If a burst is
+    // still buffered, it's written along with them, which keeps the order intact.
+    if (frameBytes <= InteractiveFrameBytes || !inBurst)
+    {
+        return true;
+    }
+
+    return pendingBytes >= BurstByteBudget || now - pendingSince >= BurstTimeBudget;
+}
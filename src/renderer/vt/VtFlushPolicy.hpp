@@ -0,0 +1,43 @@
+/*++
+Copyright (c) Microsoft Corporation
+Licensed under the MIT license.
+
+Module Name:
+- VtFlushPolicy.hpp
+
+Abstract:
+- Decides when the output the VtEngine buffered for a frame is written to the pipe.
+- Small frames after a quiet period, like the echo of a keystroke, are written
+  immediately. While the client produces a burst of large frames, they're
+  batched into fewer, bigger writes, until a byte or a time budget is exceeded.
+--*/
+
+#pragma once
+
+namespace Microsoft::Console::Render
+{
+    class VtFlushPolicy final
+    {
+    public:
+        using clock = std::chrono::steady_clock;
+
+        // Frames up to this size are considered interactive and always written immediately.
+        static constexpr size_t InteractiveFrameBytes = 256;
+        // A frame that ends within this time of a large frame belongs to a burst.
+        // It's roughly two ticks of the render thread.
+        static constexpr clock::duration BurstWindow = std::chrono::milliseconds{ 20 };
+        // During a burst, output is written once this much has been buffered...
+        static constexpr size_t BurstByteBudget = 64 * 1024;
+        // ...or once the oldest buffered output has waited this long.
+        static constexpr clock::duration BurstTimeBudget = std::chrono::milliseconds{ 16 };
+
+        bool ShouldFlush(const size_t frameBytes,
+                         const size_t pendingBytes,
+                         const clock::time_point pendingSince,
+                         const clock::time_point now) noexcept;
+
+    private:
+        size_t _lastFrameBytes{ 0 };
+        clock::time_point _lastFrameEnd{};
+    };
+}
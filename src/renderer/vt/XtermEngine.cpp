@@ -37,6 +37,11 @@ XtermEngine::XtermEngine(_In_ wil::unique_hfile hPipe,
 {
     RETURN_IF_FAILED(VtEngine::StartPaint());
 
+    if (_inPassthrough)
+    {
+        return S_FALSE;
+    }
+
     _trace.TraceLastText(_lastText);
 
     // Prep us to think that the cursor is not visible this frame. If it _is_
@@ -97,10 +102,11 @@ XtermEngine::XtermEngine(_In_ wil::unique_hfile hPipe,
     if (_needToDisableCursor)
     {
         // If the cursor was previously visible, let's hide it for this frame,
-        // by prepending a cursor off.
+        // by prepending a cursor off. The buffer may still hold earlier
+        // frames that were batched, so insert it where this frame starts.
         if (_lastCursorIsVisible)
         {
-            _buffer.insert(0, "\x1b[?25l");
+            _buffer.insert(std::min(_frameStart, _buffer.size()), "\x1b[?25l");
             _lastCursorIsVisible = false;
         }
         // If the cursor was NOT previously visible, then that's fine! we don't
@@ -131,6 +137,26 @@ XtermEngine::XtermEngine(_In_ wil::unique_hfile hPipe,
     return S_OK;
 }
 
+// Method Description:
+// - Takes over the state the forwarded client output left the terminal in. In
+//   addition to what VtEngine does, this remembers whether the cursor was left
+//   visible, so that we don't toggle it needlessly on the next frame.
+// Arguments:
+// - cursor: The position of the cursor, relative to the viewport.
+// - cursorVisible: Whether the cursor is visible.
+// - attributes: The current text attributes.
+// Return Value:
+// - <none>
+void XtermEngine::_SetPassthroughState(const COORD cursor,
+                                       const bool cursorVisible,
+                                       const TextAttribute& attributes) noexcept
+{
+    _needToDisableCursor = false;
+    _lastCursorIsVisible = cursorVisible;
+    _nextCursorIsVisible = cursorVisible;
+    VtEngine::_SetPassthroughState(cursor, cursorVisible, attributes);
+}
+
 // Routine Description:
 // - Write a VT sequence to change the current colors of text. Only writes
 //      16-color attributes.
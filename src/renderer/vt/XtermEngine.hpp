@@ -62,6 +62,10 @@ namespace Microsoft::Console::Render
 
         [[nodiscard]] HRESULT _DoUpdateTitle(const std::wstring_view newTitle) noexcept override;
 
+        void _SetPassthroughState(const COORD cursor,
+                                  const bool cursorVisible,
+                                  const TextAttribute& attributes) noexcept override;
+
 #ifdef UNIT_TESTING
         friend class VtRendererTest;
         friend class ConptyOutputTests;
@@ -108,7 +108,9 @@ CATCH_RETURN();
 [[nodiscard]] HRESULT VtEngine::InvalidateCircling(_Out_ bool* const pForcePaint) noexcept
 {
     // If we're in the middle of a resize request, don't try to immediately start a frame.
-    if (_inResizeRequest)
+    // The same goes for passed through output, which already contains the lines
+    // that are about to be circled out of the buffer.
+    if (_inResizeRequest || _inPassthrough)
     {
         *pForcePaint = false;
     }
@@ -133,9 +135,24 @@ CATCH_RETURN();
 // Arguments:
 // - Receives a bool indicating if we should force the repaint.
 // Return Value:
-// - S_OK
+// - S_OK or suitable HRESULT error from writing pipe.
 [[nodiscard]] HRESULT VtEngine::PrepareForTeardown(_Out_ bool* const pForcePaint) noexcept
 {
     *pForcePaint = true;
-    return S_OK;
+
+    // Forget about any burst, so that the final frame is flushed right away.
+    _flushPolicy = VtFlushPolicy{};
+    return _buffer.empty() ? S_OK : _Flush();
+}
+
+// Routine Description:
+// - Asks the renderer to keep painting while the flush policy holds back
+//   output, so that the next frame, empty or not, flushes it.
+// Arguments:
+// - <none>
+// Return Value:
+// - true if there's buffered output waiting to be written.
+[[nodiscard]] bool VtEngine::RequiresContinuousRedraw() noexcept
+{
+    return !_pipeBroken && !_buffer.empty();
 }
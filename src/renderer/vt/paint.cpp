@@ -20,11 +20,21 @@ using namespace Microsoft::Console::Types;
 //      HRESULT error code if painting didn't start successfully.
 [[nodiscard]] HRESULT VtEngine::StartPaint() noexcept
 {
-    if (_pipeBroken)
+    // A client that stopped writing in the middle of a sequence mustn't keep
+    // the terminal from being updated forever.
+    if (_passthroughPaused && VtFlushPolicy::clock::now() - _passthroughPausedSince >= PassthroughPauseTimeout)
+    {
+        LOG_IF_FAILED(AbortPassthrough());
+    }
+
+    // While client output is passed through, it keeps the terminal up to date.
+    if (_pipeBroken || _inPassthrough)
     {
         return S_FALSE;
     }
 
+    _frameStart = _buffer.size();
+
     // If there's nothing to do, quick return
     bool somethingToDo = _invalidMap.any() ||
                          _scrollDelta != til::point{ 0, 0 } ||
@@ -32,6 +42,13 @@ using namespace Microsoft::Console::Types;
                          _titleChanged;
 
     _quickReturn = !somethingToDo;
+
+    // A frame with nothing to paint means that a burst of output is over,
+    // so don't hold on to what the flush policy batched up during it.
+    if (_quickReturn && !_buffer.empty())
+    {
+        RETURN_IF_FAILED(_Flush());
+    }
     _trace.TraceStartPaint(_quickReturn,
                            _invalidMap,
                            _lastViewport.ToInclusive(),
@@ -82,7 +99,7 @@ using namespace Microsoft::Console::Types;
         RETURN_IF_FAILED(_MoveCursor(_deferredCursorPos));
     }
 
-    RETURN_IF_FAILED(_Flush());
+    RETURN_IF_FAILED(_FlushFrame());
 
     return S_OK;
 }
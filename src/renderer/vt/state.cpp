@@ -10,6 +10,8 @@
 #include <conio.h>
 #include <cstdarg>
 
+#include <til/metrics.h>
+
 #pragma hdrstop
 
 using namespace Microsoft::Console;
@@ -18,6 +20,10 @@ using namespace Microsoft::Console::Types;
 
 const COORD VtEngine::INVALID_COORDS = { -1, -1 };
 
+static til::metrics::histogram s_flushBytes{ "vt.render.flush_bytes" };
+static til::metrics::histogram s_flushLatency{ "vt.render.flush_latency_ns" };
+static til::metrics::counter s_framesBatched{ "vt.render.frames_batched" };
+
 // Routine Description:
 // - Creates a new VT-based rendering engine
 // - NOTE: Will throw if initialization failure. Caller must catch.
@@ -75,6 +81,28 @@ VtEngine::VtEngine(_In_ wil::unique_hfile pipe,
 // - S_OK or suitable HRESULT error from writing pipe.
 [[nodiscard]] HRESULT VtEngine::_Write(std::string_view const str) noexcept
 {
+    // While client output is passed through, it's the only thing the terminal gets to see.
+    // Between two writes that leave a sequence unfinished, our own output is held back
+    // instead, since it would end up in the middle of the client's sequence otherwise.
+    // If too much of it piles up, we give up on the client's sequence instead.
+    if (_inPassthrough)
+    {
+        if (!_passthroughPaused)
+        {
+            return S_OK;
+        }
+        if (_passthroughHeldOutput.size() + str.size() <= PassthroughHeldOutputLimit)
+        {
+            try
+            {
+                _passthroughHeldOutput.append(str);
+            }
+            CATCH_RETURN();
+            return S_OK;
+        }
+        RETURN_IF_FAILED(AbortPassthrough());
+    }
+
     _trace.TraceString(str);
 #ifdef UNIT_TESTING
     if (_usingTestCallback)
@@ -96,6 +124,10 @@ VtEngine::VtEngine(_In_ wil::unique_hfile pipe,
 
     try
     {
+        if (_buffer.empty())
+        {
+            _bufferedSince = VtFlushPolicy::clock::now();
+        }
         _buffer.append(str);
 
         return S_OK;
@@ -109,13 +141,21 @@ VtEngine::VtEngine(_In_ wil::unique_hfile pipe,
     if (_hFile.get() == INVALID_HANDLE_VALUE)
     {
         // Do not flush during Unit Testing because we won't have a valid file.
+        _buffer.clear();
         return S_OK;
     }
 #endif
 
     if (!_pipeBroken)
     {
+        s_flushBytes.record(_buffer.size());
         bool fSuccess = !!WriteFile(_hFile.get(), _buffer.data(), gsl::narrow_cast<DWORD>(_buffer.size()), nullptr, nullptr);
+        if (!_buffer.empty())
+        {
+            // The time from buffering the first byte until it's handed to the terminal.
+            const auto latency = VtFlushPolicy::clock::now() - _bufferedSince;
+            s_flushLatency.record(gsl::narrow_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(latency).count()));
+        }
         _buffer.clear();
         if (!fSuccess)
         {
@@ -132,6 +172,26 @@ VtEngine::VtEngine(_In_ wil::unique_hfile pipe,
     return S_OK;
 }
 
+// Method Description:
+// - Flushes the output of the frame that just ended, unless the flush policy
+//   decides to batch it with the next frame. Output that's held back is
+//   flushed by the next StartPaint that finds nothing to paint.
+// Arguments:
+// - <none>
+// Return Value:
+// - S_OK or suitable HRESULT error from writing pipe.
+[[nodiscard]] HRESULT VtEngine::_FlushFrame() noexcept
+{
+    const auto frameBytes = _buffer.size() - std::min(_frameStart, _buffer.size());
+    if (_pipeBroken || _flushPolicy.ShouldFlush(frameBytes, _buffer.size(), _bufferedSince, VtFlushPolicy::clock::now()))
+    {
+        return _Flush();
+    }
+
+    s_framesBatched.add();
+    return S_OK;
+}
+
 // Method Description:
 // - Wrapper for ITerminalOutputConnection. See _Write.
 [[nodiscard]] HRESULT VtEngine::WriteTerminalUtf8(const std::string_view str) noexcept
@@ -364,6 +424,184 @@ void VtEngine::SetTerminalOwner(Microsoft::Console::ITerminalOwner* const termin
     _terminalOwner = terminalOwner;
 }
 
+// Method Description:
+// - Forwards VT output of a client to the terminal as is, instead of rendering
+//   the changes it makes to the buffer. Until EndPassthrough is called, nothing
+//   else is written to the terminal and no frame is painted, since the forwarded
+//   output brings the terminal up to date on its own.
+// - Changes that are still waiting to be painted weren't made by the client's
+//   output, like those of console API calls. They're repainted once passthrough ends.
+// - Can be called again after PausePassthrough, to forward the client's next write.
+// Arguments:
+// - str: The client's output.
+// Return Value:
+// - S_OK or suitable HRESULT error from writing the pipe.
+[[nodiscard]] HRESULT VtEngine::BeginPassthrough(const std::wstring_view str) noexcept
+{
+    _passthroughRepaintPending |= _invalidMap.any() || _scrollDelta != til::point{ 0, 0 };
+    _passthroughPaused = false;
+
+    // _Write drops everything while passing through, except for the forwarded output.
+    _inPassthrough = false;
+    const auto hr = WriteTerminalW(str);
+    _inPassthrough = true;
+    return hr;
+}
+
+// Method Description:
+// - Ends forwarding one write of client output that left the terminal in the
+//   middle of a sequence. Passthrough stays active until the client's next
+//   write completes the sequence: frames aren't painted and everything else we
+//   write is held back until EndPassthrough, so that none of it is spliced into
+//   the client's sequence. The output forwarded so far is flushed.
+// - Our idea of the terminal's state is set to the state the output left it
+//   in before the unfinished sequence, in case AbortPassthrough drops it.
+// Arguments:
+// - cursor: The position of the cursor, relative to the viewport.
+// - cursorVisible: Whether the cursor is visible.
+// - attributes: The current text attributes.
+// Return Value:
+// - S_OK or suitable HRESULT error from writing the pipe.
+[[nodiscard]] HRESULT VtEngine::PausePassthrough(const COORD cursor,
+                                                 const bool cursorVisible,
+                                                 const TextAttribute& attributes) noexcept
+{
+    _DiscardPassthroughInvalidation();
+    _SetPassthroughState(cursor, cursorVisible, attributes);
+    _passthroughPaused = true;
+    _passthroughPausedSince = VtFlushPolicy::clock::now();
+    return _Flush();
+}
+
+// Method Description:
+// - Gives up on the sequence that the client left unfinished when passthrough
+//   was paused. A CAN makes the terminal drop the sequence, after which it's in
+//   the state PausePassthrough was given, and passthrough ends as usual. VtIo
+//   resets our own state machine before the client's next write.
+// - This is how we get out of a pause that would otherwise never end: when
+//   the client writes output that isn't passed through, when a client
+//   disconnects, when a frame is due after the client hasn't written for
+//   PassthroughPauseTimeout and when more than PassthroughHeldOutputLimit of
+//   our output would be held back.
+// Arguments:
+// - <none>
+// Return Value:
+// - S_OK or suitable HRESULT error from writing the pipe. S_FALSE if
+//   passthrough wasn't paused.
+[[nodiscard]] HRESULT VtEngine::AbortPassthrough() noexcept
+{
+    if (!_passthroughPaused)
+    {
+        return S_FALSE;
+    }
+
+    _inPassthrough = false;
+    _passthroughPaused = false;
+    RETURN_IF_FAILED(_Write("\x18"));
+    return _FinishPassthrough();
+}
+
+// Method Description:
+// - Returns true while passthrough is paused in the middle of a sequence.
+// Arguments:
+// - <none>
+// Return Value:
+// - true iff PausePassthrough was called and passthrough hasn't ended since.
+bool VtEngine::IsPassthroughPaused() const noexcept
+{
+    return _passthroughPaused;
+}
+
+// Method Description:
+// - Drops everything the forwarded output invalidated, since the terminal has
+//   already drawn it itself.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void VtEngine::_DiscardPassthroughInvalidation() noexcept
+{
+    _invalidMap.reset_all();
+    _scrollDelta = { 0, 0 };
+    _clearedAllThisFrame = false;
+    _cursorMoved = false;
+    _circled = false;
+    _firstPaint = false;
+    _skipCursor = false;
+    _newBottomLine = false;
+    _wrappedRow = std::nullopt;
+    _delayedEolWrap = false;
+    _deferredCursorPos = INVALID_COORDS;
+}
+
+// Method Description:
+// - Ends forwarding client output started by BeginPassthrough. Everything that
+//   was invalidated since then has already been drawn by the terminal itself,
+//   so it's dropped, and our idea of the terminal's state is set to the state
+//   the forwarded output left it in. Changes that weren't made by the forwarded
+//   output are repainted with the next frame and output that was held back while
+//   passthrough was paused is written now.
+// Arguments:
+// - cursor: The position of the cursor, relative to the viewport.
+// - cursorVisible: Whether the cursor is visible.
+// - attributes: The current text attributes.
+// Return Value:
+// - S_OK or suitable HRESULT error from writing the pipe.
+[[nodiscard]] HRESULT VtEngine::EndPassthrough(const COORD cursor,
+                                               const bool cursorVisible,
+                                               const TextAttribute& attributes) noexcept
+{
+    _DiscardPassthroughInvalidation();
+    _SetPassthroughState(cursor, cursorVisible, attributes);
+    return _FinishPassthrough();
+}
+
+// Method Description:
+// - Sets our idea of the terminal's state to the state the forwarded client
+//   output left it in.
+// Arguments:
+// - cursor: The position of the cursor, relative to the viewport.
+// - cursorVisible: Whether the cursor is visible.
+// - attributes: The current text attributes.
+// Return Value:
+// - <none>
+void VtEngine::_SetPassthroughState(const COORD cursor,
+                                    const bool /*cursorVisible*/,
+                                    const TextAttribute& attributes) noexcept
+{
+    _lastText = cursor;
+    _lastTextAttributes = attributes;
+}
+
+// Method Description:
+// - Ends passthrough for EndPassthrough and AbortPassthrough. Changes that
+//   weren't made by the forwarded output are repainted with the next frame
+//   and output that was held back while passthrough was paused is written now.
+// Arguments:
+// - <none>
+// Return Value:
+// - S_OK or suitable HRESULT error from writing the pipe.
+[[nodiscard]] HRESULT VtEngine::_FinishPassthrough() noexcept
+{
+    _inPassthrough = false;
+    _passthroughPaused = false;
+
+    // We don't know what the forwarded output overwrote of the changes we
+    // didn't get to paint, or where it scrolled them to. Repaint everything.
+    if (std::exchange(_passthroughRepaintPending, false))
+    {
+        _invalidMap.set_all();
+    }
+
+    if (!_passthroughHeldOutput.empty())
+    {
+        LOG_IF_FAILED(_Write(_passthroughHeldOutput));
+        _passthroughHeldOutput.clear();
+    }
+
+    return _Flush();
+}
+
 // Method Description:
 // - sends a sequence to request the end terminal to tell us the
 //      cursor position. The terminal will reply back on the vt input handle.
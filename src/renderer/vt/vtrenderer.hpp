@@ -20,6 +20,7 @@ Author(s):
 #include "../../inc/ITerminalOwner.hpp"
 #include "../../types/inc/Viewport.hpp"
 #include "tracing.hpp"
+#include "VtFlushPolicy.hpp"
 #include <string>
 #include <functional>
 
@@ -53,6 +54,7 @@ namespace Microsoft::Console::Render
         [[nodiscard]] HRESULT InvalidateAll() noexcept override;
         [[nodiscard]] HRESULT InvalidateCircling(_Out_ bool* const pForcePaint) noexcept override;
         [[nodiscard]] HRESULT PrepareForTeardown(_Out_ bool* const pForcePaint) noexcept override;
+        [[nodiscard]] bool RequiresContinuousRedraw() noexcept override;
 
         [[nodiscard]] virtual HRESULT StartPaint() noexcept override;
         [[nodiscard]] virtual HRESULT EndPaint() noexcept override;
@@ -99,6 +101,16 @@ namespace Microsoft::Console::Render
 
         [[nodiscard]] virtual HRESULT WriteTerminalW(const std::wstring_view str) noexcept = 0;
 
+        [[nodiscard]] HRESULT BeginPassthrough(const std::wstring_view str) noexcept;
+        [[nodiscard]] HRESULT PausePassthrough(const COORD cursor,
+                                               const bool cursorVisible,
+                                               const TextAttribute& attributes) noexcept;
+        [[nodiscard]] HRESULT EndPassthrough(const COORD cursor,
+                                             const bool cursorVisible,
+                                             const TextAttribute& attributes) noexcept;
+        [[nodiscard]] HRESULT AbortPassthrough() noexcept;
+        bool IsPassthroughPaused() const noexcept;
+
         void SetTerminalOwner(Microsoft::Console::ITerminalOwner* const terminalOwner);
         void BeginResizeRequest();
         void EndResizeRequest();
@@ -154,8 +166,29 @@ namespace Microsoft::Console::Render
         bool _resizeQuirk{ false };
         std::optional<TextColor> _newBottomLineBG{ std::nullopt };
 
+        // A paused passthrough is aborted once the client hasn't written for this
+        // long, or once this much of our own output has been held back for it.
+        static constexpr VtFlushPolicy::clock::duration PassthroughPauseTimeout = std::chrono::seconds{ 1 };
+        static constexpr size_t PassthroughHeldOutputLimit = 64 * 1024;
+
+        bool _inPassthrough{ false };
+        bool _passthroughPaused{ false };
+        bool _passthroughRepaintPending{ false };
+        std::string _passthroughHeldOutput;
+        VtFlushPolicy::clock::time_point _passthroughPausedSince{};
+
+        VtFlushPolicy _flushPolicy;
+        VtFlushPolicy::clock::time_point _bufferedSince{};
+        size_t _frameStart{ 0 };
+
         [[nodiscard]] HRESULT _Write(std::string_view const str) noexcept;
+        void _DiscardPassthroughInvalidation() noexcept;
+        virtual void _SetPassthroughState(const COORD cursor,
+                                          const bool cursorVisible,
+                                          const TextAttribute& attributes) noexcept;
+        [[nodiscard]] HRESULT _FinishPassthrough() noexcept;
         [[nodiscard]] HRESULT _Flush() noexcept;
+        [[nodiscard]] HRESULT _FlushFrame() noexcept;
 
         template<typename S, typename... Args>
         [[nodiscard]] HRESULT _WriteFormatted(S&& format, Args&&... args)
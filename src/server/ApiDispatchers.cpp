@@ -281,36 +281,29 @@
     // (This restriction exists because it's going to copy initial into the final buffer, but we don't know that.)
     RETURN_HR_IF(E_INVALIDARG, a->InitialNumBytes > cbBufferSize);
 
-    // Retrieve input parameters.
+    // Retrieve input parameters. They're decoded in place from the message's input buffer,
+    // which reads the entire payload at once, instead of being copied out of it one by one.
     // 1. Exe name making the request
     ULONG const cchExeName = a->ExeNameLength;
     ULONG cbExeName;
     RETURN_IF_FAILED(ULongMult(cchExeName, sizeof(wchar_t), &cbExeName));
-    wistd::unique_ptr<wchar_t[]> pwsExeName;
 
-    if (cchExeName > 0)
-    {
-        pwsExeName = wil::make_unique_nothrow<wchar_t[]>(cchExeName);
-        RETURN_IF_NULL_ALLOC(pwsExeName);
-        RETURN_IF_FAILED(m->ReadMessageInput(0, pwsExeName.get(), cbExeName));
-    }
-    const std::wstring_view exeView(pwsExeName.get(), cchExeName);
-
-    // 2. Existing data in the buffer that was passed in.
+    // 2. Existing data in the buffer that was passed in. It starts immediately after the exe name.
     ULONG const cbInitialData = a->InitialNumBytes;
-    std::unique_ptr<char[]> pbInitialData;
+    ULONG cbInputNeeded;
+    RETURN_IF_FAILED(ULongAdd(cbExeName, cbInitialData, &cbInputNeeded));
 
-    try
+    PVOID pvInputBuffer = nullptr;
+    ULONG cbInputBuffer = 0;
+    if (cbInputNeeded > 0)
     {
-        if (cbInitialData > 0)
-        {
-            pbInitialData = std::make_unique<char[]>(cbInitialData);
-
-            // This parameter starts immediately after the exe name so skip by that many bytes.
-            RETURN_IF_FAILED(m->ReadMessageInput(cbExeName, pbInitialData.get(), cbInitialData));
-        }
+        RETURN_IF_FAILED(m->GetInputBuffer(&pvInputBuffer, &cbInputBuffer));
+        RETURN_HR_IF(E_INVALIDARG, cbInputBuffer < cbInputNeeded);
     }
-    CATCH_RETURN();
+
+    const auto pbInput = static_cast<const char*>(pvInputBuffer);
+    const std::wstring_view exeView(reinterpret_cast<const wchar_t*>(pbInput), cchExeName);
+    const std::string_view initialDataView(cbInitialData > 0 ? pbInput + cbExeName : nullptr, cbInitialData);
 
     // ReadConsole needs this to get the command history list associated with an attached process, but it can be an opaque value.
     HANDLE const hConsoleClient = (HANDLE)m->GetProcessHandle();
@@ -325,7 +318,7 @@
     HRESULT hr;
     if (a->Unicode)
     {
-        const std::string_view initialData(pbInitialData.get(), cbInitialData);
+        const std::string_view initialData(initialDataView);
         const gsl::span<char> outputBuffer(reinterpret_cast<char*>(pvBuffer), cbBufferSize);
         hr = m->_pApiRoutines->ReadConsoleWImpl(*pInputBuffer,
                                                 outputBuffer,
@@ -340,7 +333,7 @@
     }
     else
     {
-        const std::string_view initialData(pbInitialData.get(), cbInitialData);
+        const std::string_view initialData(initialDataView);
         const gsl::span<char> outputBuffer(reinterpret_cast<char*>(pvBuffer), cbBufferSize);
         hr = m->_pApiRoutines->ReadConsoleAImpl(*pInputBuffer,
                                                 outputBuffer,
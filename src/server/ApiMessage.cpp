@@ -6,10 +6,70 @@
 #include <intsafe.h>
 
 #include "ApiMessage.h"
+#include "ApiSorter.h"
 #include "DeviceComm.h"
 
+#include <til/metrics.h>
+
 constexpr size_t structPacketDataSize = sizeof(_CONSOLE_API_MSG) - offsetof(_CONSOLE_API_MSG, Descriptor);
 
+static til::metrics::counter s_bytesRead{ "server.message.bytes_read" };
+static til::metrics::counter s_bytesWritten{ "server.message.bytes_written" };
+static til::metrics::counter s_bytesCopied{ "server.message.bytes_copied" };
+
+namespace
+{
+    struct ApiCounter
+    {
+        explicit ApiCounter(std::string counterName) :
+            name{ std::move(counterName) },
+            counter{ name }
+        {
+        }
+
+        std::string name;
+        til::metrics::counter counter;
+    };
+}
+
+// Routine Description:
+// - Accounts for payload bytes that were copied for the given message, both in the given
+//   total and in a counter for the API the message belongs to ("server.api.<name>.bytes_copied").
+// Arguments:
+// - total - Supplies the counter for the kind of copy.
+// - message - Supplies the message the payload belongs to.
+// - bytes - Supplies the number of bytes copied.
+static void s_RecordBytesCopied(til::metrics::counter& total, const _CONSOLE_API_MSG& message, const size_t bytes) noexcept
+try
+{
+    total.add(bytes);
+
+    // Only API calls have a message header to tell which API they are.
+    if (bytes == 0 || message.Descriptor.Function != CONSOLE_IO_USER_DEFINED)
+    {
+        return;
+    }
+
+    const auto apiName = ApiSorter::GetApiName(message.msgHeader.ApiNumber);
+    if (!apiName)
+    {
+        return;
+    }
+
+    // The counters are created on first use, since most APIs never copy a payload.
+    static std::mutex lock;
+    static std::unordered_map<std::string_view, std::unique_ptr<ApiCounter>> counters;
+
+    std::scoped_lock guard{ lock };
+    auto& counter = counters[apiName];
+    if (!counter)
+    {
+        counter = std::make_unique<ApiCounter>(fmt::format("server.api.{}.bytes_copied", apiName));
+    }
+    counter->counter.add(bytes);
+}
+CATCH_LOG()
+
 _CONSOLE_API_MSG::_CONSOLE_API_MSG()
 {
     // A union cannot have more than one initializer,
@@ -31,6 +91,7 @@ _CONSOLE_API_MSG& _CONSOLE_API_MSG::operator=(const _CONSOLE_API_MSG& other)
     _pApiRoutines = other._pApiRoutines;
     _inputBuffer = other._inputBuffer;
     _outputBuffer = other._outputBuffer;
+    s_RecordBytesCopied(s_bytesCopied, *this, _inputBuffer.size() + _outputBuffer.size());
 
     // Since this struct uses anonymous unions and thus cannot
     // explicitly reference it, we have to a bit cheeky to copy it.
@@ -55,6 +116,36 @@ _CONSOLE_API_MSG& _CONSOLE_API_MSG::operator=(const _CONSOLE_API_MSG& other)
     return *this;
 }
 
+// Routine Description:
+// - Turns this message into the given one, like the copy assignment operator, but takes over its
+//   payload buffers instead of copying them. The other message is left without any buffers.
+// - This is used when a message becomes a wait. The pointers into the buffers remain
+//   valid, so the payload doesn't have to be copied and the wait routine doesn't have
+//   to be told about a new location.
+// Arguments:
+// - other - Supplies the message to take over. It mustn't be used to access its payload afterwards.
+void _CONSOLE_API_MSG::TransferFrom(_CONSOLE_API_MSG& other) noexcept
+{
+    Complete = other.Complete;
+    State = other.State;
+    _pDeviceComm = other._pDeviceComm;
+    _pApiRoutines = other._pApiRoutines;
+    _inputBuffer = std::move(other._inputBuffer);
+    _outputBuffer = std::move(other._outputBuffer);
+
+    memcpy(&Descriptor, &other.Descriptor, structPacketDataSize);
+
+    if (Complete.Write.Data)
+    {
+        Complete.Write.Data = &u;
+    }
+
+    other.State.InputBuffer = nullptr;
+    other.State.InputBufferSize = 0;
+    other.State.OutputBuffer = nullptr;
+    other.State.OutputBufferSize = 0;
+}
+
 ConsoleProcessHandle* _CONSOLE_API_MSG::GetProcessHandle() const
 {
     return reinterpret_cast<ConsoleProcessHandle*>(_pDeviceComm->GetHandle(Descriptor.Process));
@@ -83,7 +174,9 @@ ConsoleHandleData* _CONSOLE_API_MSG::GetObjectHandle() const
     IoOperation.Buffer.Data = pvBuffer;
     IoOperation.Buffer.Size = cbSize;
 
-    return _pDeviceComm->ReadInput(&IoOperation);
+    RETURN_IF_FAILED(_pDeviceComm->ReadInput(&IoOperation));
+    s_RecordBytesCopied(s_bytesRead, *this, cbSize);
+    return S_OK;
 }
 
 // Routine Description:
@@ -106,13 +199,7 @@ try
 
         const ULONG cbReadSize = Descriptor.InputSize - State.ReadOffset;
 
-        // If we were previously called with a huge buffer we have an equally large _inputBuffer.
-        // We shouldn't just keep this huge buffer around, if no one needs it anymore.
-        if (_inputBuffer.capacity() > 16 * 1024 && (_inputBuffer.capacity() >> 1) > cbReadSize)
-        {
-            _inputBuffer.shrink_to_fit();
-        }
-
+        // The buffer comes out of a pool and is returned to it once we're done with this message.
         _inputBuffer.resize(cbReadSize);
 
         RETURN_IF_FAILED(ReadMessageInput(0, _inputBuffer.data(), cbReadSize));
@@ -152,13 +239,7 @@ try
         ULONG cbWriteSize = Descriptor.OutputSize - State.WriteOffset;
         RETURN_IF_FAILED(ULongMult(cbWriteSize, cbFactor, &cbWriteSize));
 
-        // If we were previously called with a huge buffer we have an equally large _outputBuffer.
-        // We shouldn't just keep this huge buffer around, if no one needs it anymore.
-        if (_outputBuffer.capacity() > 16 * 1024 && (_outputBuffer.capacity() >> 1) > cbWriteSize)
-        {
-            _outputBuffer.shrink_to_fit();
-        }
-
+        // The buffer comes out of a pool and is returned to it once we're done with this message.
         _outputBuffer.resize(cbWriteSize);
 
         // 0 it out.
@@ -221,7 +302,10 @@ CATCH_RETURN();
             IoOperation.Buffer.Data = State.OutputBuffer;
             IoOperation.Buffer.Size = (ULONG)Complete.IoStatus.Information;
 
-            LOG_IF_FAILED(_pDeviceComm->WriteOutput(&IoOperation));
+            if (SUCCEEDED_LOG(_pDeviceComm->WriteOutput(&IoOperation)))
+            {
+                s_RecordBytesCopied(s_bytesWritten, *this, IoOperation.Buffer.Size);
+            }
         }
 
         _outputBuffer.clear();
@@ -17,6 +17,7 @@ Revision History:
 
 #pragma once
 
+#include "ApiMessageBuffer.h"
 #include "ApiMessageState.h"
 #include "IApiRoutines.h"
 
@@ -35,6 +36,8 @@ typedef struct _CONSOLE_API_MSG
     _CONSOLE_API_MSG(const _CONSOLE_API_MSG& other);
     _CONSOLE_API_MSG& operator=(const _CONSOLE_API_MSG&);
 
+    void TransferFrom(_CONSOLE_API_MSG& other) noexcept;
+
     ConsoleProcessHandle* GetProcessHandle() const;
     ConsoleHandleData* GetObjectHandle() const;
 
@@ -62,8 +65,8 @@ typedef struct _CONSOLE_API_MSG
     IDeviceComm* _pDeviceComm{ nullptr };
     IApiRoutines* _pApiRoutines{ nullptr };
 
-    boost::container::small_vector<BYTE, 128> _inputBuffer;
-    boost::container::small_vector<BYTE, 128> _outputBuffer;
+    ApiMessageBuffer _inputBuffer;
+    ApiMessageBuffer _outputBuffer;
 
     // From here down is the actual packet data sent/received.
     CD_IO_DESCRIPTOR Descriptor;
@@ -0,0 +1,163 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+
+#include "ApiMessageBuffer.h"
+
+#include <til/metrics.h>
+
+static til::metrics::counter s_bufferAllocations{ "server.message.buffer_allocations" };
+static til::metrics::counter s_bufferReuses{ "server.message.buffer_reuses" };
+
+ApiMessageBuffer::~ApiMessageBuffer()
+{
+    clear();
+}
+
+ApiMessageBuffer::ApiMessageBuffer(const ApiMessageBuffer& other)
+{
+    *this = other;
+}
+
+ApiMessageBuffer& ApiMessageBuffer::operator=(const ApiMessageBuffer& other)
+{
+    if (this != &other)
+    {
+        resize(other._size);
+        std::copy_n(other._data, other._size, _data);
+    }
+    return *this;
+}
+
+ApiMessageBuffer::ApiMessageBuffer(ApiMessageBuffer&& other) noexcept :
+    _data{ std::exchange(other._data, nullptr) },
+    _size{ std::exchange(other._size, 0) },
+    _capacity{ std::exchange(other._capacity, 0) }
+{
+}
+
+ApiMessageBuffer& ApiMessageBuffer::operator=(ApiMessageBuffer&& other) noexcept
+{
+    if (this != &other)
+    {
+        clear();
+        _data = std::exchange(other._data, nullptr);
+        _size = std::exchange(other._size, 0);
+        _capacity = std::exchange(other._capacity, 0);
+    }
+    return *this;
+}
+
+// Routine Description:
+// - Sets the size of the buffer. Unlike a vector, the contents are
+//   NOT preserved if the buffer needs to grow. Callers always fill it anew.
+// Arguments:
+// - size - the new size in bytes
+void ApiMessageBuffer::resize(const size_t size)
+{
+    // Give back buffers that are much larger than what we need, so
+    // that they can be reused by messages that actually need them.
+    if (size > _capacity || _capacity / 2 > std::max(size, ApiMessageBufferPool::MinimumClassSize))
+    {
+        clear();
+        if (size != 0)
+        {
+            _data = ApiMessageBufferPool::Instance().Allocate(size, _capacity);
+        }
+    }
+    _size = size;
+}
+
+// Routine Description:
+// - Returns the memory of this buffer to the pool.
+void ApiMessageBuffer::clear() noexcept
+{
+    if (_data)
+    {
+        ApiMessageBufferPool::Instance().Free(_data, _capacity);
+        _data = nullptr;
+        _size = 0;
+        _capacity = 0;
+    }
+}
+
+ApiMessageBufferPool& ApiMessageBufferPool::Instance() noexcept
+{
+    static ApiMessageBufferPool pool;
+    return pool;
+}
+
+// Routine Description:
+// - Returns the index of the size class for a capacity which is
+//   a power of two between MinimumClassSize and MaximumClassSize.
+size_t ApiMessageBufferPool::_ClassIndex(const size_t capacity) noexcept
+{
+    size_t index = 0;
+    for (auto classSize = MinimumClassSize; classSize < capacity; classSize *= 2)
+    {
+        ++index;
+    }
+    return index;
+}
+
+// Routine Description:
+// - Hands out a buffer of at least the given size, reusing a pooled one if possible.
+// Arguments:
+// - size - the minimum size of the buffer in bytes
+// - capacity - receives the actual size of the buffer, which has to be given back to Free()
+// Return Value:
+// - the buffer. Its contents are unspecified.
+BYTE* ApiMessageBufferPool::Allocate(const size_t size, size_t& capacity)
+{
+    if (size > MaximumClassSize)
+    {
+        s_bufferAllocations.add();
+        capacity = size;
+        return static_cast<BYTE*>(::operator new(size));
+    }
+
+    auto classSize = MinimumClassSize;
+    while (classSize < size)
+    {
+        classSize *= 2;
+    }
+
+    {
+        std::scoped_lock lock{ _lock };
+        auto& sizeClass = til::at(_classes, _ClassIndex(classSize));
+        if (sizeClass.count != 0)
+        {
+            s_bufferReuses.add();
+            capacity = classSize;
+            return til::at(sizeClass.buffers, --sizeClass.count);
+        }
+    }
+
+    s_bufferAllocations.add();
+    auto data = static_cast<BYTE*>(::operator new(classSize));
+    capacity = classSize;
+    return data;
+}
+
+// Routine Description:
+// - Takes back a buffer handed out by Allocate(). It's kept for reuse
+//   if it belongs to a size class that isn't already full.
+// Arguments:
+// - data - the buffer
+// - capacity - the capacity Allocate() returned for it
+void ApiMessageBufferPool::Free(BYTE* const data, const size_t capacity) noexcept
+{
+    if (capacity <= MaximumClassSize)
+    {
+        std::scoped_lock lock{ _lock };
+        auto& sizeClass = til::at(_classes, _ClassIndex(capacity));
+        if (sizeClass.count < MaximumRetainedPerClass)
+        {
+            til::at(sizeClass.buffers, sizeClass.count++) = data;
+            return;
+        }
+    }
+
+    ::operator delete(data);
+}
@@ -0,0 +1,71 @@
+/*++
+Copyright (c) Microsoft Corporation
+Licensed under the MIT license.
+
+Module Name:
+- ApiMessageBuffer.h
+
+Abstract:
+- Holds the input or output payload of an API message.
+- The memory comes from a pool of size classes shared by all messages, so that
+  servicing a stream of calls with similar payload sizes doesn't allocate once
+  the pool has warmed up, even as messages are copied into waits and back.
+- Payloads larger than the biggest size class are allocated on demand and
+  freed when the message is done with them, so a single huge call doesn't
+  permanently increase our memory usage.
+--*/
+
+#pragma once
+
+class ApiMessageBuffer final
+{
+public:
+    ApiMessageBuffer() noexcept = default;
+    ~ApiMessageBuffer();
+
+    ApiMessageBuffer(const ApiMessageBuffer& other);
+    ApiMessageBuffer& operator=(const ApiMessageBuffer& other);
+
+    ApiMessageBuffer(ApiMessageBuffer&& other) noexcept;
+    ApiMessageBuffer& operator=(ApiMessageBuffer&& other) noexcept;
+
+    BYTE* data() noexcept { return _data; }
+    const BYTE* data() const noexcept { return _data; }
+    size_t size() const noexcept { return _size; }
+    size_t capacity() const noexcept { return _capacity; }
+
+    void resize(const size_t size);
+    void clear() noexcept;
+
+private:
+    BYTE* _data = nullptr;
+    size_t _size = 0;
+    size_t _capacity = 0;
+};
+
+class ApiMessageBufferPool final
+{
+public:
+    static constexpr size_t MinimumClassSize = 256;
+    static constexpr size_t MaximumClassSize = 64 * 1024;
+    static constexpr size_t MaximumRetainedPerClass = 4;
+
+    static ApiMessageBufferPool& Instance() noexcept;
+
+    BYTE* Allocate(const size_t size, size_t& capacity);
+    void Free(BYTE* const data, const size_t capacity) noexcept;
+
+private:
+    static constexpr size_t ClassCount = 9; // 256 B, 512 B, ..., 64 KiB
+
+    static size_t _ClassIndex(const size_t capacity) noexcept;
+
+    struct SizeClass
+    {
+        std::array<BYTE*, MaximumRetainedPerClass> buffers{};
+        size_t count = 0;
+    };
+
+    std::mutex _lock;
+    std::array<SizeClass, ClassCount> _classes{};
+};
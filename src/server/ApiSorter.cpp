@@ -132,6 +132,23 @@ const CONSOLE_API_LAYER_DESCRIPTOR ConsoleApiLayerTable[] = {
     { ConsoleApiLayer3, RTL_NUMBER_OF(ConsoleApiLayer3) },
 };
 
+// Routine Description:
+// - Returns the name of the given API, as it's used for tracing.
+// Arguments:
+// - ApiNumber - Supplies the API number from the message header.
+// Return Value:
+// - The name of the API, or nullptr if the number doesn't refer to one.
+PCSTR ApiSorter::GetApiName(const ULONG ApiNumber) noexcept
+{
+    ULONG const LayerNumber = (ApiNumber >> 24) - 1;
+    ULONG const Index = ApiNumber & 0xffffff;
+    if ((LayerNumber >= RTL_NUMBER_OF(ConsoleApiLayerTable)) || (Index >= ConsoleApiLayerTable[LayerNumber].Count))
+    {
+        return nullptr;
+    }
+    return ConsoleApiLayerTable[LayerNumber].Descriptor[Index].TraceName;
+}
+
 // Routine Description:
 // - This routine validates a user IO and dispatches it to the appropriate worker routine.
 // Arguments:
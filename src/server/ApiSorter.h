@@ -41,4 +41,12 @@ public:
     // Return Value:
     // - A pointer to the reply message, if this message is to be completed inline; nullptr if this message will pend now and complete later.
     static PCONSOLE_API_MSG ConsoleDispatchRequest(_Inout_ PCONSOLE_API_MSG Message);
+
+    // Routine Description:
+    // - Returns the name of the given API, as it's used for tracing.
+    // Arguments:
+    // - ApiNumber - Supplies the API number from the message header.
+    // Return Value:
+    // - The name of the API, or nullptr if the number doesn't refer to one.
+    static PCSTR GetApiName(const ULONG ApiNumber) noexcept;
 };
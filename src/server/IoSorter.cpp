@@ -13,8 +13,54 @@
 #include "../host/globals.h"
 
 #include "../host/getset.h"
+#include "../host/handle.h"
 #include "../host/stream.h"
 
+#include "../interactivity/inc/ServiceLocator.hpp"
+
+#include <til/metrics.h>
+
+static til::metrics::counter s_deferredNotificationOperations{ "server.deferred_notification_operations" };
+
+// Routine Description:
+// - Holds back the renderer's paint notifications until the IO operation that's
+//   about to be serviced is done.
+// - Every change an API call makes to the buffer pokes the render thread, which then
+//   wakes up just to contend with us for the console lock. Deferring the notifications
+//   on this thread means the render thread is notified once, for all invalidations
+//   made in between, after the operation has been serviced.
+// - This only spans a single operation. ConDrv hands us one message at a time, so
+//   there's no queue of operations we could service together.
+// - The console lock is deliberately not held while notifications are deferred. Routines like
+//   SetConsoleDisplayModeImpl release the lock before calling into the window, which
+//   then needs the lock on its own thread, and pending ctrl events are only delivered
+//   when the lock is released. Both rely on each routine's lock being the outermost.
+// - Connecting and disconnecting clients may create or tear down the console and its
+//   renderer and wait on other threads while doing so. They're never deferred.
+// Arguments:
+// - pMsg - The operation that is about to be serviced.
+// Return Value:
+// - An object resuming the paint notifications when it goes out of scope.
+static auto s_DeferPaintNotifications(const CONSOLE_API_MSG* const pMsg)
+{
+    const auto function = pMsg->Descriptor.Function;
+    const auto deferred = function != CONSOLE_IO_CONNECT && function != CONSOLE_IO_DISCONNECT;
+    auto renderer = deferred ? ServiceLocator::LocateGlobals().pRender : nullptr;
+
+    if (renderer)
+    {
+        s_deferredNotificationOperations.add();
+        renderer->DeferPaintNotifications();
+    }
+
+    return wil::scope_exit([=]() {
+        if (renderer)
+        {
+            renderer->ResumePaintNotifications();
+        }
+    });
+}
+
 void IoSorter::ServiceIoOperation(_In_ CONSOLE_API_MSG* const pMsg,
                                   _Out_ CONSOLE_API_MSG** ReplyMsg)
 {
@@ -27,6 +73,8 @@ void IoSorter::ServiceIoOperation(_In_ CONSOLE_API_MSG* const pMsg,
 
     pMsg->Complete.Identifier = pMsg->Descriptor.Identifier;
 
+    const auto deferredNotifications = s_DeferPaintNotifications(pMsg);
+
     switch (pMsg->Descriptor.Function)
     {
     case CONSOLE_IO_USER_DEFINED:
@@ -20,15 +20,15 @@
 // Arguments:
 // - pProcessQueue - The queue attached to the client process ID that requested this action
 // - pObjectQueue - The queue attached to the console object that will service the action when data arrives
-// - pWaitReplyMessage - The original API message related to the client process's service request
+// - pWaitReplyMessage - The original API message related to the client process's service request.
+//                       The wait block takes over its payload buffers.
 // - pWaiter - The context to return to later when the wait is satisfied.
 ConsoleWaitBlock::ConsoleWaitBlock(_In_ ConsoleWaitQueue* const pProcessQueue,
                                    _In_ ConsoleWaitQueue* const pObjectQueue,
-                                   const CONSOLE_API_MSG* const pWaitReplyMessage,
+                                   _Inout_ CONSOLE_API_MSG* const pWaitReplyMessage,
                                    _In_ IWaitRoutine* const pWaiter) :
     _pProcessQueue(THROW_HR_IF_NULL(E_INVALIDARG, pProcessQueue)),
     _pObjectQueue(THROW_HR_IF_NULL(E_INVALIDARG, pObjectQueue)),
-    _WaitReplyMessage(*pWaitReplyMessage),
     _pWaiter(THROW_HR_IF_NULL(E_INVALIDARG, pWaiter))
 {
     // MSFT-33127449, GH#9692
@@ -50,17 +50,23 @@ ConsoleWaitBlock::ConsoleWaitBlock(_In_ ConsoleWaitQueue* const pProcessQueue,
     // waiting message or the "wait completer" has a bunch of dangling pointers in it.
     // Oops.
     //
-    // Here, we tell the wait completion routine (which is going to be a COOKED_READ,
-    // RAW_READ, DirectRead or WriteData) about the new buffer location.
+    // Since then, the wait message takes over the buffers of the original message
+    // instead of copying them, which keeps them at the same location. We still tell the
+    // wait completion routine (which is going to be a COOKED_READ, RAW_READ, DirectRead
+    // or WriteData) about the buffer location, so that it doesn't depend on that.
 
-    if (pWaitReplyMessage->State.InputBuffer)
+    const auto oldInputBuffer = pWaitReplyMessage->State.InputBuffer;
+    const auto oldOutputBuffer = pWaitReplyMessage->State.OutputBuffer;
+    _WaitReplyMessage.TransferFrom(*pWaitReplyMessage);
+
+    if (oldInputBuffer)
     {
-        _pWaiter->MigrateUserBuffersOnTransitionToBackgroundWait(pWaitReplyMessage->State.InputBuffer, _WaitReplyMessage.State.InputBuffer);
+        _pWaiter->MigrateUserBuffersOnTransitionToBackgroundWait(oldInputBuffer, _WaitReplyMessage.State.InputBuffer);
     }
 
-    if (pWaitReplyMessage->State.OutputBuffer)
+    if (oldOutputBuffer)
     {
-        _pWaiter->MigrateUserBuffersOnTransitionToBackgroundWait(pWaitReplyMessage->State.OutputBuffer, _WaitReplyMessage.State.OutputBuffer);
+        _pWaiter->MigrateUserBuffersOnTransitionToBackgroundWait(oldOutputBuffer, _WaitReplyMessage.State.OutputBuffer);
     }
 }
 
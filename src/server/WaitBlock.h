@@ -38,7 +38,7 @@ public:
 private:
     ConsoleWaitBlock(_In_ ConsoleWaitQueue* const pProcessQueue,
                      _In_ ConsoleWaitQueue* const pObjectQueue,
-                     const CONSOLE_API_MSG* const pWaitReplyMessage,
+                     _Inout_ CONSOLE_API_MSG* const pWaitReplyMessage,
                      _In_ IWaitRoutine* const pWaiter);
 
     ConsoleWaitQueue* const _pProcessQueue;
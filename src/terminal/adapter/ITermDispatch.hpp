@@ -23,7 +23,9 @@ namespace Microsoft::Console::VirtualTerminal
 class Microsoft::Console::VirtualTerminal::ITermDispatch
 {
 public:
-    using StringHandler = std::function<bool(const wchar_t)>;
+    // Receives the data of a DCS string in chunks of one or more characters.
+    // The end of the string is signalled with a chunk consisting of a single ESC.
+    using StringHandler = std::function<bool(const std::wstring_view)>;
 
 #pragma warning(push)
 #pragma warning(disable : 26432) // suppress rule of 5 violation on interface because tampering with this is fraught with peril
@@ -2496,14 +2496,17 @@ ITermDispatch::StringHandler AdaptDispatch::DownloadDRCS(const size_t fontNumber
         return nullptr;
     }
 
-    return [=](const auto ch) {
+    return [=](const std::wstring_view chunk) {
         // We pass the data string straight through to the font buffer class
         // until we receive an ESC, indicating the end of the string. At that
         // point we can finalize the buffer, and if valid, update the renderer
         // with the constructed bit pattern.
-        if (ch != AsciiChars::ESC)
+        if (chunk.front() != AsciiChars::ESC)
         {
-            _fontBuffer->AddSixelData(ch);
+            for (const auto ch : chunk)
+            {
+                _fontBuffer->AddSixelData(ch);
+            }
         }
         else if (_fontBuffer->FinalizeSixelData())
         {
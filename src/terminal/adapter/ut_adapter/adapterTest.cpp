@@ -2381,12 +2381,12 @@ public:
             const auto stringHandler = _pDispatch.get()->DownloadDRCS(0, 0, ec, cellMatrix, ss, u, cmh, css);
             if (stringHandler)
             {
-                stringHandler(L'B'); // Charset identifier
-                for (auto ch : data)
+                stringHandler(L"B"); // Charset identifier
+                if (!data.empty())
                 {
-                    stringHandler(ch);
+                    stringHandler(data);
                 }
-                stringHandler(L'\033'); // String terminator
+                stringHandler(L"\033"); // String terminator
             }
             return stringHandler != nullptr;
         };
@@ -20,7 +20,10 @@ namespace Microsoft::Console::VirtualTerminal
     class IStateMachineEngine
     {
     public:
-        using StringHandler = std::function<bool(const wchar_t)>;
+        // Receives the data of a DCS or OSC string in chunks of one or more characters.
+        // The end of the string is signalled with a chunk consisting of a single ESC.
+        // Returning false causes the rest of the string to be ignored.
+        using StringHandler = std::function<bool(const std::wstring_view)>;
 
         virtual ~IStateMachineEngine() = 0;
         IStateMachineEngine(const IStateMachineEngine&) = default;
@@ -44,6 +47,7 @@ namespace Microsoft::Console::VirtualTerminal
 
         virtual bool ActionIgnore() = 0;
 
+        virtual StringHandler ActionOscStart(const size_t parameter) = 0;
         virtual bool ActionOscDispatch(const wchar_t wch,
                                        const size_t parameter,
                                        const std::wstring_view string) = 0;
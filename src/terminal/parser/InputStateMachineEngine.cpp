@@ -519,6 +519,19 @@ bool InputStateMachineEngine::ActionIgnore() noexcept
     return true;
 }
 
+// Method Description:
+// - Triggers the OscStart action to give the engine the chance to process the
+//      string of an OSC sequence in chunks, instead of having it buffered.
+// Arguments:
+// - parameter - identifier of the OSC action to perform
+// Return Value:
+// - the string handler function or nullptr if the string should be buffered
+IStateMachineEngine::StringHandler InputStateMachineEngine::ActionOscStart(const size_t /*parameter*/) noexcept
+{
+    // OSC strings are never long enough in the input to be worth streaming.
+    return nullptr;
+}
+
 // Method Description:
 // - Triggers the OscDispatch action to indicate that the listener should handle a control sequence.
 //   These sequences perform various API-type commands that can include many parameters.
@@ -10,12 +10,24 @@
 #include "ascii.hpp"
 #include "../../types/inc/utils.hpp"
 
+#include <til/metrics.h>
+
 using namespace Microsoft::Console;
 using namespace Microsoft::Console::VirtualTerminal;
 
 // the console uses 0xffffffff as an "invalid color" value
 constexpr COLORREF INVALID_COLOR = 0xffffffff;
 
+// See til/metrics.h. These are cheap enough to always be on.
+static til::metrics::counter s_printRuns{ "vt.output.print_runs" };
+static til::metrics::histogram s_printRunLength{ "vt.output.print_run_length" };
+static til::metrics::counter s_executeDispatches{ "vt.output.dispatch.execute" };
+static til::metrics::counter s_escDispatches{ "vt.output.dispatch.esc" };
+static til::metrics::counter s_vt52Dispatches{ "vt.output.dispatch.vt52" };
+static til::metrics::counter s_csiDispatches{ "vt.output.dispatch.csi" };
+static til::metrics::counter s_dcsDispatches{ "vt.output.dispatch.dcs" };
+static til::metrics::counter s_oscDispatches{ "vt.output.dispatch.osc" };
+
 // takes ownership of pDispatch
 OutputStateMachineEngine::OutputStateMachineEngine(std::unique_ptr<ITermDispatch> pDispatch) :
     _dispatch(std::move(pDispatch)),
@@ -45,6 +57,8 @@ ITermDispatch& OutputStateMachineEngine::Dispatch() noexcept
 // - true iff we successfully dispatched the sequence.
 bool OutputStateMachineEngine::ActionExecute(const wchar_t wch)
 {
+    s_executeDispatches.add();
+
     switch (wch)
     {
     case AsciiChars::NUL:
@@ -52,6 +66,10 @@ bool OutputStateMachineEngine::ActionExecute(const wchar_t wch)
         // and have _nothing_ happen. Filter the NULs here, so they don't fill the
         // buffer with empty spaces.
         break;
+    case AsciiChars::CAN:
+        // CAN cancels the sequence it interrupts, which the state machine has
+        // already done by now. Like in the VT220 and later, nothing is printed.
+        break;
     case AsciiChars::BEL:
         _dispatch->WarningBell();
         // microsoft/terminal#2952
@@ -122,6 +140,9 @@ bool OutputStateMachineEngine::ActionPrint(const wchar_t wch)
         _lastPrintedChar = wch;
     }
 
+    // Characters printed one at a time aren't recorded in the print run
+    // metrics: this is the hottest path in the parser, and runs of length
+    // one would only drown out the bulk runs of ActionPrintString.
     _dispatch->Print(wch); // call print
 
     return true;
@@ -148,6 +169,9 @@ bool OutputStateMachineEngine::ActionPrintString(const std::wstring_view string)
         _lastPrintedChar = wch;
     }
 
+    s_printRuns.add();
+    s_printRunLength.record(string.size());
+
     _dispatch->PrintString(string); // call print
 
     return true;
@@ -189,6 +213,8 @@ bool OutputStateMachineEngine::ActionPassThroughString(const std::wstring_view s
 // - true iff we successfully dispatched the sequence.
 bool OutputStateMachineEngine::ActionEscDispatch(const VTID id)
 {
+    s_escDispatches.add();
+
     bool success = false;
 
     switch (id)
@@ -352,6 +378,8 @@ bool OutputStateMachineEngine::ActionEscDispatch(const VTID id)
 // - true iff we successfully dispatched the sequence.
 bool OutputStateMachineEngine::ActionVt52EscDispatch(const VTID id, const VTParameters parameters)
 {
+    s_vt52Dispatches.add();
+
     bool success = false;
 
     switch (id)
@@ -425,6 +453,8 @@ bool OutputStateMachineEngine::ActionVt52EscDispatch(const VTID id, const VTPara
 // - true iff we successfully dispatched the sequence.
 bool OutputStateMachineEngine::ActionCsiDispatch(const VTID id, const VTParameters parameters)
 {
+    s_csiDispatches.add();
+
     bool success = false;
 
     switch (id)
@@ -647,6 +677,8 @@ bool OutputStateMachineEngine::ActionCsiDispatch(const VTID id, const VTParamete
 // - the data string handler function or nullptr if the sequence is not supported
 IStateMachineEngine::StringHandler OutputStateMachineEngine::ActionDcsDispatch(const VTID id, const VTParameters parameters)
 {
+    s_dcsDispatches.add();
+
     StringHandler handler = nullptr;
 
     switch (id)
@@ -697,6 +729,33 @@ bool OutputStateMachineEngine::ActionIgnore() noexcept
     return true;
 }
 
+// Routine Description:
+// - Triggers the OscStart action when the string of an OSC sequence begins.
+//   For sequences with potentially huge payloads, this returns a handler that
+//   processes the string as it arrives, so that it never needs to be buffered.
+// Arguments:
+// - parameter - identifier of the OSC action to perform
+// Return Value:
+// - the string handler function or nullptr if the string should be collected
+//   and passed to ActionOscDispatch instead.
+IStateMachineEngine::StringHandler OutputStateMachineEngine::ActionOscStart(const size_t parameter)
+{
+    // If there's a TTY attached to us, we may have to flush sequences we
+    // can't handle to it, which requires them to be collected in full.
+    if (_pfnFlushToTerminal != nullptr)
+    {
+        return nullptr;
+    }
+
+    switch (parameter)
+    {
+    case OscActionCodes::SetClipboard:
+        return _StreamOscSetClipboard();
+    default:
+        return nullptr;
+    }
+}
+
 // Routine Description:
 // - Triggers the OscDispatch action to indicate that the listener should handle a control sequence.
 //   These sequences perform various API-type commands that can include many parameters.
@@ -710,6 +769,8 @@ bool OutputStateMachineEngine::ActionOscDispatch(const wchar_t /*wch*/,
                                                  const size_t parameter,
                                                  const std::wstring_view string)
 {
+    s_oscDispatches.add();
+
     bool success = false;
 
     switch (parameter)
@@ -1116,6 +1177,67 @@ bool OutputStateMachineEngine::_GetOscSetClipboard(const std::wstring_view strin
     return false;
 }
 
+// Routine Description:
+// - Creates the string handler for an OSC 52 sequence, which is the streaming
+//      equivalent of _GetOscSetClipboard. The base64 payload is decoded as it
+//      arrives, and the clipboard is set once the sequence is terminated.
+// Arguments:
+// - <none>
+// Return Value:
+// - the string handler function
+IStateMachineEngine::StringHandler OutputStateMachineEngine::_StreamOscSetClipboard()
+{
+    return [this,
+            delimited = false,
+            payloadLength = size_t{ 0 },
+            payloadStart = wchar_t{ 0 },
+            decoder = Base64::Decoder{}](const std::wstring_view chunk) mutable {
+        if (chunk.size() == 1 && chunk.front() == AsciiChars::ESC)
+        {
+            s_oscDispatches.add();
+
+            bool success = false;
+            if (delimited && payloadLength == 1 && payloadStart == L'?')
+            {
+                // Querying the clipboard isn't supported.
+                success = true;
+            }
+            else if (delimited)
+            {
+                std::wstring content;
+                success = decoder.Finish(content) && _dispatch->SetClipboard(content);
+            }
+            TermTelemetry::Instance().Log(TermTelemetry::Codes::OSCSCB);
+
+            _ClearLastChar();
+
+            return success;
+        }
+
+        auto data = chunk;
+        if (!delimited)
+        {
+            // Skip the selection parameter, everything up to the first ';'.
+            const auto pos = data.find(L';');
+            if (pos == std::wstring_view::npos)
+            {
+                return true;
+            }
+            delimited = true;
+            data = data.substr(pos + 1);
+        }
+
+        if (payloadLength == 0 && !data.empty())
+        {
+            payloadStart = data.front();
+        }
+        payloadLength += data.size();
+
+        // A lone '?' isn't valid base64, but it's a valid query.
+        return decoder.Feed(data) || payloadLength == 1;
+    };
+}
+
 // Method Description:
 // - Clears our last stored character. The last stored character is the last
 //      graphical character we printed, which is reset if any other action is
@@ -45,6 +45,8 @@ namespace Microsoft::Console::VirtualTerminal
 
         bool ActionIgnore() noexcept override;
 
+        StringHandler ActionOscStart(const size_t parameter) override;
+
         bool ActionOscDispatch(const wchar_t wch,
                                const size_t parameter,
                                const std::wstring_view string) override;
@@ -199,6 +201,7 @@ namespace Microsoft::Console::VirtualTerminal
         bool _GetOscSetClipboard(const std::wstring_view string,
                                  std::wstring& content,
                                  bool& queryClipboard) const noexcept;
+        StringHandler _StreamOscSetClipboard();
 
         static constexpr std::wstring_view hyperlinkIDParameter{ L"id=" };
         bool _ParseHyperlink(const std::wstring_view string,
@@ -65,6 +65,37 @@ std::wstring Base64::s_Encode(const std::wstring_view src) noexcept
     return dst;
 }
 
+// Routine Description:
+// - Returns the value of a single base64 digit.
+// Arguments:
+// - ch - Character to convert.
+// Return Value:
+// - the 6 bit value of ch, or -1 if ch isn't a base64 digit.
+static constexpr int s_DigitValue(const wchar_t ch) noexcept
+{
+    if (ch >= L'A' && ch <= L'Z')
+    {
+        return ch - L'A';
+    }
+    if (ch >= L'a' && ch <= L'z')
+    {
+        return ch - L'a' + 26;
+    }
+    if (ch >= L'0' && ch <= L'9')
+    {
+        return ch - L'0' + 52;
+    }
+    if (ch == L'+')
+    {
+        return 62;
+    }
+    if (ch == L'/')
+    {
+        return 63;
+    }
+    return -1;
+}
+
 // Routine Description:
 // - Decode a base64 string. This requires the base64 string is properly padded.
 //      Otherwise, false will be returned.
@@ -75,109 +106,139 @@ std::wstring Base64::s_Encode(const std::wstring_view src) noexcept
 // - true if decoding successfully, otherwise false.
 bool Base64::s_Decode(const std::wstring_view src, std::wstring& dst) noexcept
 {
-    std::string mbStr;
-    int state = 0;
-    char tmp;
+    Decoder decoder;
+    return decoder.Feed(src) && decoder.Finish(dst);
+}
 
-    const auto len = src.size() / 4 * 3;
-    if (len == 0)
-    {
-        return false;
-    }
-    mbStr.reserve(len);
+// Routine Description:
+// - Decode the next piece of a base64 string. The pieces may be split at any
+//      character, including in the middle of a quantum or the padding.
+// Arguments:
+// - src - The next piece of the string to decode.
+// Return Value:
+// - false if the string is already known to be invalid, otherwise true.
+bool Base64::Decoder::Feed(const std::wstring_view src) noexcept
+{
+    _length += src.size();
 
-    auto iter = src.cbegin();
-    while (iter < src.cend())
+    for (const auto ch : src)
     {
-        if (s_IsSpace(*iter)) // Skip whitespace anywhere.
+        if (s_IsSpace(ch)) // Skip whitespace anywhere.
         {
-            iter++;
             continue;
         }
 
-        if (*iter == padChar)
-        {
-            break;
-        }
-
-        auto pos = strchr(base64Chars, *iter);
-        if (!pos) // A non-base64 character found.
-        {
-            return false;
-        }
-
-        switch (state)
-        {
-        case 0:
-            tmp = (char)(pos - base64Chars) << 2;
-            state = 1;
-            break;
-        case 1:
-            tmp |= (char)(pos - base64Chars) >> 4;
-            mbStr += tmp;
-            tmp = (char)((pos - base64Chars) & 0x0f) << 4;
-            state = 2;
-            break;
-        case 2:
-            tmp |= (char)(pos - base64Chars) >> 2;
-            mbStr += tmp;
-            tmp = (char)((pos - base64Chars) & 0x03) << 6;
-            state = 3;
-            break;
-        case 3:
-            tmp |= pos - base64Chars;
-            mbStr += tmp;
-            state = 0;
-            break;
-        default:
-            break;
-        }
-
-        iter++;
-    }
-
-    if (iter < src.cend()) // Padding char is met.
-    {
-        iter++;
-        switch (state)
+        switch (_phase)
         {
-        // Invalid when state is 0 or 1.
-        case 0:
-        case 1:
-            return false;
-        case 2:
-            // Skip any number of spaces.
-            while (iter < src.cend() && s_IsSpace(*iter))
+        case Phase::Data:
+            if (ch == padChar)
             {
-                iter++;
+                switch (_state)
+                {
+                // Invalid when state is 0 or 1.
+                case 2:
+                    // Make sure there is another trailing padding character.
+                    _phase = Phase::SecondPadding;
+                    break;
+                case 3:
+                    _phase = Phase::TrailingSpaces;
+                    break;
+                default:
+                    _phase = Phase::Failed;
+                    break;
+                }
             }
-            // Make sure there is another trailing padding character.
-            if (iter == src.cend() || *iter != padChar)
+            else if (const auto value = s_DigitValue(ch); value < 0) // A non-base64 character found.
             {
-                return false;
+                _phase = Phase::Failed;
             }
-            iter++; // Skip the padding character and fallthrough to "single trailing padding character" case.
-            [[fallthrough]];
-        case 3:
-            while (iter < src.cend())
+            else
             {
-                if (!s_IsSpace(*iter))
+                switch (_state)
                 {
-                    return false;
+                case 0:
+                    _tmp = (char)(value << 2);
+                    _state = 1;
+                    break;
+                case 1:
+                    _tmp |= (char)(value >> 4);
+                    _decoded += _tmp;
+                    _tmp = (char)((value & 0x0f) << 4);
+                    _state = 2;
+                    break;
+                case 2:
+                    _tmp |= (char)(value >> 2);
+                    _decoded += _tmp;
+                    _tmp = (char)((value & 0x03) << 6);
+                    _state = 3;
+                    break;
+                case 3:
+                    _tmp |= (char)value;
+                    _decoded += _tmp;
+                    _state = 0;
+                    break;
+                default:
+                    break;
                 }
-                iter++;
             }
             break;
+        case Phase::SecondPadding:
+            _phase = ch == padChar ? Phase::TrailingSpaces : Phase::Failed;
+            break;
+        case Phase::TrailingSpaces:
+            // Only spaces may follow the padding.
+            _phase = Phase::Failed;
+            break;
         default:
             break;
         }
+
+        if (_phase == Phase::Failed)
+        {
+            // There's no point in holding on to the data of an invalid string.
+            std::string{}.swap(_decoded);
+            return false;
+        }
     }
-    else if (state != 0) // When no padding, we must be in state 0.
-    {
-        return false;
-    }
 
-    return SUCCEEDED(til::u8u16(mbStr, dst));
+    return true;
+}
+
+// Routine Description:
+// - Completes the decoding of the string fed to the decoder and resets it.
+// Arguments:
+// - dst - Destination to decode into.
+// Return Value:
+// - true if the string was decoded successfully, otherwise false.
+bool Base64::Decoder::Finish(std::wstring& dst) noexcept
+{
+    // The whole string must be at least one quantum long, and when there's
+    // no padding, we must be in state 0.
+    const auto valid = _length >= 4 &&
+                       (_phase == Phase::TrailingSpaces || (_phase == Phase::Data && _state == 0));
+    const auto success = valid && SUCCEEDED(til::u8u16(_decoded, dst));
+    Reset();
+    return success;
+}
+
+// Routine Description:
+// - Discards all data fed to the decoder so far, to start decoding a new string.
+void Base64::Decoder::Reset() noexcept
+{
+    std::string{}.swap(_decoded);
+    _length = 0;
+    _phase = Phase::Data;
+    _state = 0;
+    _tmp = 0;
+}
+
+// Routine Description:
+// - Gets the number of bytes decoded so far.
+// Return Value:
+// - the size of the decoded data in bytes
+size_t Base64::Decoder::DecodedSize() const noexcept
+{
+    return _decoded.size();
 }
 
 // Routine Description:
@@ -19,6 +19,33 @@ namespace Microsoft::Console::VirtualTerminal
         static std::wstring s_Encode(const std::wstring_view src) noexcept;
         static bool s_Decode(const std::wstring_view src, std::wstring& dst) noexcept;
 
+        // Decodes a base64 string that arrives in pieces, like the payload of an
+        // OSC 52 sequence that's split across several writes. Only the decoded
+        // bytes are retained, so the encoded text never needs to be buffered.
+        class Decoder
+        {
+        public:
+            bool Feed(const std::wstring_view src) noexcept;
+            bool Finish(std::wstring& dst) noexcept;
+            void Reset() noexcept;
+            size_t DecodedSize() const noexcept;
+
+        private:
+            enum class Phase
+            {
+                Data,
+                SecondPadding,
+                TrailingSpaces,
+                Failed
+            };
+
+            std::string _decoded;
+            size_t _length = 0;
+            Phase _phase = Phase::Data;
+            int _state = 0;
+            char _tmp = 0;
+        };
+
     private:
         static constexpr bool s_IsSpace(const wchar_t ch) noexcept;
     };
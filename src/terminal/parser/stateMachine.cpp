@@ -7,8 +7,12 @@
 
 #include "ascii.hpp"
 
+#include <til/metrics.h>
+
 using namespace Microsoft::Console::VirtualTerminal;
 
+static til::metrics::counter s_parsedChars{ "vt.parser.chars" };
+
 //Takes ownership of the pEngine.
 StateMachine::StateMachine(std::unique_ptr<IStateMachineEngine> engine) :
     _engine(std::move(engine)),
@@ -18,7 +22,9 @@ StateMachine::StateMachine(std::unique_ptr<IStateMachineEngine> engine) :
     _parameters{},
     _parameterLimitReached(false),
     _oscString{},
+    _maxStringLength(MAX_STRING_LENGTH),
     _cachedSequence{ std::nullopt },
+    _cachedSequenceDiscarded(false),
     _processingIndividually(false)
 {
     _ActionClear();
@@ -29,6 +35,18 @@ void StateMachine::SetAnsiMode(bool ansiMode) noexcept
     _isInAnsiMode = ansiMode;
 }
 
+// Routine Description:
+// - Sets the maximum length of an OSC string. Longer strings are discarded, and
+//   sequences that are longer than this can't be flushed to the terminal.
+// Arguments:
+// - length - The maximum number of characters to buffer for a single sequence.
+// Return Value:
+// - <none>
+void StateMachine::SetMaxStringLength(const size_t length) noexcept
+{
+    _maxStringLength = length;
+}
+
 const IStateMachineEngine& StateMachine::Engine() const noexcept
 {
     return *_engine;
@@ -372,6 +390,36 @@ static constexpr bool _isActionableFromGround(const wchar_t wch) noexcept
     return (wch <= AsciiChars::US) || _isC1ControlCharacter(wch) || _isDelete(wch);
 }
 
+// Routine Description:
+// - Determines if a character in the OscString state is simply collected
+//     into the OSC string, i.e. it doesn't terminate, interrupt or get ignored.
+// Arguments:
+// - wch - Character to check.
+// Return Value:
+// - True if it is. False if it isn't.
+static constexpr bool _isOscStringData(const wchar_t wch) noexcept
+{
+    return wch != AsciiChars::CAN &&
+           wch != AsciiChars::SUB &&
+           !_isC1ControlCharacter(wch) &&
+           !_isEscape(wch) &&
+           !_isOscTerminator(wch) &&
+           !_isOscInvalid(wch);
+}
+
+// Routine Description:
+// - Determines if a character in the DcsPassThrough state is simply passed
+//     through to the string handler, i.e. it doesn't terminate, interrupt or get ignored.
+// Arguments:
+// - wch - Character to check.
+// Return Value:
+// - True if it is. False if it isn't.
+static constexpr bool _isDcsStringData(const wchar_t wch) noexcept
+{
+    // _isC0Code already excludes CAN, SUB and ESC, which end the string.
+    return _isC0Code(wch) || _isDcsPassThroughValid(wch);
+}
+
 #pragma warning(pop)
 
 // Routine Description:
@@ -575,6 +623,9 @@ void StateMachine::_ActionClear()
 
     _oscString.clear();
     _oscParameter = 0;
+    _oscStringLength = 0;
+    _oscStringDiscarded = false;
+    _oscStringHandler = nullptr;
 
     _dcsStringHandler = nullptr;
 
@@ -606,7 +657,8 @@ void StateMachine::_ActionInterrupt()
     if (_state == VTStates::DcsPassThrough)
     {
         // The ESC signals the end of the data string.
-        _dcsStringHandler(AsciiChars::ESC);
+        const wchar_t terminator = AsciiChars::ESC;
+        _dcsStringHandler({ &terminator, 1 });
         _dcsStringHandler = nullptr;
     }
 }
@@ -625,16 +677,65 @@ void StateMachine::_ActionOscParam(const wchar_t wch) noexcept
 }
 
 // Routine Description:
-// - Stores this character as part of the OSC string
+// - Asks the engine whether it wants to receive the OSC string for the collected
+//   param in chunks, instead of having it buffered until the string is complete.
 // Arguments:
-// - wch - Character to dispatch.
+// - <none>
 // Return Value:
 // - <none>
-void StateMachine::_ActionOscPut(const wchar_t wch)
+void StateMachine::_ActionOscStart()
+{
+    _trace.TraceOnAction(L"OscStart");
+
+    _oscStringHandler = _engine->ActionOscStart(_oscParameter);
+}
+
+// Routine Description:
+// - Stores these characters as part of the OSC string, or passes them on to
+//   the engine's string handler if it asked for them in _ActionOscStart.
+// Arguments:
+// - string - Characters to collect.
+// Return Value:
+// - <none>
+void StateMachine::_ActionOscPut(const std::wstring_view string)
 {
     _trace.TraceOnAction(L"OscPut");
 
-    _oscString.push_back(wch);
+    if (_oscStringDiscarded)
+    {
+        return;
+    }
+
+    _oscStringLength += string.size();
+    if (_oscStringLength > _maxStringLength)
+    {
+        _DiscardOscString();
+    }
+    else if (_oscStringHandler)
+    {
+        if (!_oscStringHandler(string))
+        {
+            _DiscardOscString();
+        }
+    }
+    else
+    {
+        _oscString.append(string);
+    }
+}
+
+// Routine Description:
+// - Drops everything collected for the current OSC string, and ignores the
+//   rest of it. The sequence won't be dispatched once it's terminated.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void StateMachine::_DiscardOscString() noexcept
+{
+    _oscStringDiscarded = true;
+    _oscStringHandler = nullptr;
+    std::wstring{}.swap(_oscString);
 }
 
 // Routine Description:
@@ -648,7 +749,22 @@ void StateMachine::_ActionOscDispatch(const wchar_t wch)
 {
     _trace.TraceOnAction(L"OscDispatch");
 
-    const bool success = _engine->ActionOscDispatch(wch, _oscParameter, _oscString);
+    bool success = false;
+    if (_oscStringDiscarded)
+    {
+        // The string was too long, or rejected by its handler.
+    }
+    else if (_oscStringHandler)
+    {
+        // The ESC signals the end of the data string.
+        const wchar_t terminator = AsciiChars::ESC;
+        success = _oscStringHandler({ &terminator, 1 });
+        _oscStringHandler = nullptr;
+    }
+    else
+    {
+        success = _engine->ActionOscDispatch(wch, _oscParameter, _oscString);
+    }
 
     // Trace the result.
     _trace.DispatchSequenceTrace(success);
@@ -729,6 +845,8 @@ void StateMachine::_EnterGround() noexcept
 {
     _state = VTStates::Ground;
     _cachedSequence.reset(); // entering ground means we've completed the pending sequence
+    _cachedSequenceDiscarded = false;
+    _oscStringHandler = nullptr; // an unterminated OSC string won't be dispatched anymore
     _trace.TraceStateChange(L"Ground");
 }
 
@@ -1325,7 +1443,7 @@ void StateMachine::_EventCsiParam(const wchar_t wch)
 // - wch - Character that triggered the event
 // Return Value:
 // - <none>
-void StateMachine::_EventOscParam(const wchar_t wch) noexcept
+void StateMachine::_EventOscParam(const wchar_t wch)
 {
     _trace.TraceOnEvent(L"OscParam");
     if (_isOscTerminator(wch))
@@ -1338,6 +1456,7 @@ void StateMachine::_EventOscParam(const wchar_t wch) noexcept
     }
     else if (_isOscDelimiter(wch))
     {
+        _ActionOscStart();
         _EnterOscString();
     }
     else
@@ -1377,7 +1496,7 @@ void StateMachine::_EventOscString(const wchar_t wch)
     else
     {
         // add this character to our OSC string
-        _ActionOscPut(wch);
+        _ActionOscPut({ &wch, 1 });
     }
 }
 
@@ -1678,7 +1797,7 @@ void StateMachine::_EventDcsPassThrough(const wchar_t wch)
     _trace.TraceOnEvent(L"DcsPassThrough");
     if (_isC0Code(wch) || _isDcsPassThroughValid(wch))
     {
-        if (!_dcsStringHandler(wch))
+        if (!_dcsStringHandler({ &wch, 1 }))
         {
             _EnterDcsIgnore();
         }
@@ -1803,7 +1922,13 @@ bool StateMachine::FlushToTerminal()
 {
     bool success{ true };
 
-    if (success && _cachedSequence.has_value())
+    if (_cachedSequenceDiscarded)
+    {
+        // The start of the sequence is gone, and passing through
+        // only the rest of it would leave the terminal with garbage.
+        success = false;
+    }
+    else if (_cachedSequence.has_value())
     {
         // Flush the partial sequence to the terminal before we flush the rest of it.
         // We always want to clear the sequence, even if we failed, so we don't accumulate bad state
@@ -1835,6 +1960,8 @@ bool StateMachine::FlushToTerminal()
 // - <none>
 void StateMachine::ProcessString(const std::wstring_view string)
 {
+    s_parsedChars.add(string.size());
+
     size_t start = 0;
     size_t current = start;
 
@@ -1852,6 +1979,14 @@ void StateMachine::ProcessString(const std::wstring_view string)
 
         if (_processingIndividually)
         {
+            // OSC and DCS strings can be very long (think OSC 52 or DECDLD),
+            // so their contents are handed over in chunks where possible.
+            if (const auto consumed = _ProcessDataString(string.substr(current)))
+            {
+                current += consumed;
+                continue;
+            }
+
             // If we're processing characters individually, send it to the state machine.
             ProcessCharacter(til::at(string, current));
             ++current;
@@ -1975,16 +2110,76 @@ void StateMachine::ProcessString(const std::wstring_view string)
         {
             // If the engine doesn't require flushing at the end of the string, we
             // want to cache the partial sequence in case we have to flush the whole
-            // thing to the terminal later.
-            if (!_cachedSequence)
+            // thing to the terminal later. Sequences longer than the maximum string
+            // length aren't cached, so that their payload isn't buffered twice.
+            if (!_cachedSequenceDiscarded)
             {
-                _cachedSequence.emplace(std::wstring{});
+                if (!_cachedSequence)
+                {
+                    _cachedSequence.emplace(std::wstring{});
+                }
+
+                auto& cachedSequence = *_cachedSequence;
+                if (cachedSequence.size() + run.size() > _maxStringLength)
+                {
+                    _cachedSequence.reset();
+                    _cachedSequenceDiscarded = true;
+                }
+                else
+                {
+                    cachedSequence.append(run);
+                }
             }
+        }
+    }
+}
 
-            auto& cachedSequence = *_cachedSequence;
-            cachedSequence.append(run);
+// Routine Description:
+// - When in the OscString or DcsPassThrough state, scans ahead for the longest
+//     run of characters that would be collected into the OSC string or passed
+//     through to the DCS string handler one by one, and processes them at once.
+// Arguments:
+// - string - The remaining characters to operate upon.
+// Return Value:
+// - The number of characters that were processed. If this is 0, the first
+//     character needs to be passed to ProcessCharacter instead.
+size_t StateMachine::_ProcessDataString(const std::wstring_view string)
+{
+    if (_state == VTStates::OscString)
+    {
+        const auto end = std::find_if_not(string.begin(), string.end(), _isOscStringData);
+        const auto data = string.substr(0, gsl::narrow_cast<size_t>(end - string.begin()));
+        if (!data.empty())
+        {
+            _ActionOscPut(data);
         }
+        return data.size();
     }
+
+    if (_state == VTStates::DcsPassThrough)
+    {
+        const auto end = std::find_if_not(string.begin(), string.end(), _isDcsStringData);
+        const auto data = string.substr(0, gsl::narrow_cast<size_t>(end - string.begin()));
+        if (!data.empty() && !_dcsStringHandler(data))
+        {
+            _EnterDcsIgnore();
+        }
+        return data.size();
+    }
+
+    return 0;
+}
+
+// Routine Description:
+// - Returns whether the state machine is in the ground state, i.e. not in the
+//     middle of an escape sequence or control string.
+// Arguments:
+// - <none>
+// Return Value:
+// - true if the last character processed completed or wasn't part of a sequence.
+bool StateMachine::IsGround() const noexcept
+{
+    return _state == VTStates::Ground;
 }
 
 // Routine Description:
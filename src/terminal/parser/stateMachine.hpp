@@ -32,6 +32,12 @@ namespace Microsoft::Console::VirtualTerminal
     // that number.
     constexpr size_t MAX_PARAMETER_COUNT = 32;
 
+    // OSC strings longer than this many characters are discarded instead of
+    // being dispatched, so that a runaway or malicious sequence can't make us
+    // buffer an unbounded amount of data. This comfortably fits an OSC 52
+    // clipboard payload of 12 MB. It can be changed with SetMaxStringLength.
+    constexpr size_t MAX_STRING_LENGTH = 16 * 1024 * 1024;
+
     class StateMachine final
     {
 #ifdef UNIT_TESTING
@@ -43,11 +49,13 @@ namespace Microsoft::Console::VirtualTerminal
         StateMachine(std::unique_ptr<IStateMachineEngine> engine);
 
         void SetAnsiMode(bool ansiMode) noexcept;
+        void SetMaxStringLength(const size_t length) noexcept;
 
         void ProcessCharacter(const wchar_t wch);
         void ProcessString(const std::wstring_view string);
 
         void ResetState() noexcept;
+        bool IsGround() const noexcept;
 
         bool FlushToTerminal();
 
@@ -64,8 +72,10 @@ namespace Microsoft::Console::VirtualTerminal
         void _ActionParam(const wchar_t wch);
         void _ActionCsiDispatch(const wchar_t wch);
         void _ActionOscParam(const wchar_t wch) noexcept;
-        void _ActionOscPut(const wchar_t wch);
+        void _ActionOscStart();
+        void _ActionOscPut(const std::wstring_view string);
         void _ActionOscDispatch(const wchar_t wch);
+        void _DiscardOscString() noexcept;
         void _ActionSs3Dispatch(const wchar_t wch);
         void _ActionDcsDispatch(const wchar_t wch);
 
@@ -100,7 +110,7 @@ namespace Microsoft::Console::VirtualTerminal
         void _EventCsiIntermediate(const wchar_t wch);
         void _EventCsiIgnore(const wchar_t wch);
         void _EventCsiParam(const wchar_t wch);
-        void _EventOscParam(const wchar_t wch) noexcept;
+        void _EventOscParam(const wchar_t wch);
         void _EventOscString(const wchar_t wch);
         void _EventOscTermination(const wchar_t wch);
         void _EventSs3Entry(const wchar_t wch);
@@ -115,6 +125,8 @@ namespace Microsoft::Console::VirtualTerminal
 
         void _AccumulateTo(const wchar_t wch, size_t& value) noexcept;
 
+        size_t _ProcessDataString(const std::wstring_view string);
+
         enum class VTStates
         {
             Ground,
@@ -165,10 +177,15 @@ namespace Microsoft::Console::VirtualTerminal
 
         std::wstring _oscString;
         size_t _oscParameter;
+        size_t _oscStringLength;
+        bool _oscStringDiscarded;
+        IStateMachineEngine::StringHandler _oscStringHandler;
+        size_t _maxStringLength;
 
         IStateMachineEngine::StringHandler _dcsStringHandler;
 
         std::optional<std::wstring> _cachedSequence;
+        bool _cachedSequenceDiscarded;
 
         // This is tracked per state machine instance so that separate calls to Process*
         //   can start and finish a sequence.
@@ -98,4 +98,57 @@ class Microsoft::Console::VirtualTerminal::Base64Test
         VERIFY_ARE_EQUAL(true, success);
         VERIFY_ARE_EQUAL(L"👍👍🏻👍🏼👍🏽👍🏾👍🏿", result);
     }
+
+    TEST_METHOD(TestBase64DecodeInPieces)
+    {
+        Base64::Decoder decoder;
+        std::wstring result;
+
+        // Pieces may be split in the middle of a quantum.
+        VERIFY_IS_TRUE(decoder.Feed(L"Zm"));
+        VERIFY_IS_TRUE(decoder.Feed(L"9vYm"));
+        VERIFY_ARE_EQUAL(4u, decoder.DecodedSize());
+        VERIFY_IS_TRUE(decoder.Feed(L"Fy"));
+        VERIFY_IS_TRUE(decoder.Finish(result));
+        VERIFY_ARE_EQUAL(L"foobar", result);
+
+        // Finishing resets the decoder for the next string.
+        VERIFY_ARE_EQUAL(0u, decoder.DecodedSize());
+
+        // Pieces may be split between the padding characters.
+        result = L"";
+        VERIFY_IS_TRUE(decoder.Feed(L"Zm9vYg="));
+        VERIFY_IS_TRUE(decoder.Feed(L"\r\n="));
+        VERIFY_IS_TRUE(decoder.Feed(L"\n"));
+        VERIFY_IS_TRUE(decoder.Finish(result));
+        VERIFY_ARE_EQUAL(L"foob", result);
+
+        // A multibyte character may be split across pieces.
+        // U+306b U+307b
+        result = L"";
+        for (const auto ch : std::wstring_view{ L"44Gr44G7" })
+        {
+            VERIFY_IS_TRUE(decoder.Feed({ &ch, 1 }));
+        }
+        VERIFY_IS_TRUE(decoder.Finish(result));
+        VERIFY_ARE_EQUAL(L"にほ", result);
+
+        // Invalid strings are detected as soon as possible.
+        VERIFY_IS_TRUE(decoder.Feed(L"Zm9v"));
+        VERIFY_IS_FALSE(decoder.Feed(L"Y?"));
+        VERIFY_ARE_EQUAL(0u, decoder.DecodedSize());
+        VERIFY_IS_FALSE(decoder.Feed(L"mFy"));
+        VERIFY_IS_FALSE(decoder.Finish(result));
+
+        // Incomplete strings fail when finished.
+        VERIFY_IS_TRUE(decoder.Feed(L"Zm9vYg"));
+        VERIFY_IS_FALSE(decoder.Finish(result));
+        VERIFY_IS_TRUE(decoder.Feed(L"Zm9vYg="));
+        VERIFY_IS_FALSE(decoder.Finish(result));
+
+        // Nothing but whitespace may follow the padding.
+        VERIFY_IS_TRUE(decoder.Feed(L"Zm9vYmE="));
+        VERIFY_IS_FALSE(decoder.Feed(L"Zm9v"));
+        VERIFY_IS_FALSE(decoder.Finish(result));
+    }
 };
@@ -3289,6 +3289,49 @@ class StateMachineExternalTest final
         pDispatch->ClearState();
     }
 
+    TEST_METHOD(TestSetClipboardSplitAcrossWrites)
+    {
+        auto dispatch = std::make_unique<StatefulDispatch>();
+        auto pDispatch = dispatch.get();
+        auto engine = std::make_unique<OutputStateMachineEngine>(std::move(dispatch));
+        StateMachine mach(std::move(engine));
+
+        // The payload is decoded as it arrives, so it can be split anywhere,
+        // including in the middle of a quantum or the padding.
+        mach.ProcessString(L"\x1b]52;");
+        mach.ProcessString(L"s0;Zm9");
+        mach.ProcessString(L"vDQpiYX");
+        mach.ProcessString(L"I=\x1b");
+        mach.ProcessString(L"\\");
+        VERIFY_ARE_EQUAL(L"foo\r\nbar", pDispatch->_copyContent);
+
+        pDispatch->ClearState();
+
+        pDispatch->_copyContent = L"UNCHANGED";
+        // A query split across writes won't change the content.
+        mach.ProcessString(L"\x1b]52;;");
+        mach.ProcessString(L"?\x07");
+        VERIFY_ARE_EQUAL(L"UNCHANGED", pDispatch->_copyContent);
+
+        pDispatch->ClearState();
+
+        mach.SetMaxStringLength(8);
+
+        // Payloads up to the maximum string length work.
+        mach.ProcessString(L"\x1b]52;;Zm9v\x07");
+        VERIFY_ARE_EQUAL(L"foo", pDispatch->_copyContent);
+
+        pDispatch->ClearState();
+
+        pDispatch->_copyContent = L"UNCHANGED";
+        // Longer payloads are discarded, won't change the content.
+        mach.ProcessString(L"\x1b]52;;Zm9v");
+        mach.ProcessString(L"YmFy\x07");
+        VERIFY_ARE_EQUAL(L"UNCHANGED", pDispatch->_copyContent);
+
+        pDispatch->ClearState();
+    }
+
     TEST_METHOD(TestAddHyperlink)
     {
         auto dispatch = std::make_unique<StatefulDispatch>();
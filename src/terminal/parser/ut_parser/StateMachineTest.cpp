@@ -38,6 +38,10 @@ public:
         dcsId = 0;
         dcsParams.clear();
         dcsDataString.clear();
+        dcsDataChunks = 0;
+        oscString.clear();
+        oscDataString.clear();
+        oscStringTerminated = false;
     }
 
     bool ActionExecute(const wchar_t wch) override
@@ -68,10 +72,30 @@ public:
 
     bool ActionIgnore() override { return true; };
 
+    IStateMachineEngine::StringHandler ActionOscStart(const size_t /* parameter */) override
+    {
+        if (!streamOscStrings)
+        {
+            return nullptr;
+        }
+        return [=](const auto chunk) {
+            if (chunk == L"\033")
+            {
+                oscStringTerminated = true;
+            }
+            else
+            {
+                oscDataString += chunk;
+            }
+            return true;
+        };
+    }
+
     bool ActionOscDispatch(const wchar_t /* wch */,
                            const size_t /* parameter */,
-                           const std::wstring_view /* string */) override
+                           const std::wstring_view string) override
     {
+        oscString = string;
         if (pfnFlushToTerminal)
         {
             pfnFlushToTerminal();
@@ -115,7 +139,12 @@ public:
             dcsParams.push_back(parameters.at(i).value_or(0));
         }
         dcsDataString.clear();
-        return [=](const auto ch) { dcsDataString += ch; return true; };
+        dcsDataChunks = 0;
+        return [=](const auto chunk) {
+            dcsDataString += chunk;
+            dcsDataChunks++;
+            return true;
+        };
     }
 
     // These will only be populated if ActionCsiDispatch is called.
@@ -138,6 +167,15 @@ public:
     uint64_t dcsId = 0;
     std::vector<size_t> dcsParams;
     std::wstring dcsDataString;
+    size_t dcsDataChunks = 0;
+
+    // This will only be populated if ActionOscDispatch is called.
+    std::wstring oscString;
+
+    // If set, OSC strings are passed to a handler returned by ActionOscStart.
+    bool streamOscStrings = false;
+    std::wstring oscDataString;
+    bool oscStringTerminated = false;
 };
 
 class Microsoft::Console::VirtualTerminal::StateMachineTest
@@ -162,6 +200,13 @@ class Microsoft::Console::VirtualTerminal::StateMachineTest
     TEST_METHOD(PassThroughUnhandledSplitAcrossWrites);
 
     TEST_METHOD(DcsDataStringsReceivedByHandler);
+    TEST_METHOD(DcsDataStringsReceivedInChunks);
+    TEST_METHOD(OscStringsCollectedInChunks);
+    TEST_METHOD(OscStringsLimitedInLength);
+
+    BEGIN_TEST_METHOD(Osc52Benchmark)
+        TEST_METHOD_PROPERTY(L"IsPerfTest", L"true")
+    END_TEST_METHOD()
 };
 
 void StateMachineTest::TwoStateMachinesDoNotInterfereWithEachother()
@@ -342,3 +387,149 @@ void StateMachineTest::DcsDataStringsReceivedByHandler()
     // Verify the control characters were executed (if expected).
     VERIFY_ARE_EQUAL(expectedExecuted, engine.executed);
 }
+
+void StateMachineTest::DcsDataStringsReceivedInChunks()
+{
+    auto enginePtr{ std::make_unique<TestStateMachineEngine>() };
+    // this dance is required because StateMachine presumes to take ownership of its engine.
+    auto& engine{ *enginePtr.get() };
+    StateMachine machine{ std::move(enginePtr) };
+
+    Log::Comment(L"Contiguous data is delivered in a single chunk, followed by the ESC terminator");
+    machine.ProcessString(L"\033P1|data string\033\\");
+    VERIFY_ARE_EQUAL(L"data string\033", engine.dcsDataString);
+    VERIFY_ARE_EQUAL(2u, engine.dcsDataChunks);
+
+    Log::Comment(L"Ignored characters split the data into separate chunks");
+    machine.ProcessString(L"\033P1|ab\x7f\u00e9cd\033\\");
+    VERIFY_ARE_EQUAL(L"abcd\033", engine.dcsDataString);
+    VERIFY_ARE_EQUAL(3u, engine.dcsDataChunks);
+
+    Log::Comment(L"Data split across writes is delivered as it arrives");
+    machine.ProcessString(L"\033P1|data ");
+    machine.ProcessString(L"string");
+    machine.ProcessString(L"\033\\printed text");
+    VERIFY_ARE_EQUAL(L"data string\033", engine.dcsDataString);
+    VERIFY_ARE_EQUAL(3u, engine.dcsDataChunks);
+    VERIFY_ARE_EQUAL(L"printed text", engine.printed);
+}
+
+void StateMachineTest::OscStringsCollectedInChunks()
+{
+    auto enginePtr{ std::make_unique<TestStateMachineEngine>() };
+    // this dance is required because StateMachine presumes to take ownership of its engine.
+    auto& engine{ *enginePtr.get() };
+    StateMachine machine{ std::move(enginePtr) };
+
+    Log::Comment(L"Invalid characters are dropped from the string");
+    machine.ProcessString(L"\033]2;title\x01 with\x1f control\x19 chars\a");
+    VERIFY_ARE_EQUAL(L"title with control chars", engine.oscString);
+
+    Log::Comment(L"Strings split across writes are collected until they're terminated");
+    engine.ResetTestState();
+    machine.ProcessString(L"\033]2;split ");
+    machine.ProcessString(L"title\033");
+    machine.ProcessString(L"\\printed text");
+    VERIFY_ARE_EQUAL(L"split title", engine.oscString);
+    VERIFY_ARE_EQUAL(L"printed text", engine.printed);
+
+    Log::Comment(L"CAN aborts the string");
+    engine.ResetTestState();
+    machine.ProcessString(L"\033]2;aborted\030printed text\a");
+    VERIFY_ARE_EQUAL(L"", engine.oscString);
+    VERIFY_ARE_EQUAL(L"printed text", engine.printed);
+}
+
+void StateMachineTest::OscStringsLimitedInLength()
+{
+    auto enginePtr{ std::make_unique<TestStateMachineEngine>() };
+    // this dance is required because StateMachine presumes to take ownership of its engine.
+    auto& engine{ *enginePtr.get() };
+    StateMachine machine{ std::move(enginePtr) };
+    machine.SetMaxStringLength(10);
+
+    Log::Comment(L"Strings up to the maximum length are dispatched");
+    machine.ProcessString(L"\033]2;0123456789\a");
+    VERIFY_ARE_EQUAL(L"0123456789", engine.oscString);
+
+    Log::Comment(L"Longer strings are discarded, even when split across writes");
+    engine.ResetTestState();
+    machine.ProcessString(L"\033]2;01234");
+    machine.ProcessString(L"56789A\033\\printed text");
+    VERIFY_ARE_EQUAL(L"", engine.oscString);
+    VERIFY_ARE_EQUAL(L"printed text", engine.printed);
+
+    Log::Comment(L"Streamed strings are passed to the handler as they arrive");
+    engine.ResetTestState();
+    engine.streamOscStrings = true;
+    machine.ProcessString(L"\033]52;c;Zm9v");
+    VERIFY_ARE_EQUAL(L"c;Zm9v", engine.oscDataString);
+    VERIFY_IS_FALSE(engine.oscStringTerminated);
+    machine.ProcessString(L"Yg==\a");
+    VERIFY_ARE_EQUAL(L"c;Zm9vYg==", engine.oscDataString);
+    VERIFY_IS_TRUE(engine.oscStringTerminated);
+
+    Log::Comment(L"Streamed strings are abandoned once they exceed the maximum length");
+    engine.ResetTestState();
+    machine.ProcessString(L"\033]52;c;Zm9v");
+    machine.ProcessString(L"YmFyYmFy\a");
+    VERIFY_ARE_EQUAL(L"c;Zm9v", engine.oscDataString);
+    VERIFY_IS_FALSE(engine.oscStringTerminated);
+
+    Log::Comment(L"Streamed strings are abandoned when aborted with CAN");
+    engine.ResetTestState();
+    machine.ProcessString(L"\033]52;c;Zm9v\030\033]52;c;\a");
+    VERIFY_ARE_EQUAL(L"c;Zm9vc;", engine.oscDataString);
+    VERIFY_IS_TRUE(engine.oscStringTerminated);
+    engine.streamOscStrings = false;
+
+    Log::Comment(L"Sequences longer than the maximum length can't be passed through");
+    engine.ResetTestState();
+    engine.pfnFlushToTerminal = std::bind(&StateMachine::FlushToTerminal, &machine);
+    machine.ProcessString(L"\x1b[1;2;3;4;5;");
+    machine.ProcessString(L"6m");
+    VERIFY_ARE_EQUAL(L"", engine.passedThrough);
+    machine.ProcessString(L"\x1b[1;2;");
+    machine.ProcessString(L"3m");
+    VERIFY_ARE_EQUAL(L"\x1b[1;2;3m", engine.passedThrough);
+}
+
+void StateMachineTest::Osc52Benchmark()
+{
+    // Copy a 10 MB base64 payload to the clipboard, which is
+    // the largest kind of string applications commonly send.
+    constexpr size_t payloadSize = 10 * 1024 * 1024;
+    constexpr std::wstring_view alphabet{ L"ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/" };
+
+    std::wstring sequence{ L"\033]52;c;" };
+    sequence.reserve(sequence.size() + payloadSize + 1);
+    for (size_t i = 0; i < payloadSize; ++i)
+    {
+        sequence.push_back(til::at(alphabet, i % alphabet.size()));
+    }
+    sequence.push_back(L'\a');
+
+    auto enginePtr{ std::make_unique<TestStateMachineEngine>() };
+    // this dance is required because StateMachine presumes to take ownership of its engine.
+    auto& engine{ *enginePtr.get() };
+    StateMachine machine{ std::move(enginePtr) };
+
+    // Deliver it in 4K writes, like it would arrive from a pipe.
+    constexpr size_t writeSize = 4096;
+    const std::wstring_view remaining{ sequence };
+    const auto start = std::chrono::steady_clock::now();
+
+    for (size_t offset = 0; offset < remaining.size(); offset += writeSize)
+    {
+        machine.ProcessString(remaining.substr(offset, writeSize));
+    }
+
+    const auto delta = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    Log::Comment(NoThrowString().Format(L"Parsed %zu characters of OSC 52 in %lld ms (%.2f Mchars/s)",
+                                        sequence.size(),
+                                        delta,
+                                        delta ? static_cast<double>(sequence.size()) / 1000.0 / delta : 0.0));
+
+    VERIFY_ARE_EQUAL(payloadSize + 2, engine.oscString.size());
+    VERIFY_ARE_EQUAL(L"c;", engine.oscString.substr(0, 2));
+}
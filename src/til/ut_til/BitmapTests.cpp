@@ -1103,4 +1103,176 @@ class BitmapTests
         }
         VERIFY_ARE_EQUAL(expected, actual);
     }
+
+    TEST_METHOD(RunsUpdatedInPlace)
+    {
+        til::bitmap map{ til::size{ 8, 4 } };
+
+        // Compares the runs maintained by the bitmap with ones calculated from scratch.
+        const auto verifyRuns = [&]() {
+            VERIFY_IS_TRUE(map._runs.has_value());
+            const std::vector<til::rectangle> expected{ map.begin(), map.end() };
+            const auto actual = map.runs();
+            VERIFY_ARE_EQUAL(expected.size(), actual.size());
+            for (size_t i = 0; i < expected.size(); ++i)
+            {
+                VERIFY_ARE_EQUAL(expected.at(i), actual[i]);
+            }
+        };
+
+        Log::Comment(L"Calculate the runs once, to have them cached.");
+        VERIFY_ARE_EQUAL(0u, map.runs().size());
+
+        Log::Comment(L"Set a rectangle.");
+        map.set(til::rectangle{ til::point{ 1, 1 }, til::size{ 3, 2 } });
+        verifyRuns();
+
+        Log::Comment(L"Set a rectangle touching an existing run.");
+        map.set(til::rectangle{ til::point{ 4, 1 }, til::size{ 2, 1 } });
+        verifyRuns();
+
+        Log::Comment(L"Set a point touching an existing run.");
+        map.set(til::point{ 0, 2 });
+        verifyRuns();
+
+        Log::Comment(L"Set a point between two runs.");
+        map.set(til::point{ 7, 1 });
+        map.set(til::point{ 6, 1 });
+        verifyRuns();
+
+        Log::Comment(L"Translate without fill.");
+        map.translate(til::point{ 2, 1 });
+        verifyRuns();
+
+        Log::Comment(L"Translate with fill.");
+        map.translate(til::point{ -3, -1 }, true);
+        verifyRuns();
+
+        Log::Comment(L"Reset all.");
+        map.reset_all();
+        verifyRuns();
+
+        Log::Comment(L"Set all.");
+        map.set_all();
+        verifyRuns();
+    }
+
+    TEST_METHOD(FilledRunsAfterSetAndTranslate)
+    {
+        // Compares the runs reported by the bitmap with ones calculated from scratch.
+        const auto verifyRuns = [](const til::bitmap& map) {
+            const std::vector<til::rectangle> expected{ map.begin(), map.end() };
+            const auto actual = map.runs();
+            VERIFY_ARE_EQUAL(expected.size(), actual.size());
+            for (size_t i = 0; i < expected.size(); ++i)
+            {
+                VERIFY_ARE_EQUAL(expected.at(i), actual[i]);
+            }
+        };
+
+        Log::Comment(L"A filled bitmap has no runs cached until they're asked for.");
+        til::bitmap map{ til::size{ 8, 4 }, true };
+        VERIFY_IS_FALSE(map._runs.has_value());
+
+        Log::Comment(L"Set a point in the filled area.");
+        map.set(til::point{ 2, 1 });
+        verifyRuns(map);
+        VERIFY_ARE_EQUAL(size_t{ 4 }, map.runs().size());
+
+        Log::Comment(L"Translate a filled bitmap without fill.");
+        til::bitmap translated{ til::size{ 8, 4 }, true };
+        translated.translate(til::point{ 2, 1 });
+        verifyRuns(translated);
+        VERIFY_ARE_EQUAL(size_t{ 3 }, translated.runs().size());
+
+        Log::Comment(L"Translate a filled bitmap after its runs were calculated.");
+        til::bitmap cached{ til::size{ 8, 4 }, true };
+        VERIFY_ARE_EQUAL(size_t{ 4 }, cached.runs().size());
+        cached.translate(til::point{ -3, -1 });
+        verifyRuns(cached);
+    }
+
+    TEST_METHOD(SetMultipleRectangles)
+    {
+        til::bitmap map{ til::size{ 10, 4 } };
+
+        const std::vector<til::rectangle> rects{
+            til::rectangle{ til::point{ 0, 0 }, til::size{ 3, 2 } },
+            til::rectangle{ til::point{ 5, 1 }, til::size{ 5, 3 } },
+        };
+        map.set(rects.begin(), rects.end());
+        _checkBits(rects, map);
+
+        Log::Comment(L"Rectangles out of bounds throw.");
+        const std::vector<til::rectangle> invalid{ til::rectangle{ til::point{ 8, 0 }, til::size{ 3, 1 } } };
+        VERIFY_THROWS_SPECIFIC(map.set(invalid.begin(), invalid.end()), wil::ResultException, [](wil::ResultException& e) { return e.GetErrorCode() == E_INVALIDARG; });
+    }
+
+    TEST_METHOD(BitwiseOperators)
+    {
+        const til::rectangle a{ til::point{ 0, 0 }, til::size{ 3, 2 } };
+        const til::rectangle b{ til::point{ 2, 1 }, til::size{ 6, 3 } };
+
+        til::bitmap mapA{ til::size{ 10, 4 } };
+        mapA.set(a);
+        til::bitmap mapB{ til::size{ 10, 4 } };
+        mapB.set(b);
+
+        Log::Comment(L"OR yields the bits set in either map.");
+        auto actual = mapA;
+        actual |= mapB;
+        _checkBits(std::vector<til::rectangle>{ a, b }, actual);
+
+        Log::Comment(L"AND yields the bits set in both maps.");
+        actual = mapA;
+        actual &= mapB;
+        _checkBits(a & b, actual);
+
+        Log::Comment(L"Maps of different sizes can't be combined.");
+        til::bitmap other{ til::size{ 4, 4 } };
+        VERIFY_THROWS_SPECIFIC(actual |= other, wil::ResultException, [](wil::ResultException& e) { return e.GetErrorCode() == E_INVALIDARG; });
+        VERIFY_THROWS_SPECIFIC(actual &= other, wil::ResultException, [](wil::ResultException& e) { return e.GetErrorCode() == E_INVALIDARG; });
+    }
+
+    BEGIN_TEST_METHOD(InvalidateAndScrollBenchmark)
+        TEST_METHOD_PROPERTY(L"IsPerfTest", L"true")
+    END_TEST_METHOD()
+    {
+        // Simulates what a renderer does with its invalid map while a program
+        // prints lines to a 120x30 viewport: invalidate the new line and the
+        // cursor, scroll everything up by a line, then paint the runs and reset.
+        // Every 16th frame scrolls horizontally as well, like a panning viewport.
+        constexpr ptrdiff_t width = 120;
+        constexpr ptrdiff_t height = 30;
+        constexpr size_t frames = 200000;
+
+        std::pmr::unsynchronized_pool_resource pool{ til::pmr::get_default_resource() };
+        til::pmr::bitmap map{ til::size{ width, height }, false, &pool };
+
+        ptrdiff_t painted = 0;
+        const auto start = std::chrono::steady_clock::now();
+
+        for (size_t frame = 0; frame < frames; ++frame)
+        {
+            const auto column = static_cast<ptrdiff_t>(frame % width);
+            map.set(til::rectangle{ til::point{ 0, height - 1 }, til::size{ column + 1, 1 } });
+            map.set(til::point{ column, height - 1 });
+            map.translate(til::point{ frame % 16 == 0 ? -1 : 0, -1 }, true);
+            map.set(til::rectangle{ til::point{ 0, static_cast<ptrdiff_t>(frame) % height }, til::size{ width / 2, 1 } });
+
+            for (const auto& run : map.runs())
+            {
+                painted += run.size().area();
+            }
+            map.reset_all();
+        }
+
+        const auto delta = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+        Log::Comment(NoThrowString().Format(L"%zu frames took %lld us (%.3f us per frame), painting %td cells",
+                                            frames,
+                                            delta,
+                                            static_cast<double>(delta) / frames,
+                                            painted));
+        VERIFY_IS_TRUE(painted > 0);
+    }
 };
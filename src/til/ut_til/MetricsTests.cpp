@@ -0,0 +1,106 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+
+#include "til/metrics.h"
+
+using namespace WEX::Common;
+using namespace WEX::Logging;
+using namespace WEX::TestExecution;
+
+class MetricsTests
+{
+    TEST_CLASS(MetricsTests);
+
+    TEST_METHOD(CounterSumsAcrossThreads)
+    {
+        til::metrics::counter counter{ "test.counter.threads" };
+
+        std::vector<std::thread> threads;
+        for (auto i = 0; i < 4; ++i)
+        {
+            threads.emplace_back([&]() {
+                for (auto j = 0; j < 1000; ++j)
+                {
+                    counter.add();
+                }
+                counter.add(1000);
+            });
+        }
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+
+        VERIFY_ARE_EQUAL(8000u, counter.value());
+
+        counter.reset();
+        VERIFY_ARE_EQUAL(0u, counter.value());
+    }
+
+    TEST_METHOD(HistogramBuckets)
+    {
+        til::metrics::histogram histogram{ "test.histogram.buckets" };
+        VERIFY_ARE_EQUAL(0u, histogram.percentile(50));
+
+        // 90 small values and 10 large ones.
+        for (auto i = 0; i < 90; ++i)
+        {
+            histogram.record(3);
+        }
+        for (auto i = 0; i < 10; ++i)
+        {
+            histogram.record(1000);
+        }
+
+        VERIFY_ARE_EQUAL(100u, histogram.count());
+        VERIFY_ARE_EQUAL(90u * 3 + 10u * 1000, histogram.sum());
+        VERIFY_ARE_EQUAL(1000u, histogram.max());
+
+        // Percentiles are reported as the upper bound of their power of two bucket.
+        VERIFY_ARE_EQUAL(3u, histogram.percentile(50));
+        VERIFY_ARE_EQUAL(3u, histogram.percentile(90));
+        VERIFY_ARE_EQUAL(1023u, histogram.percentile(91));
+        VERIFY_ARE_EQUAL(1023u, histogram.percentile(100));
+
+        histogram.record(0);
+        histogram.record(UINT64_MAX);
+        VERIFY_ARE_EQUAL(0u, histogram.percentile(0.5));
+        VERIFY_ARE_EQUAL(UINT64_MAX, histogram.percentile(100));
+    }
+
+    TEST_METHOD(RegistryFindAndDump)
+    {
+        VERIFY_IS_NULL(til::metrics::find("test.registry.counter"));
+
+        {
+            til::metrics::counter counter{ "test.registry.counter" };
+            til::metrics::histogram histogram{ "test.registry.histogram" };
+            counter.add(42);
+            histogram.record(7);
+
+            const auto found = til::metrics::find("test.registry.counter");
+            VERIFY_IS_NOT_NULL(found);
+            VERIFY_IS_TRUE(found->type() == til::metrics::kind::counter);
+            VERIFY_ARE_EQUAL(42u, static_cast<const til::metrics::counter*>(found)->value());
+
+            const auto dump = til::metrics::dump();
+            Log::Comment(String().Format(L"%hs", dump.c_str()));
+
+            const auto counterLine = dump.find("test.registry.counter");
+            const auto histogramLine = dump.find("test.registry.histogram");
+            VERIFY_ARE_NOT_EQUAL(std::string::npos, counterLine);
+            VERIFY_ARE_NOT_EQUAL(std::string::npos, histogramLine);
+            VERIFY_IS_LESS_THAN(counterLine, histogramLine);
+            VERIFY_ARE_NOT_EQUAL(std::string::npos, dump.find("count=1 sum=7 max=7", histogramLine));
+
+            til::metrics::reset();
+            VERIFY_ARE_EQUAL(0u, counter.value());
+            VERIFY_ARE_EQUAL(0u, histogram.count());
+        }
+
+        // Metrics unregister themselves when they're destroyed.
+        VERIFY_IS_NULL(til::metrics::find("test.registry.counter"));
+    }
+};
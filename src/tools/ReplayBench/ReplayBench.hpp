@@ -0,0 +1,35 @@
+/*++
+Copyright (c) Microsoft Corporation
+Licensed under the MIT license.
+
+Module Name:
+- ReplayBench.hpp
+
+Abstract:
+- Shared declarations for the ReplayBench tool, which replays recorded VT
+  byte streams through the output pipeline and reports per-stage throughput.
+- The built-in workloads are generated from a fixed seed, so that two runs
+  (or two machines) always replay exactly the same bytes.
+--*/
+
+#pragma once
+
+namespace ReplayBench
+{
+    struct Recording
+    {
+        std::wstring name;
+        std::string bytes;
+    };
+
+    namespace Workloads
+    {
+        std::string Cat(const size_t targetBytes);
+        std::string BuildLog(const size_t targetBytes);
+        std::string Htop(const size_t targetBytes, const til::size viewport);
+        std::string Vim(const size_t targetBytes, const til::size viewport);
+        std::string EmojiChat(const size_t targetBytes);
+
+        std::vector<Recording> Builtin(const size_t targetBytes, const til::size viewport);
+    }
+}
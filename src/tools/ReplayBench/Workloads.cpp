@@ -0,0 +1,230 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "pch.h"
+#include "ReplayBench.hpp"
+
+#include <random>
+
+using namespace ReplayBench;
+
+namespace
+{
+    constexpr std::string_view words[]{
+        "the", "console", "buffer", "row", "attribute", "cursor", "viewport", "render",
+        "parser", "dispatch", "scroll", "glyph", "font", "pipe", "handle", "input",
+        "output", "terminal", "sequence", "color", "width", "height", "line", "wrap",
+    };
+
+    constexpr std::string_view files[]{
+        "src/buffer/out/textBuffer.cpp",
+        "src/buffer/out/Row.cpp",
+        "src/terminal/parser/stateMachine.cpp",
+        "src/terminal/adapter/adaptDispatch.cpp",
+        "src/renderer/base/renderer.cpp",
+        "src/host/_stream.cpp",
+    };
+
+    // Each of these is a single UTF-8 encoded glyph. Most of them are wide,
+    // some are sequences of several codepoints (skin tones, flags, ZWJ).
+    constexpr std::string_view glyphs[]{
+        "\xF0\x9F\x98\x80", // U+1F600 grinning face
+        "\xF0\x9F\x91\x8D\xF0\x9F\x8F\xBD", // U+1F44D U+1F3FD thumbs up, medium skin tone
+        "\xF0\x9F\x87\xBA\xF0\x9F\x87\xB8", // U+1F1FA U+1F1F8 flag
+        "\xE2\x9C\xA8", // U+2728 sparkles
+        "\xE3\x81\x93\xE3\x82\x93\xE3\x81\xAB\xE3\x81\xA1\xE3\x81\xAF", // Japanese greeting
+        "\xF0\x9F\x91\xA9\xE2\x80\x8D\xF0\x9F\x92\xBB", // U+1F469 ZWJ U+1F4BB technologist
+        "\xC3\xA9t\xC3\xA9", // Latin-1 supplement
+        "\xD0\xBF\xD1\x80\xD0\xB8\xD0\xB2\xD0\xB5\xD1\x82", // Cyrillic greeting
+    };
+
+    template<typename T, size_t N>
+    constexpr const T& _Pick(std::mt19937& rng, const T (&values)[N]) noexcept
+    {
+        return values[rng() % N];
+    }
+
+    // Routine Description:
+    // - Calls generator until the recording has grown to at least targetBytes.
+    // Arguments:
+    // - targetBytes - the minimum size of the recording
+    // - generator - appends one "unit" (a line, a frame, ...) to the given string
+    // Return Value:
+    // - the generated recording
+    template<typename T>
+    std::string _Fill(const size_t targetBytes, T&& generator)
+    {
+        std::string bytes;
+        bytes.reserve(targetBytes + 64 * 1024);
+        for (size_t i = 0; bytes.size() < targetBytes; ++i)
+        {
+            generator(bytes, i);
+        }
+        return bytes;
+    }
+
+    void _AppendWords(std::string& out, std::mt19937& rng, const size_t columns)
+    {
+        for (size_t column = 0; column < columns;)
+        {
+            const auto word = _Pick(rng, words);
+            out.append(word);
+            out.push_back(' ');
+            column += word.size() + 1;
+        }
+    }
+}
+
+// Routine Description:
+// - `cat` of a large plain text file: long runs of printable ASCII, CRLF terminated.
+std::string Workloads::Cat(const size_t targetBytes)
+{
+    std::mt19937 rng{ 1 };
+    return _Fill(targetBytes, [&](std::string& out, size_t) {
+        _AppendWords(out, rng, 20 + rng() % 100);
+        out.append("\r\n");
+    });
+}
+
+// Routine Description:
+// - A colorized compiler log: short colored spans, progress lines that get
+//   rewritten in place with CR + EL, and the occasional bold error.
+std::string Workloads::BuildLog(const size_t targetBytes)
+{
+    std::mt19937 rng{ 2 };
+    return _Fill(targetBytes, [&](std::string& out, size_t i) {
+        const auto file = _Pick(rng, files);
+        switch (rng() % 8)
+        {
+        case 0:
+            fmt::format_to(std::back_inserter(out), "\x1b[33m{}({},{}): warning C4100\x1b[m: ", file, rng() % 2000, rng() % 80);
+            _AppendWords(out, rng, 40);
+            out.append("\r\n");
+            break;
+        case 1:
+            fmt::format_to(std::back_inserter(out), "\x1b[1;31m{}({}): error C2065\x1b[0m: '", file, rng() % 2000);
+            _AppendWords(out, rng, 10);
+            out.append("': undeclared identifier\r\n");
+            break;
+        case 2:
+            for (auto percent = 0; percent <= 100; percent += 10)
+            {
+                fmt::format_to(std::back_inserter(out), "\r\x1b[K\x1b[32m[{:3}%]\x1b[m Linking {}", percent, file);
+            }
+            out.append("\r\n");
+            break;
+        default:
+            fmt::format_to(std::back_inserter(out), "  \x1b[36m[{}/9999]\x1b[m Compiling {}\r\n", i % 10000, file);
+            break;
+        }
+    });
+}
+
+// Routine Description:
+// - A full screen process monitor: every frame repositions the cursor for each
+//   line and paints meters in 256 and true colors, erasing to end of line.
+std::string Workloads::Htop(const size_t targetBytes, const til::size viewport)
+{
+    std::mt19937 rng{ 3 };
+    const auto width = gsl::narrow_cast<size_t>(viewport.width());
+    const auto height = gsl::narrow_cast<size_t>(viewport.height());
+    const auto meterWidth = std::max<size_t>(width / 2, 1);
+    return _Fill(targetBytes, [&](std::string& out, size_t) {
+        out.append("\x1b[?25l\x1b[H");
+        for (size_t row = 1; row <= height; ++row)
+        {
+            fmt::format_to(std::back_inserter(out), "\x1b[{};1H", row);
+            if (row <= height / 4)
+            {
+                const auto filled = rng() % meterWidth;
+                fmt::format_to(std::back_inserter(out), "\x1b[1m{:3}\x1b[m[\x1b[38;5;{}m", row, 40 + rng() % 200);
+                out.append(filled, '|');
+                fmt::format_to(std::back_inserter(out), "\x1b[38;2;{};{};{}m{:5.1f}%\x1b[m]", rng() % 256, rng() % 256, rng() % 256, filled * 100.0 / meterWidth);
+            }
+            else
+            {
+                fmt::format_to(std::back_inserter(out), "\x1b[{}m{:7} root      20   0 {:8} {:6} S {:4.1f} ", row % 2 ? 0 : 7, rng() % 100000, rng() % 10000000, rng() % 100000, (rng() % 1000) / 10.0);
+                _AppendWords(out, rng, width / 4);
+                out.append("\x1b[m");
+            }
+            out.append("\x1b[K");
+        }
+        out.append("\x1b[?25h");
+    });
+}
+
+// Routine Description:
+// - Scrolling through a source file in an editor: a scroll region excluding
+//   the status line, SU to move the contents, and one syntax highlighted
+//   line painted at the bottom of the region per step.
+std::string Workloads::Vim(const size_t targetBytes, const til::size viewport)
+{
+    std::mt19937 rng{ 4 };
+    const auto height = gsl::narrow_cast<size_t>(viewport.height());
+    return _Fill(targetBytes, [&](std::string& out, size_t i) {
+        if (i % 500 == 0)
+        {
+            fmt::format_to(std::back_inserter(out), "\x1b[?1049h\x1b[2J\x1b[1;{}r", height - 1);
+        }
+        fmt::format_to(std::back_inserter(out), "\x1b[S\x1b[{};1H\x1b[33m{:5} \x1b[m", height - 1, i);
+        switch (rng() % 4)
+        {
+        case 0:
+            out.append("\x1b[34mreturn\x1b[m ");
+            _AppendWords(out, rng, 30);
+            out.append(";");
+            break;
+        case 1:
+            out.append("    \x1b[32m// ");
+            _AppendWords(out, rng, 50);
+            out.append("\x1b[m");
+            break;
+        case 2:
+            out.append("    \x1b[35mconst auto\x1b[m value = \x1b[31m\"");
+            _AppendWords(out, rng, 20);
+            out.append("\"\x1b[m;");
+            break;
+        default:
+            break;
+        }
+        out.append("\x1b[K");
+        fmt::format_to(std::back_inserter(out), "\x1b[{};1H\x1b[7m {} [+] {}%\x1b[K\x1b[27m", height, _Pick(rng, files), i % 100);
+    });
+}
+
+// Routine Description:
+// - A chat log heavy in non-ASCII text: wide glyphs, multi-codepoint emoji
+//   and other scripts, which all miss the ASCII fast paths.
+std::string Workloads::EmojiChat(const size_t targetBytes)
+{
+    std::mt19937 rng{ 5 };
+    return _Fill(targetBytes, [&](std::string& out, size_t i) {
+        fmt::format_to(std::back_inserter(out), "\x1b[90m[{:02}:{:02}]\x1b[m \x1b[1;3{}m{}\x1b[m: ", (i / 60) % 24, i % 60, 1 + rng() % 6, _Pick(rng, words));
+        for (auto count = 4 + rng() % 12; count > 0; --count)
+        {
+            out.append(_Pick(rng, glyphs));
+            out.push_back(' ');
+            out.append(_Pick(rng, words));
+            out.push_back(' ');
+        }
+        out.append("\r\n");
+    });
+}
+
+// Routine Description:
+// - Generates all built-in workloads.
+// Arguments:
+// - targetBytes - the approximate size of each recording
+// - viewport - the terminal size the recordings are generated for
+// Return Value:
+// - the built-in recordings
+std::vector<Recording> Workloads::Builtin(const size_t targetBytes, const til::size viewport)
+{
+    std::vector<Recording> recordings;
+    recordings.push_back({ L"cat", Cat(targetBytes) });
+    recordings.push_back({ L"buildlog", BuildLog(targetBytes) });
+    recordings.push_back({ L"htop", Htop(targetBytes, viewport) });
+    recordings.push_back({ L"vim", Vim(targetBytes, viewport) });
+    recordings.push_back({ L"emoji", EmojiChat(targetBytes) });
+    return recordings;
+}
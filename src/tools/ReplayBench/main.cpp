@@ -0,0 +1,460 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+// TEST TOOL ReplayBench
+// Replays recorded VT byte streams through the Terminal's output pipeline
+// (UTF-8 decoding, StateMachine + OutputStateMachineEngine, TerminalDispatch,
+// TextBuffer and optionally the VT render engine) without any UI, and reports
+// the throughput and heap allocations of every stage.
+// See README.md for the command line and how to record new streams.
+
+#include "pch.h"
+#include "ReplayBench.hpp"
+
+#include "../../cascadia/TerminalCore/Terminal.hpp"
+#include "../../renderer/base/renderer.hpp"
+#include "../../renderer/inc/DummyRenderTarget.hpp"
+#include "../../renderer/vt/Xterm256Engine.hpp"
+#include "../../terminal/adapter/termDispatch.hpp"
+#include "../../terminal/parser/OutputStateMachineEngine.hpp"
+#include "../../types/inc/viewport.hpp"
+
+#include <til/metrics.h>
+
+using namespace ReplayBench;
+using namespace Microsoft::Console::Render;
+using namespace Microsoft::Console::Types;
+using namespace Microsoft::Console::VirtualTerminal;
+using namespace Microsoft::Terminal::Core;
+
+#pragma region Allocation counting
+
+// Every heap allocation made by the process goes through these, which lets
+// each stage report how many allocations it made. They're only ever read as
+// a difference between two snapshots, so relaxed ordering is good enough.
+static std::atomic<size_t> g_allocations{ 0 };
+static std::atomic<size_t> g_allocatedBytes{ 0 };
+
+void* __cdecl operator new(size_t size)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    g_allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    if (const auto p = std::malloc(size ? size : 1))
+    {
+        return p;
+    }
+    throw std::bad_alloc{};
+}
+
+void __cdecl operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void __cdecl operator delete(void* p, size_t) noexcept
+{
+    std::free(p);
+}
+
+#pragma endregion
+
+namespace
+{
+    struct Options
+    {
+        size_t iterations = 5;
+        size_t chunkSize = 4096;
+        size_t builtinBytes = 8 * 1024 * 1024;
+        til::size viewport{ 120, 30 };
+        SHORT scrollback = 9001;
+        bool render = false;
+        bool passthrough = false;
+        bool metrics = false;
+        std::vector<std::filesystem::path> inputs;
+        std::filesystem::path saveBuiltinTo;
+    };
+
+    struct StageResult
+    {
+        std::chrono::nanoseconds duration = std::chrono::nanoseconds::max();
+        size_t allocations = 0;
+        size_t allocatedBytes = 0;
+    };
+
+    // Accumulates the time and allocations spent between Start() and Stop().
+    // A stage may be started and stopped several times per iteration, for
+    // instance to exclude the cost of writing from the cost of painting.
+    class StageTimer
+    {
+    public:
+        void Start() noexcept
+        {
+            _allocations = g_allocations.load(std::memory_order_relaxed);
+            _allocatedBytes = g_allocatedBytes.load(std::memory_order_relaxed);
+            _start = std::chrono::steady_clock::now();
+        }
+
+        void Stop() noexcept
+        {
+            _result.duration += std::chrono::steady_clock::now() - _start;
+            _result.allocations += g_allocations.load(std::memory_order_relaxed) - _allocations;
+            _result.allocatedBytes += g_allocatedBytes.load(std::memory_order_relaxed) - _allocatedBytes;
+        }
+
+        StageResult Result() const noexcept
+        {
+            return _result;
+        }
+
+    private:
+        std::chrono::steady_clock::time_point _start;
+        size_t _allocations = 0;
+        size_t _allocatedBytes = 0;
+        StageResult _result{ std::chrono::nanoseconds::zero() };
+    };
+
+    // Used to time the parser on its own. Every callback is a no-op,
+    // so the only work left is the state machine itself.
+    class NullDispatch final : public TermDispatch
+    {
+    public:
+        void Execute(const wchar_t /*wchControl*/) override {}
+        void Print(const wchar_t /*wchPrintable*/) override {}
+        void PrintString(const std::wstring_view /*string*/) override {}
+    };
+
+    // Routine Description:
+    // - Runs a stage the configured number of times and keeps the fastest run.
+    //   Allocations are deterministic, so they're taken from that same run.
+    template<typename T>
+    StageResult _Measure(const Options& options, T&& stage)
+    {
+        StageResult best;
+        for (size_t i = 0; i < options.iterations; ++i)
+        {
+            StageTimer timer;
+            stage(timer);
+            const auto result = timer.Result();
+            if (result.duration < best.duration)
+            {
+                best = result;
+            }
+        }
+        return best;
+    }
+
+    // Routine Description:
+    // - Splits a recording into chunks of the given size, the way a connection
+    //   would hand them to the terminal, and decodes each chunk to UTF-16.
+    //   UTF-8 sequences split across chunks are carried over, like in ConptyConnection.
+    std::vector<std::wstring> _DecodeChunks(const std::string_view bytes, const size_t chunkSize)
+    {
+        std::vector<std::wstring> chunks;
+        til::u8state state;
+        for (size_t offset = 0; offset < bytes.size(); offset += chunkSize)
+        {
+            auto& chunk = chunks.emplace_back();
+            THROW_IF_FAILED(til::u8u16(bytes.substr(offset, chunkSize), chunk, state));
+        }
+        return chunks;
+    }
+
+    StageResult _MeasureDecode(const Options& options, const std::string_view bytes)
+    {
+        return _Measure(options, [&](StageTimer& timer) {
+            til::u8state state;
+            std::wstring chunk;
+            timer.Start();
+            for (size_t offset = 0; offset < bytes.size(); offset += options.chunkSize)
+            {
+                THROW_IF_FAILED(til::u8u16(bytes.substr(offset, options.chunkSize), chunk, state));
+            }
+            timer.Stop();
+        });
+    }
+
+    StageResult _MeasureParse(const Options& options, const std::vector<std::wstring>& chunks)
+    {
+        return _Measure(options, [&](StageTimer& timer) {
+            StateMachine machine{ std::make_unique<OutputStateMachineEngine>(std::make_unique<NullDispatch>()) };
+            timer.Start();
+            for (const auto& chunk : chunks)
+            {
+                machine.ProcessString(chunk);
+            }
+            timer.Stop();
+        });
+    }
+
+    // Routine Description:
+    // - Parses, dispatches and writes into the text buffer, exactly like
+    //   ControlCore does for connection output, but without painting.
+    //   Terminal::Write takes the write lock itself, so its cost is included.
+    StageResult _MeasureTerminal(const Options& options, const std::vector<std::wstring>& chunks)
+    {
+        return _Measure(options, [&](StageTimer& timer) {
+            DummyRenderTarget renderTarget;
+            Terminal terminal;
+            terminal.Create(options.viewport, options.scrollback, renderTarget);
+            timer.Start();
+            for (const auto& chunk : chunks)
+            {
+                terminal.Write(chunk);
+            }
+            timer.Stop();
+        });
+    }
+
+    // Routine Description:
+    // - Paints a frame after every chunk through the VT render engine, which
+    //   serializes the buffer back into VT and writes it to the NUL device.
+    //   Only the painting is timed; the writes are covered by the terminal stage.
+    StageResult _MeasureRender(const Options& options, const std::vector<std::wstring>& chunks)
+    {
+        return _Measure(options, [&](StageTimer& timer) {
+            wil::unique_hfile nul{ CreateFileW(L"NUL", GENERIC_WRITE, 0, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr) };
+            THROW_LAST_ERROR_IF(!nul);
+
+            Terminal terminal;
+            Xterm256Engine engine{ std::move(nul), Viewport::FromDimensions(options.viewport) };
+            IRenderEngine* engines[]{ &engine };
+            Renderer renderer{ &terminal, engines, ARRAYSIZE(engines), nullptr };
+            terminal.Create(options.viewport, options.scrollback, renderer);
+
+            for (const auto& chunk : chunks)
+            {
+                terminal.Write(chunk);
+                timer.Start();
+                LOG_IF_FAILED(renderer.PaintFrame());
+                timer.Stop();
+            }
+        });
+    }
+
+    // Routine Description:
+    // - Forwards every chunk to the terminal as is, the way conpty does in
+    //   passthrough mode, instead of painting frames. Unlike the render stage
+    //   this times the writes too, since in passthrough mode they're the only
+    //   work left: a terminal + render run is the cost to compare against.
+    StageResult _MeasurePassthrough(const Options& options, const std::vector<std::wstring>& chunks)
+    {
+        return _Measure(options, [&](StageTimer& timer) {
+            wil::unique_hfile nul{ CreateFileW(L"NUL", GENERIC_WRITE, 0, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr) };
+            THROW_LAST_ERROR_IF(!nul);
+
+            DummyRenderTarget renderTarget;
+            Terminal terminal;
+            terminal.Create(options.viewport, options.scrollback, renderTarget);
+            Xterm256Engine engine{ std::move(nul), Viewport::FromDimensions(options.viewport) };
+
+            timer.Start();
+            for (const auto& chunk : chunks)
+            {
+                LOG_IF_FAILED(engine.BeginPassthrough(chunk));
+                terminal.Write(chunk);
+                const auto cursor = terminal.GetViewport().ConvertToOrigin(terminal.GetCursorPosition());
+                LOG_IF_FAILED(engine.EndPassthrough(cursor, terminal.IsCursorVisible(), terminal.GetTextBuffer().GetCurrentAttributes()));
+            }
+            timer.Stop();
+        });
+    }
+
+    void _PrintStage(const wchar_t* const name, const StageResult& result, const size_t bytes)
+    {
+        const auto seconds = std::chrono::duration<double>(result.duration).count();
+        const auto megabytesPerSecond = seconds > 0 ? bytes / seconds / (1024 * 1024) : 0.0;
+        wprintf(L"  %-10s %10.2f ms %10.2f MB/s %12zu allocs %10.2f MB allocated\n",
+                name,
+                seconds * 1000,
+                megabytesPerSecond,
+                result.allocations,
+                result.allocatedBytes / (1024.0 * 1024.0));
+    }
+
+    void _Replay(const Options& options, const Recording& recording)
+    {
+        const auto chunks = _DecodeChunks(recording.bytes, options.chunkSize);
+
+        wprintf(L"%s: %.2f MB in %zu chunks of %zu bytes, best of %zu\n",
+                recording.name.c_str(),
+                recording.bytes.size() / (1024.0 * 1024.0),
+                chunks.size(),
+                options.chunkSize,
+                options.iterations);
+
+        const auto bytes = recording.bytes.size();
+        til::metrics::reset();
+        _PrintStage(L"decode", _MeasureDecode(options, recording.bytes), bytes);
+        _PrintStage(L"parse", _MeasureParse(options, chunks), bytes);
+        _PrintStage(L"terminal", _MeasureTerminal(options, chunks), bytes);
+        if (options.render)
+        {
+            _PrintStage(L"render", _MeasureRender(options, chunks), bytes);
+        }
+        if (options.passthrough)
+        {
+            _PrintStage(L"passthru", _MeasurePassthrough(options, chunks), bytes);
+        }
+        if (options.metrics)
+        {
+            // These are summed over all iterations of all stages.
+            wprintf(L"\n%hs", til::metrics::dump().c_str());
+        }
+        wprintf(L"\n");
+    }
+
+    Recording _Load(const std::filesystem::path& path)
+    {
+        std::ifstream file{ path, std::ios::binary };
+        THROW_HR_IF(HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND), !file);
+        return { path.filename().wstring(), std::string{ std::istreambuf_iterator<char>{ file }, std::istreambuf_iterator<char>{} } };
+    }
+
+    void _Save(const std::filesystem::path& path, const std::string_view bytes)
+    {
+        std::ofstream file{ path, std::ios::binary };
+        THROW_HR_IF(E_ACCESSDENIED, !file);
+        file.write(bytes.data(), bytes.size());
+    }
+
+    void _PrintUsage()
+    {
+        wprintf(L"usage: ReplayBench [options] [file|directory]...\n"
+                L"  Replays every given recording, or the built-in workloads if none are given.\n"
+                L"  -i, --iterations N   runs each stage N times and reports the fastest (default 5)\n"
+                L"  -c, --chunk N        hands the recording to the terminal N bytes at a time (default 4096)\n"
+                L"  -s, --size WxH       terminal size in cells (default 120x30)\n"
+                L"  --scrollback N       scrollback lines (default 9001)\n"
+                L"  --builtin-size N     approximate size of each built-in workload in bytes (default 8 MiB)\n"
+                L"  --render             also paints a frame per chunk through the VT render engine\n"
+                L"  --passthrough        also forwards each chunk as is through the VT render engine (conpty --passthrough)\n"
+                L"  --metrics            dumps the til::metrics counters and histograms after each recording\n"
+                L"  --save-builtin DIR   writes the built-in workloads to DIR as .vt files and exits\n");
+    }
+
+    size_t _ParseNumber(const std::wstring_view value)
+    {
+        size_t pos = 0;
+        const auto number = std::stoull(std::wstring{ value }, &pos);
+        THROW_HR_IF(E_INVALIDARG, pos != value.size());
+        return gsl::narrow<size_t>(number);
+    }
+
+    std::optional<Options> _ParseOptions(const int argc, const wchar_t* const argv[])
+    {
+        Options options;
+        const gsl::span<const wchar_t* const> args{ argv, gsl::narrow_cast<size_t>(argc) };
+        for (size_t i = 1; i < args.size(); ++i)
+        {
+            const std::wstring_view arg{ til::at(args, i) };
+            const auto next = [&]() {
+                THROW_HR_IF(E_INVALIDARG, i + 1 >= args.size());
+                return std::wstring_view{ til::at(args, ++i) };
+            };
+
+            if (arg == L"-i" || arg == L"--iterations")
+            {
+                options.iterations = std::max<size_t>(_ParseNumber(next()), 1);
+            }
+            else if (arg == L"-c" || arg == L"--chunk")
+            {
+                options.chunkSize = std::max<size_t>(_ParseNumber(next()), 1);
+            }
+            else if (arg == L"-s" || arg == L"--size")
+            {
+                const auto value = next();
+                const auto x = value.find(L'x');
+                THROW_HR_IF(E_INVALIDARG, x == std::wstring_view::npos);
+                options.viewport = til::size{ gsl::narrow<int>(_ParseNumber(value.substr(0, x))), gsl::narrow<int>(_ParseNumber(value.substr(x + 1))) };
+            }
+            else if (arg == L"--scrollback")
+            {
+                options.scrollback = gsl::narrow<SHORT>(_ParseNumber(next()));
+            }
+            else if (arg == L"--builtin-size")
+            {
+                options.builtinBytes = _ParseNumber(next());
+            }
+            else if (arg == L"--render")
+            {
+                options.render = true;
+            }
+            else if (arg == L"--passthrough")
+            {
+                options.passthrough = true;
+            }
+            else if (arg == L"--metrics")
+            {
+                options.metrics = true;
+            }
+            else if (arg == L"--save-builtin")
+            {
+                options.saveBuiltinTo = next();
+            }
+            else if (arg == L"-?" || arg == L"-h" || arg == L"--help" || til::starts_with(arg, L"-"))
+            {
+                return std::nullopt;
+            }
+            else
+            {
+                options.inputs.emplace_back(arg);
+            }
+        }
+        return options;
+    }
+}
+
+int __cdecl wmain(int argc, wchar_t* argv[])
+try
+{
+    const auto options = _ParseOptions(argc, argv);
+    if (!options)
+    {
+        _PrintUsage();
+        return 1;
+    }
+
+    if (!options->saveBuiltinTo.empty())
+    {
+        std::filesystem::create_directories(options->saveBuiltinTo);
+        for (const auto& recording : Workloads::Builtin(options->builtinBytes, options->viewport))
+        {
+            _Save(options->saveBuiltinTo / (recording.name + L".vt"), recording.bytes);
+        }
+        return 0;
+    }
+
+    if (options->inputs.empty())
+    {
+        for (const auto& recording : Workloads::Builtin(options->builtinBytes, options->viewport))
+        {
+            _Replay(*options, recording);
+        }
+        return 0;
+    }
+
+    for (const auto& input : options->inputs)
+    {
+        if (std::filesystem::is_directory(input))
+        {
+            for (const auto& entry : std::filesystem::directory_iterator{ input })
+            {
+                if (entry.is_regular_file())
+                {
+                    _Replay(*options, _Load(entry.path()));
+                }
+            }
+        }
+        else
+        {
+            _Replay(*options, _Load(input));
+        }
+    }
+    return 0;
+}
+catch (...)
+{
+    LOG_CAUGHT_EXCEPTION();
+    wprintf(L"ReplayBench failed: 0x%08x\n", static_cast<unsigned int>(wil::ResultFromCaughtException()));
+    return 1;
+}
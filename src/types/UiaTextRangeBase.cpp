@@ -494,43 +494,7 @@ try
     //       We'll do some post-processing to fix this on the way out.
     std::optional<COORD> resultFirstAnchor;
     std::optional<COORD> resultSecondAnchor;
-    const auto attemptUpdateAnchors = [=, &resultFirstAnchor, &resultSecondAnchor](const TextBufferCellIterator iter) {
-        const auto attrFound{ _verifyAttr(attributeId, val, iter->TextAttr()).value() };
-        if (attrFound)
-        {
-            // populate the first anchor if it's not populated.
-            // otherwise, populate the second anchor.
-            if (!resultFirstAnchor.has_value())
-            {
-                resultFirstAnchor = iter.Pos();
-                resultSecondAnchor = iter.Pos();
-            }
-            else
-            {
-                resultSecondAnchor = iter.Pos();
-            }
-        }
-        return attrFound;
-    };
-
-    // Start/End for the direction to perform the search in
-    // We need searchEnd to be exclusive. This allows the for-loop below to
-    // iterate up until the exclusive searchEnd, and not attempt to read the
-    // data at that position.
-    const auto searchStart{ searchBackwards ? inclusiveEnd : _start };
-    const auto searchEndInclusive{ searchBackwards ? _start : inclusiveEnd };
-    auto searchEndExclusive{ searchEndInclusive };
-    if (searchBackwards)
-    {
-        bufferSize.DecrementInBounds(searchEndExclusive, true);
-    }
-    else
-    {
-        bufferSize.IncrementInBounds(searchEndExclusive, true);
-    }
 
-    // Iterate from searchStart to searchEnd in the buffer.
-    // If we find the attribute we're looking for, we update resultFirstAnchor/SecondAnchor appropriately.
     Viewport viewportRange{ bufferSize };
     if (_blockRange)
     {
@@ -540,28 +504,28 @@ try
         const auto height{ gsl::narrow_cast<short>(std::abs(inclusiveEnd.Y - _start.Y + 1)) };
         viewportRange = Viewport::FromDimensions({ originX, originY }, width, height);
     }
-    auto iter{ buffer.GetCellDataAt(searchStart, viewportRange) };
-    const auto iterStep{ searchBackwards ? -1 : 1 };
-    for (; iter && iter.Pos() != searchEndExclusive; iter += iterStep)
-    {
-        if (!attemptUpdateAnchors(iter) && resultFirstAnchor.has_value() && resultSecondAnchor.has_value())
+
+    // Iterate over the runs of attributes in the range, in the direction of the search.
+    // If we find the attribute we're looking for, we update resultFirstAnchor/SecondAnchor appropriately.
+    _forEachAttributeRun(inclusiveEnd, viewportRange, searchBackwards, [&](const SHORT row, const SHORT left, const SHORT right, const TextAttribute& attr) {
+        if (!_verifyAttr(attributeId, val, attr).value())
         {
-            // Exit the loop early if...
-            // - the cell we're looking at doesn't have the attr we're looking for
-            // - the anchors have been populated
-            // This means that we've found a contiguous range where the text attribute was found.
+            // Stop if the anchors have been populated, because then we've found a
+            // contiguous range where the text attribute was found.
             // No point in searching through the rest of the search space.
             // TLDR: keep updating the second anchor and make the range wider until the attribute changes.
-            break;
+            return !resultFirstAnchor.has_value();
         }
-    }
 
-    // Corner case: we couldn't actually move the searchEnd to make it exclusive
-    // (i.e. DecrementInBounds on Origin doesn't move it)
-    if (searchEndInclusive == searchEndExclusive)
-    {
-        attemptUpdateAnchors(iter);
-    }
+        const COORD runFirst{ searchBackwards ? gsl::narrow_cast<SHORT>(right - 1) : left, row };
+        const COORD runLast{ searchBackwards ? left : gsl::narrow_cast<SHORT>(right - 1), row };
+        if (!resultFirstAnchor.has_value())
+        {
+            resultFirstAnchor = runFirst;
+        }
+        resultSecondAnchor = runLast;
+        return true;
+    });
 
     // If a result was found, populate ppRetVal with the UiaTextRange
     // representing the found selection anchors.
@@ -786,18 +750,17 @@ try
         const auto height{ gsl::narrow_cast<short>(std::abs(inclusiveEnd.Y - _start.Y + 1)) };
         viewportRange = Viewport::FromDimensions({ originX, originY }, width, height);
     }
-    auto iter{ buffer.GetCellDataAt(_start, viewportRange) };
-    for (; iter && iter.Pos() != inclusiveEnd; ++iter)
+    const auto uniform = _forEachAttributeRun(inclusiveEnd, viewportRange, false, [&](const SHORT /*row*/, const SHORT /*left*/, const SHORT /*right*/, const TextAttribute& attr) {
+        return _verifyAttr(attributeId, *pRetVal, attr).value();
+    });
+    if (!uniform)
     {
-        if (!_verifyAttr(attributeId, *pRetVal, iter->TextAttr()).value())
-        {
-            // The value of the specified attribute varies over the text range
-            // return UiaGetReservedMixedAttributeValue.
-            // Source: https://docs.microsoft.com/en-us/windows/win32/api/uiautomationcore/nf-uiautomationcore-itextrangeprovider-getattributevalue
-            pRetVal->vt = VT_UNKNOWN;
-            UiaTracing::TextRange::GetAttributeValue(*this, attributeId, *pRetVal, UiaTracing::AttributeType::Mixed);
-            return UiaGetReservedMixedAttributeValue(&pRetVal->punkVal);
-        }
+        // The value of the specified attribute varies over the text range
+        // return UiaGetReservedMixedAttributeValue.
+        // Source: https://docs.microsoft.com/en-us/windows/win32/api/uiautomationcore/nf-uiautomationcore-itextrangeprovider-getattributevalue
+        pRetVal->vt = VT_UNKNOWN;
+        UiaTracing::TextRange::GetAttributeValue(*this, attributeId, *pRetVal, UiaTracing::AttributeType::Mixed);
+        return UiaGetReservedMixedAttributeValue(&pRetVal->punkVal);
     }
 
     UiaTracing::TextRange::GetAttributeValue(*this, attributeId, *pRetVal);
@@ -1665,3 +1628,64 @@ COORD UiaTextRangeBase::_getInclusiveEnd() noexcept
     _pData->GetTextBuffer().GetSize().DecrementInBounds(result, true);
     return result;
 }
+
+// Method Description:
+// - Calls the given function for every run of cells with the same attributes in this range.
+//   A run never spans multiple rows, but a row can contain multiple runs.
+// - This makes looking at the attributes of a range proportional to the number of runs
+//   of attributes in it, instead of the number of cells.
+// Arguments:
+// - inclusiveEnd - the inclusive end of this range
+// - viewportRange - for block ranges, the rectangle the range spans
+// - backwards - if true, the runs are visited from the end of the range to its start
+// - func - func(row, left, right, attr) is called for each run, with right being exclusive.
+//   Iteration stops if it returns false.
+// Return Value:
+// - false if func stopped the iteration, true otherwise.
+bool UiaTextRangeBase::_forEachAttributeRun(const COORD inclusiveEnd,
+                                            const Viewport& viewportRange,
+                                            const bool backwards,
+                                            const std::function<bool(const SHORT row, const SHORT left, const SHORT right, const TextAttribute& attr)>& func) const
+{
+    const auto& buffer{ _pData->GetTextBuffer() };
+    const auto bufferSize{ buffer.GetSize() };
+
+    // There's nothing to look at if the end precedes the start (i.e. a degenerate range).
+    if (bufferSize.CompareInBounds(_start, inclusiveEnd, true) > 0)
+    {
+        return true;
+    }
+
+    const auto firstRow{ std::max<SHORT>(_start.Y, 0) };
+    const auto lastRow{ std::min<SHORT>(inclusiveEnd.Y, bufferSize.BottomInclusive()) };
+    for (auto i = 0; i <= lastRow - firstRow; ++i)
+    {
+        const auto row{ gsl::narrow_cast<SHORT>(backwards ? lastRow - i : firstRow + i) };
+
+        // Block ranges span the same columns on every row. Other ranges span entire
+        // rows, except on the first and last row.
+        auto left{ viewportRange.Left() };
+        auto right{ viewportRange.RightExclusive() };
+        if (!_blockRange)
+        {
+            left = row == _start.Y ? _start.X : bufferSize.Left();
+            right = row == inclusiveEnd.Y ? gsl::narrow_cast<SHORT>(inclusiveEnd.X + 1) : bufferSize.RightExclusive();
+        }
+        left = std::max(left, bufferSize.Left());
+        right = std::min(right, bufferSize.RightExclusive());
+        if (left >= right)
+        {
+            continue;
+        }
+
+        const auto& attrRow{ buffer.GetRowByOffset(row).GetAttrRow() };
+        const auto visitRun = [&](const uint16_t runLeft, const uint16_t runRight, const TextAttribute& attr) {
+            return func(row, gsl::narrow_cast<SHORT>(runLeft), gsl::narrow_cast<SHORT>(runRight), attr);
+        };
+        if (!attrRow.ForEachRun(gsl::narrow_cast<uint16_t>(left), gsl::narrow_cast<uint16_t>(right), backwards, visitRun))
+        {
+            return false;
+        }
+    }
+    return true;
+}
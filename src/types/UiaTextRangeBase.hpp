@@ -182,6 +182,11 @@ namespace Microsoft::Console::Types
 
         COORD _getInclusiveEnd() noexcept;
 
+        bool _forEachAttributeRun(const COORD inclusiveEnd,
+                                  const Viewport& viewportRange,
+                                  const bool backwards,
+                                  const std::function<bool(const SHORT row, const SHORT left, const SHORT right, const TextAttribute& attr)>& func) const;
+
 #ifdef UNIT_TESTING
         friend class ::UiaTextRangeTests;
 #endif
@@ -0,0 +1,87 @@
+# This script is used for taking a json file and stamping it into a header as a
+# constexpr array of JsonSnapshot::Node (see JsonSnapshot.h in the settings model).
+# That way the document can be turned into a Json::Value at runtime without
+# having to parse it.
+
+param (
+    [parameter(Mandatory = $true)]
+    [string]$JsonFile,
+
+    [parameter(Mandatory = $true)]
+    [string]$OutPath,
+
+    [parameter(Mandatory = $true)]
+    [string]$VariableName
+)
+
+$ErrorActionPreference = "Stop"
+$invariant = [System.Globalization.CultureInfo]::InvariantCulture
+$nodes = [System.Collections.Generic.List[string]]::new()
+
+# Returns a C++ string literal of the UTF-8 encoding of the given string.
+# Anything but printable ASCII is written as an octal escape, which (unlike
+# a hex escape) can't swallow the characters following it.
+function ConvertTo-CppString([string]$value) {
+    $builder = [System.Text.StringBuilder]::new()
+    [void]$builder.Append('"')
+    foreach ($b in [System.Text.Encoding]::UTF8.GetBytes($value)) {
+        if ($b -ge 0x20 -and $b -lt 0x7f -and $b -ne 0x22 -and $b -ne 0x5c) {
+            [void]$builder.Append([char]$b)
+        } else {
+            [void]$builder.Append('\').Append([Convert]::ToString($b, 8).PadLeft(3, '0'))
+        }
+    }
+    [void]$builder.Append('"')
+    return $builder.ToString()
+}
+
+function Add-Node([string]$kind, [string]$key, [string]$string = "", [string]$number = "0") {
+    $nodes.Add("    { JsonSnapshot::Kind::$kind, $(ConvertTo-CppString $key), $(ConvertTo-CppString $string), $number },")
+}
+
+# Arrays need to be checked before objects, because their elements are objects too.
+function Add-Value([string]$key, $value) {
+    if ($null -eq $value) {
+        Add-Node "Null" $key
+    } elseif ($value -is [bool]) {
+        Add-Node "Bool" $key -number $(if ($value) { "1" } else { "0" })
+    } elseif ($value -is [string]) {
+        Add-Node "String" $key -string $value
+    } elseif ($value -is [int] -or $value -is [long]) {
+        Add-Node "Int" $key -number $value.ToString($invariant)
+    } elseif ($value -is [decimal] -or $value -is [double]) {
+        Add-Node "Real" $key -number ([double]$value).ToString("R", $invariant)
+    } elseif ($value -is [array]) {
+        Add-Node "BeginArray" $key
+        foreach ($element in $value) {
+            Add-Value "" $element
+        }
+        Add-Node "End" ""
+    } elseif ($value -is [System.Management.Automation.PSCustomObject]) {
+        Add-Node "BeginObject" $key
+        foreach ($property in $value.PSObject.Properties) {
+            Add-Value $property.Name $property.Value
+        }
+        Add-Node "End" ""
+    } else {
+        throw "Unsupported value of type $($value.GetType()) in $JsonFile"
+    }
+}
+
+$fullPath = Resolve-Path $JsonFile
+
+# Windows PowerShell's JSON parser rejects comments. Ours always span whole
+# lines, and lines starting with // can't be in the middle of a string.
+$jsonText = (Get-Content $JsonFile -Encoding UTF8 | Where-Object { $_ -notmatch '^\s*//' }) -join "`n"
+Add-Value "" ($jsonText | ConvertFrom-Json)
+
+$lines = @(
+    "// Copyright (c) Microsoft Corporation",
+    "// Licensed under the MIT license.",
+    "",
+    "// THIS IS AN AUTO-GENERATED FILE",
+    "// Generated from $($fullPath.Path)",
+    "constexpr JsonSnapshot::Node $($VariableName)[]{"
+) + $nodes.ToArray() + @("};")
+
+$lines | Out-File -FilePath $OutPath -Encoding utf8